@@ -44,8 +44,10 @@ static const char *e1000_reg_to_string(enum e1000_reg_t r)
 	switch (r) {
 	_(CTRL);
 	_(ICR);
+	_(ITR);
 	_(ICS);
 	_(IMS);
+	_(IMC);
 	_(RCTL);
 	_(TCTL);
 	_(RDBAL);
@@ -138,87 +140,169 @@ static int e1000_send(const struct device *ddev, struct net_pkt *pkt)
 	return e1000_tx(dev, dev->txb, len);
 }
 
-static struct net_pkt *e1000_rx(struct e1000_dev *dev)
+BUILD_ASSERT(CONFIG_ETH_E1000_RX_DESC_COUNT % 8 == 0,
+	     "RX ring length must be a multiple of 128 bytes");
+
+/* Take the next received frame from the RX ring. Returns false if there is
+ * none, *pkt is NULL if the frame could not be received.
+ */
+static bool e1000_rx(struct e1000_dev *dev, struct net_pkt **pkt)
 {
-	struct net_pkt *pkt = NULL;
+	unsigned int i = dev->rx_next;
+	volatile struct e1000_rx *desc = &dev->rx[i];
 	void *buf;
 	ssize_t len;
 
-	LOG_DBG("rx.sta: 0x%02hx", dev->rx.sta);
+	LOG_DBG("rx[%u].sta: 0x%02hx", i, desc->sta);
 
-	if (!(dev->rx.sta & RDESC_STA_DD)) {
-		LOG_ERR("RX descriptor not ready");
-		goto out;
+	if (!(desc->sta & RDESC_STA_DD)) {
+		return false;
 	}
 
-	buf = INT_TO_POINTER((uint32_t)dev->rx.addr);
-	len = dev->rx.len - 4;
+	*pkt = NULL;
+
+	buf = dev->rxb[i];
+	len = desc->len - 4;
 
 	if (len <= 0) {
-		LOG_ERR("Invalid RX descriptor length: %hu", dev->rx.len);
+		LOG_ERR("Invalid RX descriptor length: %hu", desc->len);
 		goto out;
 	}
 
 	hexdump(buf, len, "%zd byte(s)", len);
 
-	pkt = net_pkt_rx_alloc_with_buffer(dev->iface, len, AF_UNSPEC, 0,
-					   K_NO_WAIT);
-	if (!pkt) {
+	*pkt = net_pkt_rx_alloc_with_buffer(dev->iface, len, AF_UNSPEC, 0,
+					    K_NO_WAIT);
+	if (!*pkt) {
 		LOG_ERR("Out of buffers");
 		goto out;
 	}
 
-	if (net_pkt_write(pkt, buf, len)) {
+	if (net_pkt_write(*pkt, buf, len)) {
 		LOG_ERR("Out of memory for received frame");
-		net_pkt_unref(pkt);
-		pkt = NULL;
+		net_pkt_unref(*pkt);
+		*pkt = NULL;
 	}
 
 out:
-	return pkt;
+	/* Give the descriptor back to the hardware */
+	desc->sta = 0;
+	iow32(dev, RDT, i);
+	dev->rx_next = (i + 1) % CONFIG_ETH_E1000_RX_DESC_COUNT;
+
+	return true;
 }
 
-static void e1000_isr(const struct device *ddev)
+static struct net_if *e1000_rx_iface(struct e1000_dev *dev,
+				     struct net_pkt *pkt)
 {
-	struct e1000_dev *dev = ddev->data;
-	uint32_t icr = ior32(dev, ICR); /* Cleared upon read */
 	uint16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
 
-	icr &= ~(ICR_TXDW | ICR_TXQE);
-
-	if (icr & ICR_RXO) {
-		struct net_pkt *pkt = e1000_rx(dev);
-
-		icr &= ~ICR_RXO;
-
-		if (pkt) {
 #if defined(CONFIG_NET_VLAN)
-			struct net_eth_hdr *hdr = NET_ETH_HDR(pkt);
+	struct net_eth_hdr *hdr = NET_ETH_HDR(pkt);
 
-			if (ntohs(hdr->type) == NET_ETH_PTYPE_VLAN) {
-				struct net_eth_vlan_hdr *hdr_vlan =
-					(struct net_eth_vlan_hdr *)
-					NET_ETH_HDR(pkt);
+	if (ntohs(hdr->type) == NET_ETH_PTYPE_VLAN) {
+		struct net_eth_vlan_hdr *hdr_vlan =
+			(struct net_eth_vlan_hdr *)NET_ETH_HDR(pkt);
 
-				net_pkt_set_vlan_tci(
-					pkt, ntohs(hdr_vlan->vlan.tci));
-				vlan_tag = net_pkt_vlan_tag(pkt);
+		net_pkt_set_vlan_tci(pkt, ntohs(hdr_vlan->vlan.tci));
+		vlan_tag = net_pkt_vlan_tag(pkt);
 
 #if CONFIG_NET_TC_RX_COUNT > 1
-				enum net_priority prio;
+		enum net_priority prio;
 
-				prio = net_vlan2priority(
-						net_pkt_vlan_priority(pkt));
-				net_pkt_set_priority(pkt, prio);
+		prio = net_vlan2priority(net_pkt_vlan_priority(pkt));
+		net_pkt_set_priority(pkt, prio);
 #endif
-			}
+	}
+#else
+	ARG_UNUSED(pkt);
 #endif /* CONFIG_NET_VLAN */
 
-			net_recv_data(get_iface(dev, vlan_tag), pkt);
-		} else {
-			eth_stats_update_errors_rx(get_iface(dev, vlan_tag));
+	return get_iface(dev, vlan_tag);
+}
+
+#if defined(CONFIG_NET_RX_BATCH)
+static int e1000_rx_poll(struct net_rx_poll *poll, int budget)
+{
+	struct e1000_dev *dev = CONTAINER_OF(poll, struct e1000_dev, rx_poll);
+	struct net_pkt *pkts[CONFIG_NET_RX_BATCH_BUDGET];
+	struct net_if *batch_iface = NULL;
+	struct net_if *iface;
+	struct net_pkt *pkt;
+	int count = 0;
+	int done = 0;
+
+	budget = MIN(budget, ARRAY_SIZE(pkts));
+
+	while (done < budget && e1000_rx(dev, &pkt)) {
+		done++;
+
+		if (!pkt) {
+			eth_stats_update_errors_rx(dev->iface);
+			continue;
+		}
+
+		/* Frames of different VLANs go up separately */
+		iface = e1000_rx_iface(dev, pkt);
+		if (count && iface != batch_iface) {
+			net_recv_data_batch(batch_iface, pkts, count);
+			count = 0;
+		}
+
+		batch_iface = iface;
+		pkts[count++] = pkt;
+	}
+
+	if (count) {
+		net_recv_data_batch(batch_iface, pkts, count);
+	}
+
+	if (done < budget) {
+		/* The ring is empty, a frame received meanwhile raises the
+		 * interrupt as soon as it is unmasked.
+		 */
+		iow32(dev, IMS, IMS_RXO | IMS_RXT0);
+	}
+
+	return done;
+}
+#else
+static void e1000_rx_all(struct e1000_dev *dev)
+{
+	struct net_pkt *pkt;
+
+	while (e1000_rx(dev, &pkt)) {
+		if (!pkt) {
+			eth_stats_update_errors_rx(dev->iface);
+			continue;
+		}
+
+		if (net_recv_data(e1000_rx_iface(dev, pkt), pkt) < 0) {
+			net_pkt_unref(pkt);
 		}
 	}
+}
+#endif /* CONFIG_NET_RX_BATCH */
+
+static void e1000_isr(const struct device *ddev)
+{
+	struct e1000_dev *dev = ddev->data;
+	uint32_t icr = ior32(dev, ICR); /* Cleared upon read */
+
+	icr &= ~(ICR_TXDW | ICR_TXQE);
+
+	if (icr & (ICR_RXO | ICR_RXT0)) {
+		icr &= ~(ICR_RXO | ICR_RXT0);
+
+#if defined(CONFIG_NET_RX_BATCH)
+		/* Poll the ring with RX interrupts masked */
+		iow32(dev, IMC, IMS_RXO | IMS_RXT0);
+		net_rx_poll_schedule(&dev->rx_poll);
+#else
+		e1000_rx_all(dev);
+#endif
+	}
 
 	if (icr) {
 		LOG_ERR("Unhandled interrupt, ICR: 0x%x", icr);
@@ -234,6 +318,7 @@ int e1000_probe(const struct device *ddev)
 	struct e1000_dev *dev = ddev->data;
 	uint32_t ral, rah;
 	struct pcie_mbar mbar;
+	int i;
 
 	if (!pcie_probe(bdf, PCIE_ID(PCI_VENDOR_ID_INTEL,
 				     PCI_DEVICE_ID_I82540EM))) {
@@ -258,19 +343,26 @@ int e1000_probe(const struct device *ddev)
 
 	iow32(dev, TCTL, TCTL_EN);
 
-	/* Setup RX descriptor */
+	/* Setup RX descriptor ring, one descriptor is always left unused so
+	 * that a full ring can be told apart from an empty one.
+	 */
 
-	dev->rx.addr = POINTER_TO_INT(dev->rxb);
-	dev->rx.len = sizeof(dev->rxb);
+	for (i = 0; i < CONFIG_ETH_E1000_RX_DESC_COUNT; i++) {
+		dev->rx[i].addr = POINTER_TO_INT(dev->rxb[i]);
+		dev->rx[i].sta = 0;
+	}
 
-	iow32(dev, RDBAL, (uint32_t) &dev->rx);
+	dev->rx_next = 0;
+
+	iow32(dev, RDBAL, (uint32_t) dev->rx);
 	iow32(dev, RDBAH, 0);
-	iow32(dev, RDLEN, 1*16);
+	iow32(dev, RDLEN, sizeof(dev->rx));
 
 	iow32(dev, RDH, 0);
-	iow32(dev, RDT, 1);
+	iow32(dev, RDT, CONFIG_ETH_E1000_RX_DESC_COUNT - 1);
 
-	iow32(dev, IMS, IMS_RXO);
+	iow32(dev, ITR, CONFIG_ETH_E1000_INTR_THROTTLE);
+	iow32(dev, IMS, IMS_RXO | IMS_RXT0);
 
 	ral = ior32(dev, RAL);
 	rah = ior32(dev, RAH);
@@ -292,6 +384,10 @@ static void e1000_iface_init(struct net_if *iface)
 	if (dev->iface == NULL) {
 		dev->iface = iface;
 
+#if defined(CONFIG_NET_RX_BATCH)
+		net_rx_poll_init(&dev->rx_poll, e1000_rx_poll);
+#endif
+
 		/* Do the phy link up only once */
 		IRQ_CONNECT(DT_INST_IRQN(0),
 			DT_INST_IRQ(0, priority),
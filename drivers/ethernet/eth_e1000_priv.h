@@ -19,8 +19,10 @@ extern "C" {
 #define ICR_TXDW	     (1) /* Transmit Descriptor Written Back */
 #define ICR_TXQE	(1 << 1) /* Transmit Queue Empty */
 #define ICR_RXO		(1 << 6) /* Receiver Overrun */
+#define ICR_RXT0	(1 << 7) /* Receiver Timer Interrupt */
 
 #define IMS_RXO		(1 << 6) /* Receiver FIFO Overrun */
+#define IMS_RXT0	(1 << 7) /* Receiver Timer Interrupt */
 
 #define RCTL_MPE	(1 << 4) /* Multicast Promiscuous Enabled */
 
@@ -32,11 +34,16 @@ extern "C" {
 
 #define ETH_ALEN 6	/* TODO: Add a global reusable definition in OS */
 
+/* Receive buffer size selected by RCTL.BSIZE = 0 */
+#define E1000_RX_BUF_SIZE 2048
+
 enum e1000_reg_t {
 	CTRL	= 0x0000,	/* Device Control */
 	ICR	= 0x00C0,	/* Interrupt Cause Read */
+	ITR	= 0x00C4,	/* Interrupt Throttling Rate */
 	ICS	= 0x00C8,	/* Interrupt Cause Set */
 	IMS	= 0x00D0,	/* Interrupt Mask Set */
+	IMC	= 0x00D8,	/* Interrupt Mask Clear */
 	RCTL	= 0x0100,	/* Receive Control */
 	TCTL	= 0x0400,	/* Transmit Control */
 	RDBAL	= 0x2800,	/* Rx Descriptor Base Address Low */
@@ -76,7 +83,9 @@ struct e1000_rx {
 
 struct e1000_dev {
 	volatile struct e1000_tx tx __aligned(16);
-	volatile struct e1000_rx rx __aligned(16);
+	volatile struct e1000_rx rx[CONFIG_ETH_E1000_RX_DESC_COUNT] __aligned(16);
+	/* Next RX descriptor to be filled by the hardware */
+	unsigned int rx_next;
 	mm_reg_t address;
 	/* If VLAN is enabled, there can be multiple VLAN interfaces related to
 	 * this physical device. In that case, this iface pointer value is not
@@ -85,7 +94,10 @@ struct e1000_dev {
 	struct net_if *iface;
 	uint8_t mac[ETH_ALEN];
 	uint8_t txb[NET_ETH_MTU];
-	uint8_t rxb[NET_ETH_MTU];
+	uint8_t rxb[CONFIG_ETH_E1000_RX_DESC_COUNT][E1000_RX_BUF_SIZE];
+#if defined(CONFIG_NET_RX_BATCH)
+	struct net_rx_poll rx_poll;
+#endif
 #if defined(CONFIG_ETH_E1000_PTP_CLOCK)
 	const struct device *ptp_clock;
 	float clk_ratio;
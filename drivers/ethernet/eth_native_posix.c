@@ -319,17 +319,17 @@ static struct net_pkt *prepare_non_vlan_pkt(struct eth_context *ctx,
 	return pkt;
 }
 
-static int read_data(struct eth_context *ctx, int fd)
+static struct net_pkt *read_pkt(struct eth_context *ctx, int fd,
+				struct net_if **iface, int *status)
 {
 	uint16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
-	struct net_if *iface;
 	struct net_pkt *pkt = NULL;
-	int status;
 	int count;
 
 	count = eth_read_data(fd, ctx->recv, sizeof(ctx->recv));
 	if (count <= 0) {
-		return 0;
+		*status = 0;
+		return NULL;
 	}
 
 #if defined(CONFIG_NET_VLAN)
@@ -337,14 +337,14 @@ static int read_data(struct eth_context *ctx, int fd)
 		struct net_eth_hdr *hdr = (struct net_eth_hdr *)(ctx->recv);
 
 		if (ntohs(hdr->type) == NET_ETH_PTYPE_VLAN) {
-			pkt = prepare_vlan_pkt(ctx, count, &vlan_tag, &status);
+			pkt = prepare_vlan_pkt(ctx, count, &vlan_tag, status);
 			if (!pkt) {
-				return status;
+				return NULL;
 			}
 		} else {
-			pkt = prepare_non_vlan_pkt(ctx, count, &status);
+			pkt = prepare_non_vlan_pkt(ctx, count, status);
 			if (!pkt) {
-				return status;
+				return NULL;
 			}
 
 			net_pkt_set_vlan_tci(pkt, 0);
@@ -352,16 +352,66 @@ static int read_data(struct eth_context *ctx, int fd)
 	}
 #else
 	{
-		pkt = prepare_non_vlan_pkt(ctx, count, &status);
+		pkt = prepare_non_vlan_pkt(ctx, count, status);
 		if (!pkt) {
-			return status;
+			return NULL;
 		}
 	}
 #endif
 
-	iface = get_iface(ctx, vlan_tag);
+	*iface = get_iface(ctx, vlan_tag);
+
+	update_gptp(*iface, pkt, false);
+
+	return pkt;
+}
 
-	update_gptp(iface, pkt, false);
+#if defined(CONFIG_NET_RX_BATCH)
+/* Read all the pending frames, at most a budget full at a time, and pass
+ * them up together.
+ */
+static int read_data(struct eth_context *ctx, int fd)
+{
+	struct net_pkt *pkts[CONFIG_NET_RX_BATCH_BUDGET];
+	struct net_if *batch_iface = NULL;
+	struct net_if *iface;
+	struct net_pkt *pkt;
+	int status = 0;
+	int count = 0;
+
+	do {
+		pkt = read_pkt(ctx, fd, &iface, &status);
+		if (!pkt) {
+			break;
+		}
+
+		/* Frames of different VLANs go up separately */
+		if (count && iface != batch_iface) {
+			net_recv_data_batch(batch_iface, pkts, count);
+			count = 0;
+		}
+
+		batch_iface = iface;
+		pkts[count++] = pkt;
+	} while (count < ARRAY_SIZE(pkts) && !eth_wait_data(fd));
+
+	if (count) {
+		net_recv_data_batch(batch_iface, pkts, count);
+	}
+
+	return status;
+}
+#else
+static int read_data(struct eth_context *ctx, int fd)
+{
+	struct net_if *iface;
+	struct net_pkt *pkt;
+	int status;
+
+	pkt = read_pkt(ctx, fd, &iface, &status);
+	if (!pkt) {
+		return status;
+	}
 
 	if (net_recv_data(iface, pkt) < 0) {
 		net_pkt_unref(pkt);
@@ -369,6 +419,7 @@ static int read_data(struct eth_context *ctx, int fd)
 
 	return 0;
 }
+#endif /* CONFIG_NET_RX_BATCH */
 
 static void eth_rx(struct eth_context *ctx)
 {
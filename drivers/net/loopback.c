@@ -36,6 +36,11 @@ static void loopback_init(struct net_if *iface)
 	/* RFC 7042, s.2.1.1. address to use in documentation */
 	net_if_set_link_addr(iface, "\x00\x00\x5e\x00\x53\xff", 6,
 			     NET_LINK_DUMMY);
+
+	/* There is no MTU to respect when looping packets back */
+	if (IS_ENABLED(CONFIG_NET_TCP_GSO)) {
+		net_if_flag_set(iface, NET_IF_GSO);
+	}
 }
 
 static int loopback_send(const struct device *dev, struct net_pkt *pkt)
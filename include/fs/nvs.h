@@ -43,6 +43,12 @@ extern "C" {
  * @param write_block_size Alignment size
  * @param nvs_lock Mutex
  * @param flash_device Flash Device
+ * @param lookup_cache Address of the most recent allocation table entry for
+ * every slot of the ID hash, if CONFIG_NVS_LOOKUP_CACHE is enabled
+ * @param gc_work Background garbage collection, if CONFIG_NVS_BACKGROUND_GC
+ * is enabled
+ * @param gc_sector Active sector when the background garbage collection was
+ * requested
  */
 struct nvs_fs {
 	off_t offset;		/* filesystem offset in flash */
@@ -57,6 +63,14 @@ struct nvs_fs {
 	struct k_mutex nvs_lock;
 	const struct device *flash_device;
 	const struct flash_parameters *flash_parameters;
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+	/* address of the most recent ate for every id hash */
+	uint32_t lookup_cache[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+#endif
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	struct k_work gc_work;	/* closes the active sector early */
+	uint16_t gc_sector;	/* active sector when gc_work was submitted */
+#endif
 };
 
 /**
@@ -73,7 +87,9 @@ struct nvs_fs {
 /**
  * @brief nvs_init
  *
- * Initializes a NVS file system in flash.
+ * Initializes a NVS file system in flash. The file system structure must be
+ * zeroed before it is first initialized, as it is when statically allocated,
+ * and may be initialized again later.
  *
  * @param fs Pointer to file system
  * @param dev_name Pointer to flash device name
@@ -537,6 +537,14 @@ __syscall void k_thread_start(k_tid_t thread);
 extern k_ticks_t z_timeout_expires(const struct _timeout *timeout);
 extern k_ticks_t z_timeout_remaining(const struct _timeout *timeout);
 
+#ifdef CONFIG_TIMEOUT_SLACK
+static inline void z_timeout_slack_set(struct _timeout *to, k_timeout_t slack)
+{
+	to->slack = (slack.ticks == K_TICKS_FOREVER) ? UINT32_MAX
+		: (uint32_t)CLAMP(slack.ticks, 0, UINT32_MAX);
+}
+#endif
+
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 
 /**
@@ -1472,6 +1480,30 @@ static inline uint32_t k_timer_remaining_get(struct k_timer *timer)
 
 #endif /* CONFIG_SYS_CLOCK_EXISTS */
 
+#ifdef CONFIG_TIMEOUT_SLACK
+/**
+ * @brief Allow a timer's expiry to be deferred to coalesce interrupts.
+ *
+ * This routine lets the kernel run the timer's expiry up to @a slack
+ * later than requested, so that expirations of several timers close to
+ * each other can be handled by a single timer interrupt.  It applies to
+ * subsequent starts and periods of the timer and does not change its
+ * nominal expiry times, so periodic timers do not drift.
+ *
+ * @param timer     Address of timer.
+ * @param slack     Maximum deferral, K_NO_WAIT to disable.
+ *
+ * @return N/A
+ */
+__syscall void k_timer_slack_set(struct k_timer *timer, k_timeout_t slack);
+
+static inline void z_impl_k_timer_slack_set(struct k_timer *timer,
+					    k_timeout_t slack)
+{
+	z_timeout_slack_set(&timer->timeout, slack);
+}
+#endif /* CONFIG_TIMEOUT_SLACK */
+
 /**
  * @brief Associate user-specific data with a timer.
  *
@@ -3216,6 +3248,22 @@ int k_work_schedule_for_queue(struct k_work_q *queue,
 			       struct k_work_delayable *dwork,
 			       k_timeout_t delay);
 
+#ifdef CONFIG_TIMEOUT_SLACK
+/** @brief Allow the submission of a delayable work item to be deferred.
+ *
+ * Lets the kernel submit the work item up to @p slack later than the
+ * delay passed to k_work_schedule() and related functions, so that it
+ * can share a timer interrupt with other timeouts expiring around the
+ * same time.  Applies to subsequent scheduling of the item.
+ *
+ * @param dwork pointer to the delayable work item.
+ *
+ * @param slack maximum deferral, @c K_NO_WAIT to disable.
+ */
+static inline void k_work_delayable_slack_set(struct k_work_delayable *dwork,
+					      k_timeout_t slack);
+#endif /* CONFIG_TIMEOUT_SLACK */
+
 /** @brief Submit an idle work item to the system work queue after a
  * delay.
  *
@@ -3637,6 +3685,14 @@ static inline k_ticks_t k_work_delayable_remaining_get(
 	return z_timeout_remaining(&dwork->timeout);
 }
 
+#ifdef CONFIG_TIMEOUT_SLACK
+static inline void k_work_delayable_slack_set(struct k_work_delayable *dwork,
+					      k_timeout_t slack)
+{
+	z_timeout_slack_set(&dwork->timeout, slack);
+}
+#endif
+
 static inline k_tid_t k_work_queue_thread_get(struct k_work_q *queue)
 {
 	return &queue->thread;
@@ -4722,10 +4778,21 @@ struct k_mem_slab {
 	uint32_t num_blocks;
 	size_t block_size;
 	char *buffer;
+#ifdef CONFIG_MEM_SLAB_LOCKFREE
+	/* ABA tag in the upper bits, 1-based index of the first free
+	 * block in the lower 16 bits (0 when empty)
+	 */
+	atomic_t free_head;
+	atomic_t num_used;
+	/* Allocators that may pend, frees check it before skipping the lock */
+	atomic_t waiters;
+#else
 	char *free_list;
 	uint32_t num_used;
+#endif
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	uint32_t max_used;
+	uint32_t num_failed;
 #endif
 
 };
@@ -4738,8 +4805,6 @@ struct k_mem_slab {
 	.num_blocks = slab_num_blocks, \
 	.block_size = slab_block_size, \
 	.buffer = slab_buffer, \
-	.free_list = NULL, \
-	.num_used = 0, \
 	}
 
 
@@ -4853,7 +4918,11 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_LOCKFREE
+	return (uint32_t)atomic_get(&slab->num_used);
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -4888,7 +4957,28 @@ static inline uint32_t k_mem_slab_max_used_get(struct k_mem_slab *slab)
  */
 static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
+}
+
+/**
+ * @brief Get the number of failed allocations from a memory slab.
+ *
+ * This routine gets the number of k_mem_slab_alloc() calls on @a slab
+ * that returned without a block, whether immediately or after
+ * waiting.
+ *
+ * @param slab Address of the memory slab.
+ *
+ * @return Number of failed allocations.
+ */
+static inline uint32_t k_mem_slab_num_failed_get(struct k_mem_slab *slab)
+{
+#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+	return slab->num_failed;
+#else
+	ARG_UNUSED(slab);
+	return 0;
+#endif
 }
 
 /** @} */
@@ -4898,12 +4988,46 @@ static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
  * @{
  */
 
+#ifdef CONFIG_K_HEAP_CACHE
+/**
+ * @brief k_heap size-class cache statistics
+ *
+ * Counters are summed over the per-CPU magazines of one heap.
+ */
+struct k_heap_cache_stats {
+	/** Allocations served from a magazine */
+	uint32_t alloc_hits;
+	/** Cacheable allocations the magazines could not serve */
+	uint32_t alloc_misses;
+	/** Frees absorbed by a magazine */
+	uint32_t free_hits;
+	/** Batched refills taken from the underlying heap */
+	uint32_t refills;
+	/** Batched drains returned to the underlying heap */
+	uint32_t drains;
+	/** Bytes currently parked in magazines */
+	size_t cached_bytes;
+};
+
+/* Per-CPU magazine: a small LIFO stack of free blocks per size class */
+struct z_heap_magazine {
+	uint8_t count[CONFIG_K_HEAP_CACHE_CLASSES];
+	void *blocks[CONFIG_K_HEAP_CACHE_CLASSES][CONFIG_K_HEAP_CACHE_DEPTH];
+	struct k_heap_cache_stats stats;
+};
+#endif
+
 /* kernel synchronized heap struct */
 
 struct k_heap {
 	struct sys_heap heap;
 	_wait_q_t wait_q;
 	struct k_spinlock lock;
+#ifdef CONFIG_K_HEAP_CACHE
+	struct z_heap_magazine cache[CONFIG_MP_NUM_CPUS];
+	/* Threads pending on wait_q, frees bypass the cache while set */
+	int cache_waiters;
+#endif
 };
 
 /**
@@ -4978,10 +5102,40 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes,
  */
 void k_heap_free(struct k_heap *h, void *mem);
 
+#ifdef CONFIG_K_HEAP_CACHE
+/**
+ * @brief Return the current CPU's cached blocks to a k_heap
+ *
+ * Drains every size-class magazine of the calling CPU back into the
+ * underlying heap, so that the memory can be coalesced and used for
+ * allocations of any size.  Magazines of other CPUs are not touched.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param h Heap whose magazines are flushed
+ */
+void k_heap_cache_flush(struct k_heap *h);
+
+/**
+ * @brief Get size-class cache statistics of a k_heap
+ *
+ * The counters of all CPUs are summed without synchronization, so
+ * values may be slightly stale while other CPUs use the heap.
+ *
+ * @param h Heap to inspect
+ * @param stats Destination for the statistics
+ */
+void k_heap_cache_stats_get(struct k_heap *h, struct k_heap_cache_stats *stats);
+#endif
+
 /* Hand-calculated minimum heap sizes needed to return a successful
  * 1-byte allocation.  See details in lib/os/heap.[ch]
  */
+#ifdef CONFIG_SYS_HEAP_SEGREGATED_FIT
+#define Z_HEAP_MIN_SIZE (sizeof(void *) > 4 ? 64 : 52)
+#else
 #define Z_HEAP_MIN_SIZE (sizeof(void *) > 4 ? 56 : 44)
+#endif
 
 /**
  * @brief Define a static k_heap
@@ -104,6 +104,11 @@ struct _thread_base {
 
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* CPU index of the run queue the thread is queued on */
+	uint8_t runq_cpu;
+#endif
+
 #ifdef CONFIG_SCHED_CPU_MASK
 	/* "May run on" bits for each CPU */
 	uint8_t cpu_mask;
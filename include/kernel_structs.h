@@ -92,6 +92,13 @@ struct _ready_q {
 	struct _priq_rb runq;
 #elif defined(CONFIG_SCHED_MULTIQ)
 	struct _priq_mq runq;
+#elif defined(CONFIG_SCHED_BITMAP)
+	struct _priq_bitmap runq;
+#endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* number of threads currently in runq */
+	int nr_queued;
 #endif
 };
 
@@ -127,6 +134,11 @@ struct _cpu {
 	uint8_t swap_ok;
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* threads whose home is this CPU, see CONFIG_SCHED_CPU_RUNQ */
+	struct _ready_q ready_q;
+#endif
+
 	/* Per CPU architecture specifics */
 	struct _cpu_arch arch;
 };
@@ -228,6 +240,10 @@ struct _timeout {
 #else
 	int32_t dticks;
 #endif
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* ticks the expiry may be deferred by to coalesce with others */
+	uint32_t slack;
+#endif
 };
 
 #endif /* _ASMLANGUAGE */
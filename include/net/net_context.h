@@ -68,6 +68,15 @@ enum net_context_state {
 /* Context is bound to a specific interface */
 #define NET_CONTEXT_BOUND_TO_IFACE BIT(11)
 
+/** Report RX timestamps to recvmsg() */
+#define NET_CONTEXT_RECV_TIMESTAMP BIT(12)
+
+/** Report the destination address and interface to recvmsg() */
+#define NET_CONTEXT_RECV_PKTINFO BIT(13)
+
+/** Report the IP traffic class / type of service to recvmsg() */
+#define NET_CONTEXT_RECV_TCLASS BIT(14)
+
 struct net_context;
 
 /**
@@ -264,6 +273,14 @@ __net_socket struct net_context {
 	struct k_sem recv_data_wait;
 #endif /* CONFIG_NET_CONTEXT_SYNC_RECV */
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/** RX packets this context can still have queued */
+	struct k_sem rx_quota;
+
+	/** TX packets this context can still allocate */
+	struct k_sem tx_quota;
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 #if defined(CONFIG_NET_SOCKETS)
 	/** BSD socket private data */
 	void *socket_data;
@@ -281,6 +298,11 @@ __net_socket struct net_context {
 		/** Mutex used by condition variable */
 		struct k_mutex *lock;
 	} cond;
+
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	/** epoll registration of the socket, if any */
+	void *epoll_item;
+#endif
 #endif /* CONFIG_NET_SOCKETS */
 
 #if defined(CONFIG_NET_OFFLOAD)
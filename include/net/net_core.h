@@ -117,6 +117,71 @@ enum net_verdict {
  */
 int net_recv_data(struct net_if *iface, struct net_pkt *pkt);
 
+#if defined(CONFIG_NET_RX_BATCH) || defined(__DOXYGEN__)
+/**
+ * @brief Called by network device driver to push several received network
+ * packets up in the network stack at once.
+ *
+ * @details The packets are queued to the RX traffic class threads with one
+ * wakeup per traffic class instead of one per packet. Packets that cannot
+ * be received are released by this function.
+ *
+ * @param iface Network interface where the packets were received.
+ * @param pkts Array of network packets.
+ * @param count Number of packets in the array.
+ *
+ * @return Number of packets passed up, <0 if error.
+ */
+int net_recv_data_batch(struct net_if *iface, struct net_pkt **pkts,
+			size_t count);
+
+struct net_rx_poll;
+
+/**
+ * @typedef net_rx_poll_cb_t
+ * @brief Driver callback polling received packets.
+ *
+ * @details The driver passes up at most budget packets. If it handled
+ * fewer than that, it has run out of packets and must re-enable its RX
+ * interrupt before returning. Otherwise it is polled again.
+ *
+ * @param poll RX poll context of the driver.
+ * @param budget Max number of packets to handle.
+ *
+ * @return Number of packets handled.
+ */
+typedef int (*net_rx_poll_cb_t)(struct net_rx_poll *poll, int budget);
+
+/**
+ * @brief RX poll context of a network device driver.
+ */
+struct net_rx_poll {
+	/** Work item running the poll callback */
+	struct k_work work;
+
+	/** Driver poll callback */
+	net_rx_poll_cb_t cb;
+};
+
+/**
+ * @brief Initialize RX polling of a network device driver.
+ *
+ * @param poll RX poll context.
+ * @param cb Driver poll callback.
+ */
+void net_rx_poll_init(struct net_rx_poll *poll, net_rx_poll_cb_t cb);
+
+/**
+ * @brief Schedule RX polling of a network device driver.
+ *
+ * @details Typically called from the RX interrupt handler of the driver
+ * after it has masked the interrupt. Can be called from ISR context.
+ *
+ * @param poll RX poll context.
+ */
+void net_rx_poll_schedule(struct net_rx_poll *poll);
+#endif /* CONFIG_NET_RX_BATCH */
+
 /**
  * @brief Send data to network.
  *
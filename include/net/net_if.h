@@ -193,6 +193,11 @@ enum net_if_flag {
 	/** Interface supports IPv6 */
 	NET_IF_IPV6,
 
+	/** Driver or L2 cuts TCP packets larger than the MTU into segments,
+	 * see net_pkt_gso_size().
+	 */
+	NET_IF_GSO,
+
 /** @cond INTERNAL_HIDDEN */
 	/* Total number of flags - must be at the end of the enum */
 	NET_IF_NUM_FLAGS
@@ -484,6 +489,11 @@ struct net_if {
 	 */
 	int tx_pending;
 #endif
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/** RX packets this network interface can still allocate */
+	struct k_sem rx_quota;
+#endif
 };
 
 /**
@@ -90,6 +90,10 @@ struct net_pkt {
 	struct net_if *orig_iface; /* Original network interface */
 #endif
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	struct k_sem *quota; /* Quota the packet is charged to */
+#endif
+
 #if defined(CONFIG_NET_PKT_TIMESTAMP)
 	/** Timestamp if available. */
 	struct net_ptp_time timestamp;
@@ -121,6 +125,13 @@ struct net_pkt {
 	uint64_t txtime;
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_TCP_GSO)
+	/** Size of the TCP segments the packet is cut into before it is
+	 * sent, zero if the packet is sent as is.
+	 */
+	uint16_t gso_size;
+#endif /* CONFIG_NET_TCP_GSO */
+
 	/** Reference counter */
 	atomic_t atomic_ref;
 
@@ -857,6 +868,33 @@ static inline void net_pkt_set_txtime(struct net_pkt *pkt, uint64_t txtime)
 }
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_TCP_GSO)
+static inline uint16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	return pkt->gso_size;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt,
+					uint16_t gso_size)
+{
+	pkt->gso_size = gso_size;
+}
+#else
+static inline uint16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt,
+					uint16_t gso_size)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(gso_size);
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 #if defined(CONFIG_NET_PKT_TXTIME_STATS_DETAIL) || \
 	defined(CONFIG_NET_PKT_RXTIME_STATS_DETAIL)
 static inline uint32_t *net_pkt_stats_tick(struct net_pkt *pkt)
@@ -1434,6 +1472,17 @@ void net_pkt_get_info(struct k_mem_slab **rx,
 		      struct net_buf_pool **rx_data,
 		      struct net_buf_pool **tx_data);
 
+#if defined(CONFIG_NET_BUF_SIZE_CLASSES) || defined(__DOXYGEN__)
+/**
+ * @brief Get information about predefined small RX and TX DATA pools.
+ *
+ * @param rx_data Pointer to small RX DATA pool is returned.
+ * @param tx_data Pointer to small TX DATA pool is returned.
+ */
+void net_pkt_get_small_info(struct net_buf_pool **rx_data,
+			    struct net_buf_pool **tx_data);
+#endif /* CONFIG_NET_BUF_SIZE_CLASSES */
+
 /** @cond INTERNAL_HIDDEN */
 
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
@@ -163,6 +163,19 @@ struct net_stats_tcp {
 
 	/** Number of connection attempts for closed ports, triggering a RST. */
 	net_stats_t connrst;
+
+	/** Number of sent TCP packets larger than the MSS, see
+	 * CONFIG_NET_TCP_GSO.
+	 */
+	net_stats_t gso;
+
+	/** Number of TCP segments cut from those packets in software. */
+	net_stats_t gso_segs;
+
+	/** Number of received TCP segments coalesced into a previous one,
+	 * see CONFIG_NET_TCP_GRO.
+	 */
+	net_stats_t gro;
 };
 
 /**
@@ -285,6 +298,38 @@ struct net_stats_pm {
 	uint32_t start_time;
 };
 
+/**
+ * @brief Network packet pool statistics
+ */
+struct net_stats_pkt_pool {
+	/** Number of failed RX packet allocations. */
+	net_stats_t rx_alloc_fail;
+
+	/** Number of failed TX packet allocations. */
+	net_stats_t tx_alloc_fail;
+
+	/** Number of failed RX data buffer allocations. */
+	net_stats_t rx_buf_fail;
+
+	/** Number of failed TX data buffer allocations. */
+	net_stats_t tx_buf_fail;
+
+	/** Number of RX packets dropped because of a quota. */
+	net_stats_t rx_quota_drop;
+
+	/** Number of TX packet allocations refused because of a quota. */
+	net_stats_t tx_quota_drop;
+
+	/** Number of data fragments taken from the small pools. */
+	net_stats_t small_bufs;
+
+	/** Highest number of RX packets in use at the same time. */
+	uint32_t rx_max_used;
+
+	/** Highest number of TX packets in use at the same time. */
+	uint32_t tx_max_used;
+};
+
 
 /**
  * @brief All network statistics in one struct.
@@ -369,6 +414,10 @@ struct net_stats {
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
 	struct net_stats_pm pm;
 #endif
+
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+	struct net_stats_pkt_pool pkt_pool;
+#endif
 };
 
 /**
@@ -493,7 +542,8 @@ enum net_request_stats_cmd {
 	NET_REQUEST_STATS_CMD_GET_TCP,
 	NET_REQUEST_STATS_CMD_GET_ETHERNET,
 	NET_REQUEST_STATS_CMD_GET_PPP,
-	NET_REQUEST_STATS_CMD_GET_PM
+	NET_REQUEST_STATS_CMD_GET_PM,
+	NET_REQUEST_STATS_CMD_GET_PKT_POOL
 };
 
 #define NET_REQUEST_STATS_GET_ALL				\
@@ -581,6 +631,13 @@ NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PPP);
 NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PM);
 #endif /* CONFIG_NET_STATISTICS_POWER_MANAGEMENT */
 
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+#define NET_REQUEST_STATS_GET_PKT_POOL				\
+	(_NET_STATS_BASE | NET_REQUEST_STATS_CMD_GET_PKT_POOL)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PKT_POOL);
+#endif /* CONFIG_NET_STATISTICS_PKT_POOL */
+
 /**
  * @}
  */
@@ -27,6 +27,7 @@
 #include <net/net_ip.h>
 #include <net/dns_resolve.h>
 #include <net/socket_select.h>
+#include <net/socket_epoll.h>
 #include <stdlib.h>
 
 #ifdef __cplusplus
@@ -55,6 +56,10 @@ struct zsock_pollfd {
 
 /** zsock_recv: Read data without removing it from socket input queue */
 #define ZSOCK_MSG_PEEK 0x02
+/** zsock_recvmsg: Control data was discarded for lack of space in the
+ *  control buffer (output value only)
+ */
+#define ZSOCK_MSG_CTRUNC 0x08
 /** zsock_recv: return the real length of the datagram, even when it was longer
  *  than the passed buffer
  */
@@ -63,6 +68,12 @@ struct zsock_pollfd {
 #define ZSOCK_MSG_DONTWAIT 0x40
 /** zsock_recv: block until the full amount of data can be returned */
 #define ZSOCK_MSG_WAITALL 0x100
+/** zsock_recvmmsg: Only block until the first message is received */
+#define ZSOCK_MSG_WAITFORONE 0x10000
+/** zsock_recvmsg: Return the datagram in place instead of copying it,
+ *  see zsock_recvmsg()
+ */
+#define ZSOCK_MSG_ZEROCOPY 0x4000000
 
 /* Well-known values, e.g. from Linux man 2 shutdown:
  * "The constants SHUT_RD, SHUT_WR, SHUT_RDWR have the value 0, 1, 2,
@@ -386,6 +397,81 @@ __syscall ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len,
 				 int flags, struct sockaddr *src_addr,
 				 socklen_t *addrlen);
 
+/**
+ * @brief Receive a message from a socket
+ *
+ * @details
+ * @rst
+ * See `POSIX.1-2017 article
+ * <http://pubs.opengroup.org/onlinepubs/9699919799/functions/recvmsg.html>`__
+ * for normative description.
+ * This function is also exposed as ``recvmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * Data is scattered over the ``msg_iov`` buffers. For datagram sockets,
+ * ancillary data enabled with the ``SO_TIMESTAMPING``, ``IP_PKTINFO``,
+ * ``IP_RECVTOS``, ``IPV6_RECVPKTINFO`` or ``IPV6_RECVTCLASS`` socket
+ * options is returned in ``msg_control``.
+ *
+ * With ``ZSOCK_MSG_ZEROCOPY`` (datagram sockets only, not available to
+ * user mode threads) nothing is copied: ``msg_iov`` is filled with
+ * pointers to the payload inside the network buffers, ``msg_iovlen`` is
+ * set to the number of entries used, and a ``SOL_SOCKET``/``SCM_NET_BUF``
+ * control message carries the ``struct net_buf *`` owning that data. The
+ * caller must release it with net_buf_unref() once done with the data.
+ */
+__syscall ssize_t zsock_recvmsg(int sock, struct msghdr *msg, int flags);
+
+/**
+ * @brief Send several messages with a single call
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/sendmmsg.2.html>`__
+ * for the description.
+ * This function is also exposed as ``sendmmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * Every entry of ``msgvec`` is sent like with zsock_sendmsg(), and the
+ * number of bytes sent is stored in its ``msg_len``. The socket is looked
+ * up and locked once for the whole vector, so sending many small datagrams
+ * this way is cheaper than calling zsock_sendmsg() for each of them.
+ *
+ * @return Number of messages sent. If sending the first message fails, -1
+ * is returned and errno is set. A later failure ends the call early, and
+ * the caller finds it when sending the remaining messages again.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive several messages with a single call
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/recvmmsg.2.html>`__
+ * for the description.
+ * This function is also exposed as ``recvmmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * Every entry of ``msgvec`` is filled like with zsock_recvmsg(), and the
+ * number of bytes received is stored in its ``msg_len``. With
+ * ``ZSOCK_MSG_WAITFORONE``, only the first message is waited for and the
+ * call returns as soon as no more data is queued. Unlike Linux, there is no
+ * timeout argument, the ``SO_RCVTIMEO`` socket option applies to every
+ * message that is waited for.
+ *
+ * @return Number of messages received. If receiving the first message
+ * fails, -1 is returned and errno is set.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
 /**
  * @brief Receive data from a connected peer
  *
@@ -724,6 +810,23 @@ static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 	return zsock_recvfrom(sock, buf, max_len, flags, src_addr, addrlen);
 }
 
+static inline ssize_t recvmsg(int sock, struct msghdr *msg, int flags)
+{
+	return zsock_recvmsg(sock, msg, flags);
+}
+
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 {
 	return zsock_poll(fds, nfds, timeout);
@@ -797,9 +900,12 @@ static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 #define POLLNVAL ZSOCK_POLLNVAL
 
 #define MSG_PEEK ZSOCK_MSG_PEEK
+#define MSG_CTRUNC ZSOCK_MSG_CTRUNC
 #define MSG_TRUNC ZSOCK_MSG_TRUNC
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
 #define MSG_WAITALL ZSOCK_MSG_WAITALL
+#define MSG_WAITFORONE ZSOCK_MSG_WAITFORONE
+#define MSG_ZEROCOPY ZSOCK_MSG_ZEROCOPY
 
 #define SHUT_RD ZSOCK_SHUT_RD
 #define SHUT_WR ZSOCK_SHUT_WR
@@ -846,7 +952,9 @@ struct ifreq {
 /** sockopt: Bind a socket to an interface */
 #define SO_BINDTODEVICE	25
 
-/** sockopt: Timestamp TX packets */
+/** sockopt: Timestamp RX packets, reported by zsock_recvmsg() as
+ *  struct net_ptp_time
+ */
 #define SO_TIMESTAMPING 37
 /** sockopt: Protocol used with the socket */
 #define SO_PROTOCOL 38
@@ -855,9 +963,41 @@ struct ifreq {
 /** sockopt: Disable TCP buffering (ignored, for compatibility) */
 #define TCP_NODELAY 1
 
+/** cmsg: struct net_buf holding a ZSOCK_MSG_ZEROCOPY datagram */
+#define SCM_NET_BUF 100
+
+/* Socket options for IPPROTO_IP level */
+/** cmsg: IPv4 type of service, as uint8_t */
+#define IP_TOS 1
+/** sockopt: Report the destination address with struct in_pktinfo */
+#define IP_PKTINFO 8
+/** sockopt: Report the type of service with an IP_TOS control message */
+#define IP_RECVTOS 13
+
+/** Ancillary data of IP_PKTINFO */
+struct in_pktinfo {
+	unsigned int   ipi_ifindex;  /* Interface index */
+	struct in_addr ipi_spec_dst; /* Local address */
+	struct in_addr ipi_addr;     /* Destination address of the packet */
+};
+
 /* Socket options for IPPROTO_IPV6 level */
 /** sockopt: Don't support IPv4 access (ignored, for compatibility) */
 #define IPV6_V6ONLY 26
+/** sockopt: Report the destination address with struct in6_pktinfo */
+#define IPV6_RECVPKTINFO 49
+/** cmsg: Destination address and interface, as struct in6_pktinfo */
+#define IPV6_PKTINFO 50
+/** sockopt: Report the traffic class with an IPV6_TCLASS control message */
+#define IPV6_RECVTCLASS 66
+/** cmsg: IPv6 traffic class, as int */
+#define IPV6_TCLASS 67
+
+/** Ancillary data of IPV6_PKTINFO */
+struct in6_pktinfo {
+	struct in6_addr ipi6_addr;    /* Destination address of the packet */
+	unsigned int    ipi6_ifindex; /* Interface index */
+};
 
 /** sockopt: Socket priority */
 #define SO_PRIORITY 12
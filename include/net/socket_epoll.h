@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+
+/**
+ * @brief BSD Sockets compatible API
+ * @defgroup bsd_sockets BSD Sockets compatible API
+ * @ingroup networking
+ * @{
+ */
+
+#include <zephyr/types.h>
+#include <sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** zsock_epoll: Data is available to read */
+#define ZSOCK_EPOLLIN 1
+/** zsock_epoll: Data can be written */
+#define ZSOCK_EPOLLOUT 4
+/** zsock_epoll: Error condition (output value only) */
+#define ZSOCK_EPOLLERR 8
+/** zsock_epoll: Connection closed (output value only) */
+#define ZSOCK_EPOLLHUP 0x10
+/** zsock_epoll: Disable the registration after one event is reported */
+#define ZSOCK_EPOLLONESHOT BIT(30)
+/** zsock_epoll: Edge triggered, report readiness only when it changes */
+#define ZSOCK_EPOLLET BIT(31)
+
+/** zsock_epoll_ctl: Register a socket */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl: Unregister a socket */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl: Change the registration of a socket */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+typedef union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} zsock_epoll_data_t;
+
+struct zsock_epoll_event {
+	uint32_t events;	/* Requested or returned events */
+	zsock_epoll_data_t data;	/* Returned as given to zsock_epoll_ctl() */
+};
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * An epoll instance keeps a persistent set of sockets of interest.
+ * Readiness is recorded as packets arrive, so zsock_epoll_wait() only
+ * visits ready sockets instead of setting up every socket on every call
+ * like zsock_poll(). Only native (non-TLS, non-offloaded) sockets can be
+ * registered, and a socket can be registered with one epoll instance at
+ * a time.
+ * This function is also exposed as ``epoll_create()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ *
+ * @param size Ignored, but must be greater than zero.
+ *
+ * @return File descriptor of the instance, or -1 with errno set.
+ */
+__syscall int zsock_epoll_create(int size);
+
+/**
+ * @brief Add, modify or remove a socket of an epoll instance
+ *
+ * @details
+ * This function is also exposed as ``epoll_ctl()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ *
+ * @param epfd epoll instance
+ * @param op ZSOCK_EPOLL_CTL_ADD, ZSOCK_EPOLL_CTL_MOD or ZSOCK_EPOLL_CTL_DEL
+ * @param fd Socket
+ * @param event Events of interest and user data. Ignored for
+ *        ZSOCK_EPOLL_CTL_DEL.
+ *
+ * @return 0 on success, -1 with errno set otherwise.
+ */
+__syscall int zsock_epoll_ctl(int epfd, int op, int fd,
+			      struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for events on an epoll instance
+ *
+ * @details
+ * This function is also exposed as ``epoll_wait()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ *
+ * @param epfd epoll instance
+ * @param events Array receiving the ready sockets
+ * @param maxevents Number of entries in @a events
+ * @param timeout Timeout in milliseconds, or -1 to wait forever
+ *
+ * @return Number of ready sockets, 0 on timeout, or -1 with errno set.
+ */
+__syscall int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			       int maxevents, int timeout);
+
+#ifdef CONFIG_NET_SOCKETS_POSIX_NAMES
+
+#define epoll_event zsock_epoll_event
+#define epoll_data_t zsock_epoll_data_t
+
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLERR ZSOCK_EPOLLERR
+#define EPOLLHUP ZSOCK_EPOLLHUP
+#define EPOLLONESHOT ZSOCK_EPOLLONESHOT
+#define EPOLLET ZSOCK_EPOLLET
+
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
+static inline int epoll_create(int size)
+{
+	return zsock_epoll_create(size);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+#endif /* CONFIG_NET_SOCKETS_POSIX_NAMES */
+
+#ifdef __cplusplus
+}
+#endif
+
+#include <syscalls/socket_epoll.h>
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_ */
@@ -60,4 +60,29 @@ void z_priq_mq_add(struct _priq_mq *pq, struct k_thread *thread);
 void z_priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread);
 struct k_thread *z_priq_mq_best(struct _priq_mq *pq);
 
+#ifdef CONFIG_SCHED_BITMAP
+/* Bitmap-indexed multi-queue.  Like _priq_mq, one FIFO list per
+ * priority level, but covering the whole configured priority range
+ * (up to 1024 levels) with a two-level bitmap: bit i of "summary" is
+ * set if word i of "bitmap" is non-zero, and bit j of bitmap[i] is
+ * set if queues[i * 32 + j] is non-empty.  The best thread is found
+ * with two find-first-set operations.  With SCHED_DEADLINE, each
+ * level is kept sorted by deadline.
+ */
+#define Z_PRIQ_BITMAP_LEVELS (CONFIG_NUM_COOP_PRIORITIES + \
+			      CONFIG_NUM_PREEMPT_PRIORITIES + 1)
+#define Z_PRIQ_BITMAP_WORDS ((Z_PRIQ_BITMAP_LEVELS + 31) / 32)
+
+struct _priq_bitmap {
+	sys_dlist_t queues[Z_PRIQ_BITMAP_LEVELS];
+	uint32_t summary;
+	uint32_t bitmap[Z_PRIQ_BITMAP_WORDS];
+};
+
+void z_priq_bitmap_init(struct _priq_bitmap *pq);
+void z_priq_bitmap_add(struct _priq_bitmap *pq, struct k_thread *thread);
+void z_priq_bitmap_remove(struct _priq_bitmap *pq, struct k_thread *thread);
+struct k_thread *z_priq_bitmap_best(struct _priq_bitmap *pq);
+#endif
+
 #endif /* ZEPHYR_INCLUDE_SCHED_PRIQ_H_ */
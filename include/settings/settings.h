@@ -321,6 +321,36 @@ int settings_save(void);
  */
 int settings_save_one(const char *name, const void *value, size_t val_len);
 
+/**
+ * A settings item written by @ref settings_save_batch.
+ */
+struct settings_batch_item {
+	const char *name;
+	/**< Name/key of the settings item. */
+
+	const void *value;
+	/**< Pointer to the value of the settings item, NULL to delete it. */
+
+	size_t val_len;
+	/**< Length of the value. */
+};
+
+/**
+ * Write several serialized values to persisted storage in one operation.
+ *
+ * The items are written in order, as if by @ref settings_save_one, within
+ * one pair of @ref settings_store_itf::csi_save_start and
+ * @ref settings_store_itf::csi_save_end calls, so the backend can share
+ * the work needed to find where each item is stored.
+ *
+ * @param items Items to write.
+ * @param count Number of items.
+ *
+ * @return 0 on success, the first error returned by the backend otherwise.
+ */
+int settings_save_batch(const struct settings_batch_item *items,
+			size_t count);
+
 /**
  * Delete a single serialized in persisted storage.
  *
@@ -333,6 +363,49 @@ int settings_save_one(const char *name, const void *value, size_t val_len);
  */
 int settings_delete(const char *name);
 
+/**
+ * Write the values held back by CONFIG_SETTINGS_WRITE_BACK to persisted
+ * storage.
+ *
+ * Pending values are also written after CONFIG_SETTINGS_WRITE_BACK_DELAY_MS
+ * and by @ref settings_commit, but are lost on reset: this should be called
+ * before rebooting or powering off the system.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+int settings_flush(void);
+
+/**
+ * Statistics of the write-back of settings values.
+ */
+struct settings_write_back_stats {
+	uint32_t saves;
+	/**< Values held back. */
+
+	uint32_t coalesced;
+	/**< Values that replaced a pending value of the same key, each one
+	 * is a write to storage avoided.
+	 */
+
+	uint32_t written;
+	/**< Values written to storage. */
+
+	uint32_t batches;
+	/**< Batches of values written to storage. */
+
+	uint32_t errors;
+	/**< Values the storage backend failed to write. */
+};
+
+/**
+ * Get the statistics of the write-back of settings values.
+ *
+ * @param stats Filled with the statistics.
+ *
+ * @return 0 on success, -ENOTSUP if CONFIG_SETTINGS_WRITE_BACK is disabled.
+ */
+int settings_write_back_stats_get(struct settings_write_back_stats *stats);
+
 /**
  * Call commit for all settings handler. This should apply all
  * settings which has been set, but not applied yet.
@@ -92,6 +92,35 @@ int disk_access_write(const char *pdrv, const uint8_t *data_buf,
  */
 int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buff);
 
+/**
+ * @brief Disk block cache statistics, in sectors unless noted
+ */
+struct disk_cache_stats {
+	/** Sectors read from the cache */
+	uint32_t hits;
+	/** Sectors read from a disk because they were not cached */
+	uint32_t misses;
+	/** Sectors read ahead of a sequential reader */
+	uint32_t read_ahead;
+	/** Sectors written to the cache */
+	uint32_t writes;
+	/** Sectors written back from the cache to a disk */
+	uint32_t write_backs;
+	/** Read requests done to the disk drivers */
+	uint32_t disk_reads;
+	/** Write requests done to the disk drivers */
+	uint32_t disk_writes;
+};
+
+/**
+ * @brief Get the disk block cache statistics
+ *
+ * @param[out] stats        Filled with the statistics of all disks
+ *
+ * @return 0 on success, -ENOTSUP if CONFIG_DISK_CACHE is disabled
+ */
+int disk_access_cache_stats(struct disk_cache_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -61,6 +61,24 @@ struct z_heap_stress_result {
 	uint64_t accumulated_in_use_bytes;
 };
 
+/** @brief Runtime statistics of a sys_heap
+ *
+ * Filled in by sys_heap_runtime_stats_get().  All sizes are in bytes
+ * usable by callers, i.e. without chunk headers.
+ */
+struct sys_heap_runtime_stats {
+	/** Total usable bytes in free chunks */
+	size_t free_bytes;
+	/** Total usable bytes in allocated chunks */
+	size_t allocated_bytes;
+	/** Largest allocation that could currently succeed */
+	size_t largest_free_bytes;
+	/** Number of free chunks */
+	uint32_t free_chunks;
+	/** Percentage of free bytes outside the largest free chunk */
+	uint32_t fragmentation_pct;
+};
+
 /** @brief Initialize sys_heap
  *
  * Initializes a sys_heap struct to manage the specified memory.
@@ -120,6 +138,20 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes);
  */
 void sys_heap_free(struct sys_heap *heap, void *mem);
 
+/** @brief Return the usable size of an allocated block
+ *
+ * Returns the number of bytes the caller may use starting at @a mem,
+ * which is at least the size originally requested and may be larger
+ * due to chunk rounding.  Only the header of the block itself is
+ * read, so this may be called without the heap lock by the owner of
+ * the block.
+ *
+ * @param heap Heap from which the memory was allocated
+ * @param mem A pointer previously returned from sys_heap_alloc()
+ * @return Usable size of the block in bytes
+ */
+size_t sys_heap_usable_size(struct sys_heap *heap, void *mem);
+
 /** @brief Expand the size of an existing allocation
  *
  * Returns a pointer to a new memory region with the same contents,
@@ -149,6 +181,24 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 #define sys_heap_realloc(heap, ptr, bytes) \
 	sys_heap_aligned_realloc(heap, ptr, 0, bytes)
 
+/** @brief Get runtime statistics of a sys_heap
+ *
+ * Walks every chunk of the heap, so this takes time linear in the
+ * number of chunks and is meant for monitoring, not for allocation
+ * decisions.  The fragmentation ratio is the share of free memory
+ * that cannot be returned by one allocation: 0 if all free memory
+ * is contiguous, approaching 100 if it is split in many small chunks.
+ *
+ * @note The sys_heap implementation is not internally synchronized.
+ * The caller must hold the lock protecting the heap.
+ *
+ * @param heap Heap to inspect
+ * @param stats Destination for the statistics
+ * @return 0 on success, -EINVAL on NULL arguments
+ */
+int sys_heap_runtime_stats_get(struct sys_heap *heap,
+			       struct sys_heap_runtime_stats *stats);
+
 /** @brief Validate heap integrity
  *
  * Validates the internal integrity of a sys_heap.  Intended for unit
@@ -189,6 +189,27 @@ int64_t sys_clock_tick_get(void);
 
 uint64_t sys_clock_timeout_end_calc(k_timeout_t timeout);
 
+#ifdef CONFIG_TIMEOUT_SLACK
+/**
+ * @brief Timeout coalescing statistics
+ */
+struct sys_clock_slack_stats {
+	/** sys_clock_announce() calls that expired at least one timeout */
+	uint32_t announces;
+	/** Distinct expiry ticks handled by an announce beyond the first
+	 * one, i.e. timer interrupts saved by coalescing.
+	 */
+	uint32_t coalesced;
+};
+
+/**
+ * @brief Get timeout coalescing statistics
+ *
+ * @param stats Filled with a snapshot of the counters
+ */
+void sys_clock_slack_stats_get(struct sys_clock_slack_stats *stats);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,6 +25,9 @@ extern "C" {
 static inline void z_init_timeout(struct _timeout *to)
 {
 	sys_dnode_init(&to->node);
+#ifdef CONFIG_TIMEOUT_SLACK
+	to->slack = 0U;
+#endif
 }
 
 void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
@@ -8,11 +8,17 @@
 #include <ksched.h>
 #include <wait_q.h>
 #include <init.h>
+#include <string.h>
 
 void k_heap_init(struct k_heap *h, void *mem, size_t bytes)
 {
 	z_waitq_init(&h->wait_q);
 	sys_heap_init(&h->heap, mem, bytes);
+#ifdef CONFIG_K_HEAP_CACHE
+	/* Blocks cached from a previous use of the heap are gone */
+	(void)memset(h->cache, 0, sizeof(h->cache));
+	h->cache_waiters = 0;
+#endif
 
 	SYS_PORT_TRACING_OBJ_INIT(k_heap, h);
 }
@@ -28,11 +34,231 @@ static int statics_init(const struct device *unused)
 
 SYS_INIT(statics_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
+#ifdef CONFIG_K_HEAP_CACHE
+
+/* Size classes are powers of two from 1 << CACHE_MIN_SHIFT bytes.
+ * The magazines are only touched by their own CPU with local
+ * interrupts masked; the heap spinlock is taken only to move a batch
+ * of blocks between a magazine and the sys_heap.  Cached blocks stay
+ * "used" from the point of view of the sys_heap.
+ */
+#define CACHE_MIN_SHIFT 4
+#define CACHE_BATCH (CONFIG_K_HEAP_CACHE_DEPTH / 2)
+
+/* sys_heap rounds chunks to 8 bytes, so a freed block whose usable
+ * size is within that of a class size can serve that class again.
+ */
+#define CACHE_SLOP 8
+
+static inline size_t cache_class_size(int c)
+{
+	return (size_t)1 << (CACHE_MIN_SHIFT + c);
+}
+
+/* Smallest class fitting a request, or -1 if not cacheable */
+static int alloc_class(size_t bytes)
+{
+	if (bytes == 0 ||
+	    bytes > cache_class_size(CONFIG_K_HEAP_CACHE_CLASSES - 1)) {
+		return -1;
+	}
+	if (bytes <= cache_class_size(0)) {
+		return 0;
+	}
+	return 32 - __builtin_clz((uint32_t)bytes - 1U) - CACHE_MIN_SHIFT;
+}
+
+/* Class a freed block can be recycled into, or -1 */
+static int free_class(size_t usable)
+{
+	if (usable < cache_class_size(0) ||
+	    usable >= cache_class_size(CONFIG_K_HEAP_CACHE_CLASSES - 1)
+		      + CACHE_SLOP) {
+		return -1;
+	}
+
+	int c = 31 - __builtin_clz((uint32_t)usable) - CACHE_MIN_SHIFT;
+
+	return (usable - cache_class_size(c) < CACHE_SLOP) ? c : -1;
+}
+
+static inline struct z_heap_magazine *cpu_magazine(struct k_heap *h)
+{
+	return &h->cache[_current_cpu->id];
+}
+
+/* Return the n oldest blocks of a class to the heap, heap lock held */
+static void drain_class(struct k_heap *h, struct z_heap_magazine *m,
+			int c, unsigned int n)
+{
+	n = MIN(n, m->count[c]);
+	for (unsigned int i = 0; i < n; i++) {
+		sys_heap_free(&h->heap, m->blocks[c][i]);
+	}
+	m->count[c] -= n;
+	for (unsigned int i = 0; i < m->count[c]; i++) {
+		m->blocks[c][i] = m->blocks[c][i + n];
+	}
+	if (n != 0U) {
+		m->stats.drains++;
+	}
+}
+
+/* Drain all magazines of the current CPU, heap lock held.  Returns
+ * true if any memory went back to the heap.
+ */
+static bool cache_flush_locked(struct k_heap *h)
+{
+	struct z_heap_magazine *m = cpu_magazine(h);
+	bool freed = false;
+
+	for (int c = 0; c < CONFIG_K_HEAP_CACHE_CLASSES; c++) {
+		freed = freed || (m->count[c] != 0U);
+		drain_class(h, m, c, CONFIG_K_HEAP_CACHE_DEPTH);
+	}
+	return freed;
+}
+
+static void *cache_alloc(struct k_heap *h, size_t align, size_t bytes)
+{
+	int c = alloc_class(bytes);
+	void *ret = NULL;
+
+	if (c < 0 || align > sizeof(void *)) {
+		return NULL;
+	}
+
+	unsigned int key = arch_irq_lock();
+	struct z_heap_magazine *m = cpu_magazine(h);
+
+	if (m->count[c] == 0U) {
+		k_spinlock_key_t hkey = k_spin_lock(&h->lock);
+
+		while (m->count[c] < CACHE_BATCH) {
+			void *mem = sys_heap_alloc(&h->heap,
+						   cache_class_size(c));
+
+			if (mem == NULL) {
+				break;
+			}
+			m->blocks[c][m->count[c]++] = mem;
+		}
+		k_spin_unlock(&h->lock, hkey);
+
+		m->stats.alloc_misses++;
+		if (m->count[c] != 0U) {
+			m->stats.refills++;
+		}
+	} else {
+		m->stats.alloc_hits++;
+	}
+
+	if (m->count[c] != 0U) {
+		ret = m->blocks[c][--m->count[c]];
+	}
+
+	arch_irq_unlock(key);
+	return ret;
+}
+
+static bool cache_free(struct k_heap *h, void *mem)
+{
+	bool wake = false;
+	int c;
+
+	/* Blocked allocators can only be satisfied by the heap itself */
+	if (mem == NULL || h->cache_waiters != 0) {
+		return false;
+	}
+
+	c = free_class(sys_heap_usable_size(&h->heap, mem));
+	if (c < 0) {
+		return false;
+	}
+
+	unsigned int key = arch_irq_lock();
+	struct z_heap_magazine *m = cpu_magazine(h);
+
+	if (m->count[c] == CONFIG_K_HEAP_CACHE_DEPTH) {
+		k_spinlock_key_t hkey = k_spin_lock(&h->lock);
+
+		drain_class(h, m, c, CACHE_BATCH);
+		wake = IS_ENABLED(CONFIG_MULTITHREADING) &&
+		       z_unpend_all(&h->wait_q) != 0;
+		k_spin_unlock(&h->lock, hkey);
+	}
+	m->blocks[c][m->count[c]++] = mem;
+	m->stats.free_hits++;
+
+	arch_irq_unlock(key);
+
+	if (wake) {
+		z_reschedule_unlocked();
+	}
+	return true;
+}
+
+void k_heap_cache_flush(struct k_heap *h)
+{
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
+
+	if (cache_flush_locked(h) && IS_ENABLED(CONFIG_MULTITHREADING) &&
+	    z_unpend_all(&h->wait_q) != 0) {
+		z_reschedule(&h->lock, key);
+	} else {
+		k_spin_unlock(&h->lock, key);
+	}
+}
+
+void k_heap_cache_stats_get(struct k_heap *h, struct k_heap_cache_stats *stats)
+{
+	*stats = (struct k_heap_cache_stats) { 0 };
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct z_heap_magazine *m = &h->cache[i];
+
+		stats->alloc_hits += m->stats.alloc_hits;
+		stats->alloc_misses += m->stats.alloc_misses;
+		stats->free_hits += m->stats.free_hits;
+		stats->refills += m->stats.refills;
+		stats->drains += m->stats.drains;
+		for (int c = 0; c < CONFIG_K_HEAP_CACHE_CLASSES; c++) {
+			stats->cached_bytes += m->count[c] * cache_class_size(c);
+		}
+	}
+}
+
+#else
+
+static inline bool cache_flush_locked(struct k_heap *h)
+{
+	return false;
+}
+
+static inline void *cache_alloc(struct k_heap *h, size_t align, size_t bytes)
+{
+	return NULL;
+}
+
+static inline bool cache_free(struct k_heap *h, void *mem)
+{
+	return false;
+}
+
+#endif /* CONFIG_K_HEAP_CACHE */
+
 void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 			k_timeout_t timeout)
 {
 	int64_t now, end = sys_clock_timeout_end_calc(timeout);
-	void *ret = NULL;
+	void *ret = cache_alloc(h, align, bytes);
+
+	if (ret != NULL) {
+		SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap, aligned_alloc, h, timeout);
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc, h, timeout, ret);
+		return ret;
+	}
+
 	k_spinlock_key_t key = k_spin_lock(&h->lock);
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap, aligned_alloc, h, timeout);
@@ -43,6 +269,9 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 
 	while (ret == NULL) {
 		ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
+		if (ret == NULL && cache_flush_locked(h)) {
+			ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
+		}
 
 		now = sys_clock_tick_get();
 		if (!IS_ENABLED(CONFIG_MULTITHREADING) ||
@@ -60,9 +289,15 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 			 */
 		}
 
+#ifdef CONFIG_K_HEAP_CACHE
+		h->cache_waiters++;
+#endif
 		(void) z_pend_curr(&h->lock, key, &h->wait_q,
 				   K_TICKS(end - now));
 		key = k_spin_lock(&h->lock);
+#ifdef CONFIG_K_HEAP_CACHE
+		h->cache_waiters--;
+#endif
 	}
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc, h, timeout, ret);
@@ -84,6 +319,11 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout)
 
 void k_heap_free(struct k_heap *h, void *mem)
 {
+	if (cache_free(h, mem)) {
+		SYS_PORT_TRACING_OBJ_FUNC(k_heap, free, h);
+		return;
+	}
+
 	k_spinlock_key_t key = k_spin_lock(&h->lock);
 
 	sys_heap_free(&h->heap, mem);
@@ -15,6 +15,140 @@
 #include <init.h>
 #include <sys/check.h>
 
+#ifdef CONFIG_MEM_SLAB_LOCKFREE
+
+/* The free list head packs a 1-based block index in its low bits and
+ * an ABA tag, bumped on every update, in the remaining ones.  Each
+ * free block stores the index of the next one in its first word.  A
+ * pop may read that word from a block that was concurrently taken and
+ * reused, but the tag change then makes its compare-and-swap fail.
+ */
+#define FREE_IDX_BITS 16U
+#define FREE_IDX_MASK (BIT(FREE_IDX_BITS) - 1U)
+#define FREE_TAG_INC BIT(FREE_IDX_BITS)
+
+static inline char *idx_to_block(struct k_mem_slab *slab, uintptr_t idx)
+{
+	return slab->buffer + (idx - 1U) * slab->block_size;
+}
+
+static inline uintptr_t block_to_idx(struct k_mem_slab *slab, char *block)
+{
+	return (uintptr_t)(block - slab->buffer) / slab->block_size + 1U;
+}
+
+static inline atomic_val_t next_head(atomic_val_t old, uintptr_t idx)
+{
+	return (atomic_val_t)((((uintptr_t)old + FREE_TAG_INC) &
+			       ~(uintptr_t)FREE_IDX_MASK) | idx);
+}
+
+static char *free_list_pop(struct k_mem_slab *slab)
+{
+	atomic_val_t old;
+	char *block;
+
+	do {
+		old = atomic_get(&slab->free_head);
+		if ((old & FREE_IDX_MASK) == 0U) {
+			return NULL;
+		}
+		block = idx_to_block(slab, old & FREE_IDX_MASK);
+	} while (!atomic_cas(&slab->free_head, old,
+			     next_head(old, *(volatile uintptr_t *)block)));
+
+	return block;
+}
+
+static void free_list_push(struct k_mem_slab *slab, char *block)
+{
+	uintptr_t idx = block_to_idx(slab, block);
+	atomic_val_t old;
+
+	do {
+		old = atomic_get(&slab->free_head);
+		*(volatile uintptr_t *)block = old & FREE_IDX_MASK;
+	} while (!atomic_cas(&slab->free_head, old, next_head(old, idx)));
+}
+
+static inline uint32_t num_used_inc(struct k_mem_slab *slab)
+{
+	return (uint32_t)atomic_inc(&slab->num_used) + 1U;
+}
+
+static inline void num_used_dec(struct k_mem_slab *slab)
+{
+	(void)atomic_dec(&slab->num_used);
+}
+
+#else
+
+/* Caller holds slab->lock */
+static char *free_list_pop(struct k_mem_slab *slab)
+{
+	char *block = slab->free_list;
+
+	if (block != NULL) {
+		slab->free_list = *(char **)block;
+	}
+	return block;
+}
+
+static void free_list_push(struct k_mem_slab *slab, char *block)
+{
+	*(char **)block = slab->free_list;
+	slab->free_list = block;
+}
+
+static inline uint32_t num_used_inc(struct k_mem_slab *slab)
+{
+	return ++slab->num_used;
+}
+
+static inline void num_used_dec(struct k_mem_slab *slab)
+{
+	slab->num_used--;
+}
+
+#endif /* CONFIG_MEM_SLAB_LOCKFREE */
+
+/* Account for a block handed out, updating the high watermark.  In
+ * lock-free mode the caller may or may not hold slab->lock.
+ */
+static void block_taken(struct k_mem_slab *slab, bool locked)
+{
+	uint32_t used = num_used_inc(slab);
+
+#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+	/* Only a new maximum needs the lock, which is rare once the
+	 * slab has warmed up
+	 */
+	if (used > slab->max_used) {
+		if (locked) {
+			slab->max_used = MAX(used, slab->max_used);
+		} else {
+			k_spinlock_key_t key = k_spin_lock(&slab->lock);
+
+			slab->max_used = MAX(used, slab->max_used);
+			k_spin_unlock(&slab->lock, key);
+		}
+	}
+#else
+	ARG_UNUSED(used);
+	ARG_UNUSED(locked);
+#endif
+}
+
+/* Caller holds slab->lock */
+static inline void alloc_failed(struct k_mem_slab *slab)
+{
+#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+	slab->num_failed++;
+#else
+	ARG_UNUSED(slab);
+#endif
+}
+
 /**
  * @brief Initialize kernel memory slab subsystem.
  *
@@ -34,12 +168,19 @@ static int create_free_list(struct k_mem_slab *slab)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_MEM_SLAB_LOCKFREE
+	CHECKIF(slab->num_blocks > FREE_IDX_MASK) {
+		return -EINVAL;
+	}
+
+	atomic_set(&slab->free_head, 0);
+#else
 	slab->free_list = NULL;
+#endif
 	p = slab->buffer;
 
 	for (j = 0U; j < slab->num_blocks; j++) {
-		*(char **)p = slab->free_list;
-		slab->free_list = p;
+		free_list_push(slab, p);
 		p += slab->block_size;
 	}
 	return 0;
@@ -80,11 +221,17 @@ int k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->num_blocks = num_blocks;
 	slab->block_size = block_size;
 	slab->buffer = buffer;
-	slab->num_used = 0U;
 	slab->lock = (struct k_spinlock) {};
+#ifdef CONFIG_MEM_SLAB_LOCKFREE
+	atomic_set(&slab->num_used, 0);
+	atomic_set(&slab->waiters, 0);
+#else
+	slab->num_used = 0U;
+#endif
 
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	slab->max_used = 0U;
+	slab->num_failed = 0U;
 #endif
 
 	rc = create_free_list(slab);
@@ -102,34 +249,64 @@ out:
 
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 {
-	k_spinlock_key_t key = k_spin_lock(&slab->lock);
+	bool may_pend = !K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
+			IS_ENABLED(CONFIG_MULTITHREADING);
+	k_spinlock_key_t key;
+	char *block;
 	int result;
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_mem_slab, alloc, slab, timeout);
 
-	if (slab->free_list != NULL) {
-		/* take a free block */
-		*mem = slab->free_list;
-		slab->free_list = *(char **)(slab->free_list);
-		slab->num_used++;
+#ifdef CONFIG_MEM_SLAB_LOCKFREE
+	block = free_list_pop(slab);
+	if (block != NULL) {
+		*mem = block;
+		block_taken(slab, false);
 
-#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
-		slab->max_used = MAX(slab->num_used, slab->max_used);
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, 0);
+
+		return 0;
+	}
+#endif
+
+	key = k_spin_lock(&slab->lock);
+
+#ifdef CONFIG_MEM_SLAB_LOCKFREE
+	/* Announce a possible waiter before the final look at the free
+	 * list: a concurrent lock-free free either makes its block
+	 * visible to the pop below or sees the count and hands the
+	 * block over under the lock.
+	 */
+	if (may_pend) {
+		atomic_inc(&slab->waiters);
+	}
 #endif
 
+	block = free_list_pop(slab);
+	if (block != NULL) {
+		/* take a free block */
+		*mem = block;
+		block_taken(slab, true);
 		result = 0;
-	} else if (K_TIMEOUT_EQ(timeout, K_NO_WAIT) ||
-		   !IS_ENABLED(CONFIG_MULTITHREADING)) {
+	} else if (!may_pend) {
 		/* don't wait for a free block to become available */
 		*mem = NULL;
+		alloc_failed(slab);
 		result = -ENOMEM;
 	} else {
 		SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_mem_slab, alloc, slab, timeout);
 
 		/* wait for a free block or timeout */
 		result = z_pend_curr(&slab->lock, key, &slab->wait_q, timeout);
+#ifdef CONFIG_MEM_SLAB_LOCKFREE
+		atomic_dec(&slab->waiters);
+#endif
 		if (result == 0) {
 			*mem = _current->base.swap_data;
+		} else if (IS_ENABLED(CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION)) {
+			key = k_spin_lock(&slab->lock);
+			alloc_failed(slab);
+			k_spin_unlock(&slab->lock, key);
 		}
 
 		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, result);
@@ -137,6 +314,12 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 		return result;
 	}
 
+#ifdef CONFIG_MEM_SLAB_LOCKFREE
+	if (may_pend) {
+		atomic_dec(&slab->waiters);
+	}
+#endif
+
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, result);
 
 	k_spin_unlock(&slab->lock, key);
@@ -146,9 +329,44 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 
 void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&slab->lock);
+	k_spinlock_key_t key;
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_mem_slab, free, slab);
+
+#ifdef CONFIG_MEM_SLAB_LOCKFREE
+	free_list_push(slab, *mem);
+	num_used_dec(slab);
+
+	if (atomic_get(&slab->waiters) == 0) {
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
+		return;
+	}
+
+	/* A thread may be pending: give it a block, unless another
+	 * allocator got there first
+	 */
+	key = k_spin_lock(&slab->lock);
+	if (z_waitq_head(&slab->wait_q) != NULL) {
+		char *block = free_list_pop(slab);
+
+		if (block != NULL) {
+			struct k_thread *pending_thread =
+				z_unpend_first_thread(&slab->wait_q);
+
+			block_taken(slab, true);
+
+			SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
+
+			z_thread_return_value_set_with_data(pending_thread, 0,
+							    block);
+			z_ready_thread(pending_thread);
+			z_reschedule(&slab->lock, key);
+			return;
+		}
+	}
+#else
+	key = k_spin_lock(&slab->lock);
+
 	if (slab->free_list == NULL && IS_ENABLED(CONFIG_MULTITHREADING)) {
 		struct k_thread *pending_thread = z_unpend_first_thread(&slab->wait_q);
 
@@ -161,9 +379,9 @@ void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 			return;
 		}
 	}
-	**(char ***) mem = slab->free_list;
-	slab->free_list = *(char **) mem;
-	slab->num_used--;
+	free_list_push(slab, *mem);
+	num_used_dec(slab);
+#endif
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
 
@@ -34,6 +34,10 @@ LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 #define _priq_run_add		z_priq_mq_add
 #define _priq_run_remove	z_priq_mq_remove
 #define _priq_run_best		z_priq_mq_best
+#elif defined(CONFIG_SCHED_BITMAP)
+#define _priq_run_add		z_priq_bitmap_add
+#define _priq_run_remove	z_priq_bitmap_remove
+#define _priq_run_best		z_priq_bitmap_best
 #endif
 
 #if defined(CONFIG_WAITQ_SCALABLE)
@@ -170,6 +174,104 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* The CPU whose run queue a thread joins when it becomes runnable:
+ * the one it last ran on, so long as its affinity mask still allows
+ * that.  Idle or less loaded CPUs pick it up from there via
+ * runq_best().
+ */
+static ALWAYS_INLINE int home_cpu(struct k_thread *thread)
+{
+	int cpu = thread->base.cpu;
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	if ((thread->base.cpu_mask & BIT(cpu)) == 0U &&
+	    thread->base.cpu_mask != 0U) {
+		cpu = __builtin_ctz(thread->base.cpu_mask);
+	}
+#endif
+	return cpu;
+}
+
+static ALWAYS_INLINE struct _ready_q *thread_ready_q(struct k_thread *thread)
+{
+	return &_kernel.cpus[thread->base.runq_cpu].ready_q;
+}
+#endif
+
+static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	return &thread_ready_q(thread)->runq;
+#else
+	ARG_UNUSED(thread);
+	return &_kernel.ready_q.runq;
+#endif
+}
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	thread->base.runq_cpu = home_cpu(thread);
+	thread_ready_q(thread)->nr_queued++;
+#endif
+	_priq_run_add(thread_runq(thread), thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(thread_runq(thread), thread);
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	thread_ready_q(thread)->nr_queued--;
+#endif
+}
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* Best candidate for the current CPU: the head of its own run queue,
+ * unless another CPU's queue holds a strictly more important thread
+ * (which keeps the global priority guarantee), or an equally
+ * important one while being longer than ours (load balancing).  The
+ * chosen thread is not moved here; taking it out of its queue in
+ * next_up() is the steal, and it joins this CPU's queue the next
+ * time it is requeued.
+ */
+static struct k_thread *runq_best(void)
+{
+	int self = _current_cpu->id;
+	struct k_thread *best = _priq_run_best(&_current_cpu->ready_q.runq);
+	int best_len = _current_cpu->ready_q.nr_queued;
+
+	for (int i = 1; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _ready_q *rq =
+			&_kernel.cpus[(self + i) % CONFIG_MP_NUM_CPUS].ready_q;
+		struct k_thread *thread;
+		int32_t cmp;
+
+		if (rq->nr_queued == 0) {
+			continue;
+		}
+
+		thread = _priq_run_best(&rq->runq);
+		if (thread == NULL) {
+			continue;
+		}
+
+		cmp = (best == NULL) ? 1 : z_sched_prio_cmp(thread, best);
+		if ((cmp > 0) || ((cmp == 0) && (rq->nr_queued > best_len))) {
+			best = thread;
+			best_len = rq->nr_queued;
+		}
+	}
+
+	return best;
+}
+#else
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	return _priq_run_best(&_kernel.ready_q.runq);
+}
+#endif
+
 /* _current is never in the run queue until context switch on
  * SMP configurations, see z_requeue_current()
  */
@@ -178,12 +280,11 @@ static inline bool should_queue_thread(struct k_thread *th)
 	return !IS_ENABLED(CONFIG_SMP) || th != _current;
 }
 
-static ALWAYS_INLINE void queue_thread(void *pq,
-				       struct k_thread *thread)
+static ALWAYS_INLINE void queue_thread(struct k_thread *thread)
 {
 	thread->base.thread_state |= _THREAD_QUEUED;
 	if (should_queue_thread(thread)) {
-		_priq_run_add(pq, thread);
+		runq_add(thread);
 	}
 #ifdef CONFIG_SMP
 	if (thread == _current) {
@@ -193,12 +294,11 @@ static ALWAYS_INLINE void queue_thread(void *pq,
 #endif
 }
 
-static ALWAYS_INLINE void dequeue_thread(void *pq,
-					 struct k_thread *thread)
+static ALWAYS_INLINE void dequeue_thread(struct k_thread *thread)
 {
 	thread->base.thread_state &= ~_THREAD_QUEUED;
 	if (should_queue_thread(thread)) {
-		_priq_run_remove(pq, thread);
+		runq_remove(thread);
 	}
 }
 
@@ -212,7 +312,7 @@ static ALWAYS_INLINE void dequeue_thread(void *pq,
 void z_requeue_current(struct k_thread *curr)
 {
 	if (z_is_thread_queued(curr)) {
-		_priq_run_add(&_kernel.ready_q.runq, curr);
+		runq_add(curr);
 	}
 }
 #endif
@@ -226,7 +326,7 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 {
 	struct k_thread *thread;
 
-	thread = _priq_run_best(&_kernel.ready_q.runq);
+	thread = runq_best();
 
 #if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
 	/* MetaIRQs must always attempt to return back to a
@@ -292,12 +392,12 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if (thread != _current && active &&
 		!z_is_idle_thread_object(_current) && !queued) {
-		queue_thread(&_kernel.ready_q.runq, _current);
+		queue_thread(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
 
 	_current_cpu->swap_ok = false;
@@ -308,9 +408,9 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 static void move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
-	queue_thread(&_kernel.ready_q.runq, thread);
+	queue_thread(thread);
 	update_cache(thread == _current);
 }
 
@@ -476,7 +576,7 @@ static void ready_thread(struct k_thread *thread)
 	if (!z_is_thread_queued(thread) && z_is_thread_ready(thread)) {
 		SYS_PORT_TRACING_OBJ_FUNC(k_thread, sched_ready, thread);
 
-		queue_thread(&_kernel.ready_q.runq, thread);
+		queue_thread(thread);
 		update_cache(0);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
 		arch_sched_ipi();
@@ -522,7 +622,7 @@ void z_impl_k_thread_suspend(struct k_thread *thread)
 
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
 		}
 		z_mark_thread_as_suspended(thread);
 		update_cache(thread == _current);
@@ -583,7 +683,7 @@ static _wait_q_t *pended_on_thread(struct k_thread *thread)
 static void unready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
 	update_cache(thread == _current);
 }
@@ -746,9 +846,9 @@ bool z_set_prio(struct k_thread *thread, int prio)
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				dequeue_thread(&_kernel.ready_q.runq, thread);
+				dequeue_thread(thread);
 				thread->base.prio = prio;
-				queue_thread(&_kernel.ready_q.runq, thread);
+				queue_thread(thread);
 			} else {
 				thread->base.prio = prio;
 			}
@@ -890,6 +990,9 @@ void *z_get_next_switch_handle(void *interrupted)
 #endif
 			_current_cpu->swap_ok = 0;
 			set_current(new_thread);
+#ifdef CONFIG_SMP
+			new_thread->base.cpu = _current_cpu->id;
+#endif
 
 #ifdef CONFIG_SPIN_VALIDATE
 			/* Changed _current!  Update the spinlock
@@ -907,8 +1010,7 @@ void *z_get_next_switch_handle(void *interrupted)
 			 * will not return into it.
 			 */
 			if (z_is_thread_queued(old_thread)) {
-				_priq_run_add(&_kernel.ready_q.runq,
-					      old_thread);
+				runq_add(old_thread);
 			}
 		}
 		old_thread->switch_handle = interrupted;
@@ -1067,6 +1169,83 @@ struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
 	return thread;
 }
 
+#ifdef CONFIG_SCHED_BITMAP
+BUILD_ASSERT(Z_PRIQ_BITMAP_WORDS <= 32,
+	     "Too many priorities for bitmap scheduler (max 1024)");
+
+void z_priq_bitmap_init(struct _priq_bitmap *pq)
+{
+	for (int i = 0; i < ARRAY_SIZE(pq->queues); i++) {
+		sys_dlist_init(&pq->queues[i]);
+	}
+	pq->summary = 0U;
+	for (int i = 0; i < ARRAY_SIZE(pq->bitmap); i++) {
+		pq->bitmap[i] = 0U;
+	}
+}
+
+static ALWAYS_INLINE void bitmap_level_insert(sys_dlist_t *l,
+						struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_DEADLINE
+	struct k_thread *t;
+
+	/* All threads in the list share the same static priority, so
+	 * this only walks past those with an earlier deadline.
+	 */
+	SYS_DLIST_FOR_EACH_CONTAINER(l, t, base.qnode_dlist) {
+		if (z_sched_prio_cmp(thread, t) > 0) {
+			sys_dlist_insert(&t->base.qnode_dlist,
+					 &thread->base.qnode_dlist);
+			return;
+		}
+	}
+#endif
+	sys_dlist_append(l, &thread->base.qnode_dlist);
+}
+
+ALWAYS_INLINE void z_priq_bitmap_add(struct _priq_bitmap *pq,
+				     struct k_thread *thread)
+{
+	int level = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+
+	__ASSERT_NO_MSG(!z_is_idle_thread_object(thread));
+
+	bitmap_level_insert(&pq->queues[level], thread);
+	pq->bitmap[level / 32] |= BIT(level % 32);
+	pq->summary |= BIT(level / 32);
+}
+
+ALWAYS_INLINE void z_priq_bitmap_remove(struct _priq_bitmap *pq,
+					struct k_thread *thread)
+{
+	int level = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+
+	__ASSERT_NO_MSG(!z_is_idle_thread_object(thread));
+
+	sys_dlist_remove(&thread->base.qnode_dlist);
+	if (sys_dlist_is_empty(&pq->queues[level])) {
+		pq->bitmap[level / 32] &= ~BIT(level % 32);
+		if (pq->bitmap[level / 32] == 0U) {
+			pq->summary &= ~BIT(level / 32);
+		}
+	}
+}
+
+struct k_thread *z_priq_bitmap_best(struct _priq_bitmap *pq)
+{
+	if (pq->summary == 0U) {
+		return NULL;
+	}
+
+	int word = __builtin_ctz(pq->summary);
+	int level = word * 32 + __builtin_ctz(pq->bitmap[word]);
+	sys_dnode_t *n = sys_dlist_peek_head(&pq->queues[level]);
+
+	return CONTAINER_OF(n, struct k_thread, base.qnode_dlist);
+}
+#endif /* CONFIG_SCHED_BITMAP */
+
 int z_unpend_all(_wait_q_t *wait_q)
 {
 	int need_sched = 0;
@@ -1081,14 +1260,14 @@ int z_unpend_all(_wait_q_t *wait_q)
 	return need_sched;
 }
 
-void z_sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
@@ -1096,9 +1275,24 @@ void z_sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+		sys_dlist_init(&rq->runq.queues[i]);
+	}
+#endif
+
+#ifdef CONFIG_SCHED_BITMAP
+	z_priq_bitmap_init(&rq->runq);
+#endif
+}
+
+void z_sched_init(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
+#else
+	init_ready_q(&_kernel.ready_q);
 #endif
 
 #ifdef CONFIG_TIMESLICING
@@ -1158,8 +1352,8 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_spinlock) {
 		thread->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
-			queue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
+			queue_thread(thread);
 		}
 	}
 }
@@ -1190,10 +1384,9 @@ void z_impl_k_yield(void)
 
 	if (!IS_ENABLED(CONFIG_SMP) ||
 	    z_is_thread_queued(_current)) {
-		dequeue_thread(&_kernel.ready_q.runq,
-			       _current);
+		dequeue_thread(_current);
 	}
-	queue_thread(&_kernel.ready_q.runq, _current);
+	queue_thread(_current);
 	update_cache(1);
 	z_swap(&sched_spinlock, key);
 }
@@ -1469,7 +1662,7 @@ static void end_thread(struct k_thread *thread)
 		thread->base.thread_state |= _THREAD_DEAD;
 		thread->base.thread_state &= ~_THREAD_ABORTING;
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
 		}
 		if (thread->base.pended_on != NULL) {
 			unpend_thread_no_timeout(thread);
@@ -14,7 +14,9 @@
 
 static uint64_t curr_tick;
 
+#ifndef CONFIG_TIMEOUT_WHEEL
 static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+#endif
 
 static struct k_spinlock timeout_lock;
 
@@ -36,6 +38,134 @@ static inline int z_vrfy_sys_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+/* Hierarchical timing wheel.  Here dticks holds the absolute expiry
+ * tick rather than a delta.  Level L has WHEEL_SLOTS slots, each
+ * covering 2^(WHEEL_BITS * L) ticks.  A timeout is stored on the
+ * level of the highest WHEEL_BITS-wide digit in which its expiry
+ * differs from curr_tick, in the slot selected by that digit of the
+ * expiry, so insertion and removal are O(1).  Level 0 slots hold
+ * timeouts expiring at exactly that tick.  When curr_tick reaches the
+ * start of an occupied slot above level 0 its entries are moved
+ * ("cascaded") to lower levels.  Timeouts beyond the range of the top
+ * level sit in the top level slot matching their expiry and are
+ * re-examined each time the top level wraps around to it.
+ *
+ * wheel_map has bit N of level L set when slot N may be non-empty.
+ * Bits are set on insertion and only cleared once a slot is seen
+ * empty, so removal doesn't need to know where a timeout lives and a
+ * slot list with its bit clear is (re)initialized before use.
+ */
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_LEVELS CONFIG_TIMEOUT_WHEEL_LEVELS
+
+static sys_dlist_t wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint64_t wheel_map[WHEEL_LEVELS];
+
+static int wheel_slot(uint64_t tick, int level)
+{
+	return (tick >> (level * WHEEL_BITS)) & (WHEEL_SLOTS - 1);
+}
+
+static void wheel_insert(struct _timeout *to)
+{
+	uint64_t expiry = to->dticks;
+	uint64_t diff = expiry ^ curr_tick;
+	int level = 0;
+	int slot;
+
+	if (diff != 0U) {
+		level = MIN((63 - __builtin_clzll(diff)) / WHEEL_BITS,
+			    WHEEL_LEVELS - 1);
+	}
+
+	slot = wheel_slot(expiry, level);
+	if ((wheel_map[level] & BIT64(slot)) == 0U) {
+		sys_dlist_init(&wheel[level][slot]);
+		wheel_map[level] |= BIT64(slot);
+	}
+	sys_dlist_append(&wheel[level][slot], &to->node);
+}
+
+/* Tick of the next wheel event on levels from_level and up: either a
+ * level 0 slot expiring or an upper level slot to be cascaded,
+ * UINT64_MAX if those levels are empty.  Occupied slots of level L
+ * all lie within the current slot of level L + 1, so the first
+ * occupied level holds the next event.
+ */
+static uint64_t wheel_next_event(int from_level)
+{
+	for (int level = from_level; level < WHEEL_LEVELS; level++) {
+		int shift = level * WHEEL_BITS;
+		int cur = wheel_slot(curr_tick, level);
+		uint64_t span = BIT64(shift + WHEEL_BITS);
+		uint64_t base = curr_tick & ~(span - 1U);
+
+		while (wheel_map[level] != 0U) {
+			/* The current level 0 slot is due right now.  The
+			 * current slot of an upper level has already been
+			 * cascaded, anything in it has wrapped around.
+			 */
+			int first = (level == 0) ? cur : cur + 1;
+			uint64_t ahead = (first == WHEEL_SLOTS) ? 0U :
+				wheel_map[level] & ~BIT64_MASK(first);
+			uint64_t when;
+			int slot;
+
+			if (ahead != 0U) {
+				slot = __builtin_ctzll(ahead);
+				when = base + ((uint64_t)slot << shift);
+			} else {
+				slot = __builtin_ctzll(wheel_map[level]);
+				when = base + span + ((uint64_t)slot << shift);
+			}
+
+			if (sys_dlist_is_empty(&wheel[level][slot])) {
+				wheel_map[level] &= ~BIT64(slot);
+				continue;
+			}
+
+			return when;
+		}
+	}
+
+	return UINT64_MAX;
+}
+
+/* Redistribute upper level slots starting at curr_tick */
+static void wheel_cascade(void)
+{
+	for (int level = WHEEL_LEVELS - 1; level > 0; level--) {
+		int slot = wheel_slot(curr_tick, level);
+		sys_dnode_t *node;
+		sys_dlist_t moved;
+
+		if (((curr_tick & BIT64_MASK(level * WHEEL_BITS)) != 0U) ||
+		    ((wheel_map[level] & BIT64(slot)) == 0U)) {
+			continue;
+		}
+
+		/* Entries wrapped around the top level can land in
+		 * this very slot again, so empty it first.
+		 */
+		sys_dlist_init(&moved);
+		while ((node = sys_dlist_get(&wheel[level][slot])) != NULL) {
+			sys_dlist_append(&moved, node);
+		}
+		wheel_map[level] &= ~BIT64(slot);
+
+		while ((node = sys_dlist_get(&moved)) != NULL) {
+			wheel_insert(CONTAINER_OF(node, struct _timeout, node));
+		}
+	}
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	sys_dlist_remove(&t->node);
+}
+#else
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -58,18 +188,212 @@ static void remove_timeout(struct _timeout *t)
 
 	sys_dlist_remove(&t->node);
 }
+#endif /* CONFIG_TIMEOUT_WHEEL */
 
 static int32_t elapsed(void)
 {
 	return announce_remaining == 0 ? sys_clock_elapsed() : 0U;
 }
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+#ifdef CONFIG_TIMEOUT_SLACK
+/* Tick by which sys_clock_announce() must next run, UINT64_MAX if
+ * nothing is pending: the earliest expiry plus slack among the level 0
+ * timeouts, capped by the next cascade.  *owner is set to the timeout
+ * providing it, NULL for a cascade.
+ */
+static uint64_t slack_scan(struct _timeout **owner)
+{
+	uint64_t base = curr_tick & ~BIT64_MASK(WHEEL_BITS);
+	uint64_t bound = wheel_next_event(1);
+
+	*owner = NULL;
+	for (int slot = wheel_slot(curr_tick, 0); slot < WHEEL_SLOTS; slot++) {
+		uint64_t when = base + slot;
+		struct _timeout *t;
+
+		if (when >= bound) {
+			break;
+		}
+		if ((wheel_map[0] & BIT64(slot)) == 0U) {
+			continue;
+		}
+		SYS_DLIST_FOR_EACH_CONTAINER(&wheel[0][slot], t, node) {
+			if (when + t->slack < bound) {
+				bound = when + t->slack;
+				*owner = t;
+			}
+		}
+	}
+
+	return bound;
+}
+#else
+/* Ticks from curr_tick until the next wheel event, INT64_MAX if the
+ * wheel is empty.
+ */
+static int64_t next_expiry(void)
+{
+	uint64_t bound = wheel_next_event(0);
+
+	return bound == UINT64_MAX ? INT64_MAX : (int64_t)(bound - curr_tick);
+}
+#endif /* CONFIG_TIMEOUT_SLACK */
+
+/* Returns the absolute expiry tick of the new timeout */
+static uint64_t timeout_insert(struct _timeout *to, k_timeout_t timeout)
+{
+	if (Z_TICK_ABS(timeout.ticks) >= 0) {
+		to->dticks = MAX(curr_tick + 1,
+				 (uint64_t)Z_TICK_ABS(timeout.ticks));
+	} else {
+		to->dticks = curr_tick + timeout.ticks + 1 + elapsed();
+	}
+
+	wheel_insert(to);
+
+	return to->dticks;
+}
+#else
+#ifdef CONFIG_TIMEOUT_SLACK
+/* Tick by which sys_clock_announce() must next run, UINT64_MAX if
+ * nothing is pending: the earliest expiry plus slack, which only needs
+ * to look at the timeouts expiring before it.  *owner is set to the
+ * timeout providing it.
+ */
+static uint64_t slack_scan(struct _timeout **owner)
+{
+	uint64_t expiry = curr_tick;
+	uint64_t bound = UINT64_MAX;
+
+	*owner = NULL;
+	for (struct _timeout *t = first();
+	     t != NULL && expiry + t->dticks < bound; t = next(t)) {
+		expiry += t->dticks;
+		if (expiry + t->slack < bound) {
+			bound = expiry + t->slack;
+			*owner = t;
+		}
+	}
+
+	return bound;
+}
+#else
+/* Ticks from curr_tick until the first expiry, INT64_MAX if none */
+static int64_t next_expiry(void)
+{
+	struct _timeout *t = first();
+
+	return t == NULL ? INT64_MAX : t->dticks;
+}
+#endif /* CONFIG_TIMEOUT_SLACK */
+
+/* Returns the absolute expiry tick of the new timeout */
+static uint64_t timeout_insert(struct _timeout *to, k_timeout_t timeout)
+{
+	struct _timeout *t;
+	uint64_t expiry;
+
+	if (IS_ENABLED(CONFIG_TIMEOUT_64BIT) &&
+	    Z_TICK_ABS(timeout.ticks) >= 0) {
+		k_ticks_t ticks = Z_TICK_ABS(timeout.ticks) - curr_tick;
+
+		to->dticks = MAX(1, ticks);
+	} else {
+		to->dticks = timeout.ticks + 1 + elapsed();
+	}
+	expiry = curr_tick + to->dticks;
+
+	for (t = first(); t != NULL; t = next(t)) {
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+
+	return expiry;
+}
+#endif /* CONFIG_TIMEOUT_WHEEL */
+
+#ifdef CONFIG_TIMEOUT_SLACK
+/* The result of slack_scan() is kept until an announce or the abort of
+ * the timeout it came from: adding a timeout can only bring it
+ * earlier, and aborting any other one leaves it unchanged.
+ */
+static uint64_t slack_bound;
+static struct _timeout *slack_owner;
+static bool slack_bound_valid;
+
+/* Ticks from curr_tick until sys_clock_announce() must next run,
+ * INT64_MAX if nothing is pending.
+ */
+static int64_t next_expiry(void)
+{
+	if (!slack_bound_valid) {
+		slack_bound = slack_scan(&slack_owner);
+		slack_bound_valid = true;
+	}
+
+	return slack_bound == UINT64_MAX ? INT64_MAX
+		: (int64_t)(slack_bound - curr_tick);
+}
+
+static void slack_bound_add(struct _timeout *to, uint64_t expiry)
+{
+#ifdef CONFIG_TIMEOUT_WHEEL
+	uint64_t cascade;
+#endif
+
+	if (!slack_bound_valid) {
+		return;
+	}
+
+	if (expiry + to->slack < slack_bound) {
+		slack_bound = expiry + to->slack;
+		slack_owner = to;
+	}
+
+#ifdef CONFIG_TIMEOUT_WHEEL
+	/* The new timeout may also have brought a cascade earlier */
+	cascade = wheel_next_event(1);
+	if (cascade < slack_bound) {
+		slack_bound = cascade;
+		slack_owner = NULL;
+	}
+#endif
+}
+
+static void slack_bound_remove(struct _timeout *to)
+{
+	if (to == slack_owner) {
+		slack_bound_valid = false;
+	}
+}
+#else
+static inline void slack_bound_add(struct _timeout *to, uint64_t expiry)
+{
+	ARG_UNUSED(to);
+	ARG_UNUSED(expiry);
+}
+
+static inline void slack_bound_remove(struct _timeout *to)
+{
+	ARG_UNUSED(to);
+}
+#endif /* CONFIG_TIMEOUT_SLACK */
+
 static int32_t next_timeout(void)
 {
-	struct _timeout *to = first();
+	int64_t to = next_expiry();
 	int32_t ticks_elapsed = elapsed();
-	int32_t ret = to == NULL ? MAX_WAIT
-		: CLAMP(to->dticks - ticks_elapsed, 0, MAX_WAIT);
+	int32_t ret = to == INT64_MAX ? MAX_WAIT
+		: CLAMP(to - ticks_elapsed, 0, MAX_WAIT);
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -94,31 +418,11 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 	to->fn = fn;
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
-
-		if (IS_ENABLED(CONFIG_TIMEOUT_64BIT) &&
-		    Z_TICK_ABS(timeout.ticks) >= 0) {
-			k_ticks_t ticks = Z_TICK_ABS(timeout.ticks) - curr_tick;
-
-			to->dticks = MAX(1, ticks);
-		} else {
-			to->dticks = timeout.ticks + 1 + elapsed();
-		}
-
-		for (t = first(); t != NULL; t = next(t)) {
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
+		int64_t prev_expiry = next_expiry();
 
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
+		slack_bound_add(to, timeout_insert(to, timeout));
 
-		if (to == first()) {
+		if (next_expiry() < prev_expiry) {
 #if CONFIG_TIMESLICING
 			/*
 			 * This is not ideal, since it does not
@@ -148,6 +452,7 @@ int z_abort_timeout(struct _timeout *to)
 	LOCKED(&timeout_lock) {
 		if (sys_dnode_is_linked(&to->node)) {
 			remove_timeout(to);
+			slack_bound_remove(to);
 			ret = 0;
 		}
 	}
@@ -164,12 +469,16 @@ static k_ticks_t timeout_rem(const struct _timeout *timeout)
 		return 0;
 	}
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+	ticks = timeout->dticks - curr_tick;
+#else
 	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
 		ticks += t->dticks;
 		if (timeout == t) {
 			break;
 		}
 	}
+#endif
 
 	return ticks - elapsed();
 }
@@ -230,6 +539,30 @@ void z_set_timeout_expiry(int32_t ticks, bool is_idle)
 	}
 }
 
+#ifdef CONFIG_TIMEOUT_SLACK
+static struct sys_clock_slack_stats slack_stats;
+
+/* Counts the distinct expiry ticks handled by one announce: each one
+ * beyond the first would have needed its own timer interrupt without
+ * slack.
+ */
+#define COUNT_EXPIRY_TICK(count, tick) do {	\
+		if ((tick) != last_expiry) {	\
+			last_expiry = (tick);	\
+			(count)++;		\
+		}				\
+	} while (false)
+
+void sys_clock_slack_stats_get(struct sys_clock_slack_stats *stats)
+{
+	LOCKED(&timeout_lock) {
+		*stats = slack_stats;
+	}
+}
+#else
+#define COUNT_EXPIRY_TICK(count, tick) do {} while (false)
+#endif
+
 void sys_clock_announce(int32_t ticks)
 {
 #ifdef CONFIG_TIMESLICING
@@ -237,15 +570,54 @@ void sys_clock_announce(int32_t ticks)
 #endif
 
 	k_spinlock_key_t key = k_spin_lock(&timeout_lock);
+#ifdef CONFIG_TIMEOUT_SLACK
+	uint32_t expiry_ticks = 0U;
+	uint64_t last_expiry = UINT64_MAX;
+
+	slack_bound_valid = false;
+#endif
 
 	announce_remaining = ticks;
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+	for (uint64_t ev = wheel_next_event(0);
+	     ev <= curr_tick + announce_remaining;
+	     ev = wheel_next_event(0)) {
+		int slot = wheel_slot(ev, 0);
+		sys_dnode_t *node;
+
+		announce_remaining -= ev - curr_tick;
+		curr_tick = ev;
+		wheel_cascade();
+
+		/* A cascade event may leave this slot untouched.  New
+		 * timeouts added by the callbacks expire after
+		 * curr_tick, so never land in it.
+		 */
+		if ((wheel_map[0] & BIT64(slot)) == 0U) {
+			continue;
+		}
+
+		while ((node = sys_dlist_get(&wheel[0][slot])) != NULL) {
+			struct _timeout *t =
+				CONTAINER_OF(node, struct _timeout, node);
+
+			COUNT_EXPIRY_TICK(expiry_ticks, ev);
+			t->dticks = 0;
+
+			k_spin_unlock(&timeout_lock, key);
+			t->fn(t);
+			key = k_spin_lock(&timeout_lock);
+		}
+	}
+#else
 	while (first() != NULL && first()->dticks <= announce_remaining) {
 		struct _timeout *t = first();
 		int dt = t->dticks;
 
 		curr_tick += dt;
 		announce_remaining -= dt;
+		COUNT_EXPIRY_TICK(expiry_ticks, curr_tick);
 		t->dticks = 0;
 		remove_timeout(t);
 
@@ -257,10 +629,19 @@ void sys_clock_announce(int32_t ticks)
 	if (first() != NULL) {
 		first()->dticks -= announce_remaining;
 	}
+#endif
 
 	curr_tick += announce_remaining;
 	announce_remaining = 0;
 
+#ifdef CONFIG_TIMEOUT_SLACK
+	if (expiry_ticks != 0U) {
+		slack_stats.announces++;
+		slack_stats.coalesced += expiry_ticks - 1U;
+	}
+	slack_bound_valid = false;
+#endif
+
 	sys_clock_set_timeout(next_timeout(), false);
 
 	k_spin_unlock(&timeout_lock, key);
@@ -17,9 +17,12 @@
  * running one and corrupting it. YMMV.
  */
 
+/* A solo free header (one unit, big heaps only) may sit right before
+ * the end marker, so that is the last possible chunk.
+ */
 static chunkid_t max_chunkid(struct z_heap *h)
 {
-	return h->end_chunk - min_chunk_size(h);
+	return h->end_chunk - 1;
 }
 
 #define VALIDATE(cond) do { if (!(cond)) { return false; } } while (0)
@@ -60,8 +63,8 @@ static inline void check_nexts(struct z_heap *h, int bidx)
 {
 	struct z_heap_bucket *b = &h->buckets[bidx];
 
-	bool emptybit = (h->avail_buckets & (1 << bidx)) == 0;
-	bool emptylist = b->next == 0;
+	bool emptybit = (h->avail_buckets & bucket_group_bit(bidx)) == 0;
+	bool emptylist = bucket_group_empty(h, bidx);
 	bool empties_match = emptybit == emptylist;
 
 	(void)empties_match;
@@ -93,7 +96,7 @@ bool sys_heap_validate(struct sys_heap *heap)
 	 * should be correct, and all chunk entries should point into
 	 * valid unused chunks.  Mark those chunks USED, temporarily.
 	 */
-	for (int b = 0; b <= bucket_idx(h, h->end_chunk); b++) {
+	for (int b = 0; b < nb_buckets(h); b++) {
 		chunkid_t c0 = h->buckets[b].next;
 		uint32_t n = 0;
 
@@ -107,14 +110,15 @@ bool sys_heap_validate(struct sys_heap *heap)
 			set_chunk_used(h, c, true);
 		}
 
-		bool empty = (h->avail_buckets & (1 << b)) == 0;
+		/* The avail bit covers a whole group of sub-buckets */
+		bool empty = (h->avail_buckets & bucket_group_bit(b)) == 0;
 		bool zero = n == 0;
 
-		if (empty != zero) {
+		if (empty != bucket_group_empty(h, b)) {
 			return false;
 		}
 
-		if (empty && h->buckets[b].next != 0) {
+		if (empty && !zero) {
 			return false;
 		}
 	}
@@ -145,7 +149,7 @@ bool sys_heap_validate(struct sys_heap *heap)
 	 * pass caught all the blocks and that they now show UNUSED.
 	 * Mark them USED.
 	 */
-	for (int b = 0; b <= bucket_idx(h, h->end_chunk); b++) {
+	for (int b = 0; b < nb_buckets(h); b++) {
 		chunkid_t c0 = h->buckets[b].next;
 		int n = 0;
 
@@ -319,16 +323,16 @@ void sys_heap_stress(void *(*alloc_fn)(void *arg, size_t bytes),
  */
 void heap_print_info(struct z_heap *h, bool dump_chunks)
 {
-	int i, nb_buckets = bucket_idx(h, h->end_chunk) + 1;
+	int i, nb = nb_buckets(h);
 	size_t free_bytes, allocated_bytes, total, overhead;
 
 	printk("Heap at %p contains %d units in %d buckets\n\n",
-	       chunk_buf(h), h->end_chunk, nb_buckets);
+	       chunk_buf(h), h->end_chunk, nb);
 
 	printk("  bucket#    min units        total      largest      largest\n"
 	       "             threshold       chunks      (units)      (bytes)\n"
 	       "  -----------------------------------------------------------\n");
-	for (i = 0; i < nb_buckets; i++) {
+	for (i = 0; i < nb; i++) {
 		chunkid_t first = h->buckets[i].next;
 		chunksz_t largest = 0;
 		int count = 0;
@@ -343,7 +347,7 @@ void heap_print_info(struct z_heap *h, bool dump_chunks)
 		}
 		if (count) {
 			printk("%9d %12d %12d %12d %12zd\n",
-			       i, (1 << i) - 1 + min_chunk_size(h), count,
+			       i, bucket_min_size(h, i), count,
 			       largest, chunksz_to_bytes(h, largest));
 		}
 	}
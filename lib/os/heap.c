@@ -6,6 +6,7 @@
 #include <sys/sys_heap.h>
 #include <kernel.h>
 #include <string.h>
+#include <errno.h>
 #include "heap.h"
 
 static void *chunk_mem(struct z_heap *h, chunkid_t c)
@@ -24,12 +25,14 @@ static void free_list_remove_bidx(struct z_heap *h, chunkid_t c, int bidx)
 
 	CHECK(!chunk_used(h, c));
 	CHECK(b->next != 0);
-	CHECK(h->avail_buckets & (1 << bidx));
+	CHECK(h->avail_buckets & bucket_group_bit(bidx));
 
 	if (next_free_chunk(h, c) == c) {
 		/* this is the last chunk */
-		h->avail_buckets &= ~(1 << bidx);
 		b->next = 0;
+		if (BUCKET_SUBS == 1 || bucket_group_empty(h, bidx)) {
+			h->avail_buckets &= ~bucket_group_bit(bidx);
+		}
 	} else {
 		chunkid_t first = prev_free_chunk(h, c),
 			  second = next_free_chunk(h, c);
@@ -53,15 +56,16 @@ static void free_list_add_bidx(struct z_heap *h, chunkid_t c, int bidx)
 	struct z_heap_bucket *b = &h->buckets[bidx];
 
 	if (b->next == 0U) {
-		CHECK((h->avail_buckets & (1 << bidx)) == 0);
+		CHECK(BUCKET_SUBS > 1 ||
+		      (h->avail_buckets & bucket_group_bit(bidx)) == 0);
 
 		/* Empty list, first item */
-		h->avail_buckets |= (1 << bidx);
+		h->avail_buckets |= bucket_group_bit(bidx);
 		b->next = c;
 		set_prev_free_chunk(h, c, c);
 		set_next_free_chunk(h, c, c);
 	} else {
-		CHECK(h->avail_buckets & (1 << bidx));
+		CHECK(h->avail_buckets & bucket_group_bit(bidx));
 
 		/* Insert before (!) the "next" pointer */
 		chunkid_t second = b->next;
@@ -167,13 +171,103 @@ void sys_heap_free(struct sys_heap *heap, void *mem)
 	free_chunk(h, c);
 }
 
+size_t sys_heap_usable_size(struct sys_heap *heap, void *mem)
+{
+	struct z_heap *h = heap->heap;
+	chunkid_t c = mem_to_chunkid(h, mem);
+	size_t addr = (size_t)mem;
+	size_t chunk_base = (size_t)&chunk_buf(h)[c];
+	size_t chunk_sz = chunk_size(h, c) * CHUNK_UNIT;
+
+	/* Aligned allocations may start past the chunk header */
+	return chunk_sz - (addr - chunk_base);
+}
+
+/* Returns the first non-empty bucket at or above bidx, or -1 */
+static int next_avail_bucket(struct z_heap *h, int bidx)
+{
+	int nb = nb_buckets(h);
+
+	/* Rest of the group containing bidx, if it is not the first */
+	for (; bidx < nb && (bidx & (BUCKET_SUBS - 1)) != 0; bidx++) {
+		if (h->buckets[bidx].next != 0U) {
+			return bidx;
+		}
+	}
+	if (bidx >= nb) {
+		return -1;
+	}
+
+	uint32_t bmask = h->avail_buckets & ~(bucket_group_bit(bidx) - 1);
+
+	if (bmask == 0U) {
+		return -1;
+	}
+
+	bidx = __builtin_ctz(bmask) << BUCKET_SUB_BITS;
+	while (h->buckets[bidx].next == 0U) {
+		bidx++;
+	}
+	return bidx;
+}
+
+#ifdef CONFIG_SYS_HEAP_BEST_FIT
+/* Smallest chunk of a bucket that fits sz, or 0 */
+static chunkid_t best_fit_in_bucket(struct z_heap *h, int bidx, chunksz_t sz)
+{
+	chunkid_t first = h->buckets[bidx].next, c = first, best = 0;
+	chunksz_t best_sz = 0;
+
+	if (first == 0U) {
+		return 0;
+	}
+
+	do {
+		chunksz_t csz = chunk_size(h, c);
+
+		if (csz >= sz && (best == 0U || csz < best_sz)) {
+			best = c;
+			best_sz = csz;
+			if (csz == sz) {
+				break;
+			}
+		}
+		c = next_free_chunk(h, c);
+	} while (c != first);
+
+	return best;
+}
+#endif
+
 static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz)
 {
 	int bi = bucket_idx(h, sz);
-	struct z_heap_bucket *b = &h->buckets[bi];
 
 	CHECK(bi <= bucket_idx(h, h->end_chunk));
 
+#ifdef CONFIG_SYS_HEAP_BEST_FIT
+	/* Search the whole minimal bucket for the tightest fit.  If
+	 * nothing fits there, every chunk of the next non-empty bucket
+	 * does, but pick the smallest of those too.
+	 */
+	chunkid_t c = best_fit_in_bucket(h, bi, sz);
+
+	if (c == 0U) {
+		int minbucket = next_avail_bucket(h, bi + 1);
+
+		if (minbucket < 0) {
+			return 0;
+		}
+		bi = minbucket;
+		c = best_fit_in_bucket(h, bi, sz);
+	}
+
+	CHECK(c != 0U && chunk_size(h, c) >= sz);
+	free_list_remove_bidx(h, c, bi);
+	return c;
+#else
+	struct z_heap_bucket *b = &h->buckets[bi];
+
 	/* First try a bounded count of items from the minimal bucket
 	 * size.  These may not fit, trying (e.g.) three means that
 	 * (assuming that chunk sizes are evenly distributed[1]) we
@@ -205,10 +299,9 @@ static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz)
 	/* Otherwise pick the smallest non-empty bucket guaranteed to
 	 * fit and use that unconditionally.
 	 */
-	uint32_t bmask = h->avail_buckets & ~((1 << (bi + 1)) - 1);
+	int minbucket = next_avail_bucket(h, bi + 1);
 
-	if (bmask != 0U) {
-		int minbucket = __builtin_ctz(bmask);
+	if (minbucket >= 0) {
 		chunkid_t c = h->buckets[minbucket].next;
 
 		free_list_remove_bidx(h, c, minbucket);
@@ -217,6 +310,7 @@ static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz)
 	}
 
 	return 0;
+#endif
 }
 
 void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
@@ -377,6 +471,41 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 	return ptr2;
 }
 
+int sys_heap_runtime_stats_get(struct sys_heap *heap,
+			       struct sys_heap_runtime_stats *stats)
+{
+	if (heap == NULL || stats == NULL) {
+		return -EINVAL;
+	}
+
+	struct z_heap *h = heap->heap;
+
+	*stats = (struct sys_heap_runtime_stats) { 0 };
+
+	/* The first and last chunks hold heap metadata */
+	for (chunkid_t c = right_chunk(h, 0); c < h->end_chunk;
+	     c = right_chunk(h, c)) {
+		size_t bytes = chunksz_to_bytes(h, chunk_size(h, c));
+
+		if (chunk_used(h, c)) {
+			stats->allocated_bytes += bytes;
+		} else if (!solo_free_header(h, c)) {
+			stats->free_bytes += bytes;
+			stats->free_chunks++;
+			stats->largest_free_bytes =
+				MAX(stats->largest_free_bytes, bytes);
+		}
+	}
+
+	if (stats->free_bytes != 0U) {
+		stats->fragmentation_pct = 100U -
+			(uint32_t)((100ULL * stats->largest_free_bytes) /
+				   stats->free_bytes);
+	}
+
+	return 0;
+}
+
 void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 {
 	/* Must fit in a 31 bit count of HUNK_UNIT */
@@ -399,13 +528,13 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 	h->end_chunk = heap_sz;
 	h->avail_buckets = 0;
 
-	int nb_buckets = bucket_idx(h, heap_sz) + 1;
+	int nb = nb_buckets(h);
 	chunksz_t chunk0_size = chunksz(sizeof(struct z_heap) +
-				     nb_buckets * sizeof(struct z_heap_bucket));
+				     nb * sizeof(struct z_heap_bucket));
 
 	__ASSERT(chunk0_size + min_chunk_size(h) <= heap_sz, "heap size is too small");
 
-	for (int i = 0; i < nb_buckets; i++) {
+	for (int i = 0; i < nb; i++) {
 		h->buckets[i].next = 0;
 	}
 
@@ -41,9 +41,10 @@
  *   FREE_NEXT: Chunk ID of the next node in a free list.
  *
  * The free lists are circular lists, one for each power-of-two size
- * category.  The free list pointers exist only for free chunks,
- * obviously.  This memory is part of the user's buffer when
- * allocated.
+ * category (or with CONFIG_SYS_HEAP_SEGREGATED_FIT, one for each
+ * quarter of a power-of-two size category).  The free list pointers
+ * exist only for free chunks, obviously.  This memory is part of the
+ * user's buffer when allocated.
  *
  * The field order is so that allocated buffers are immediately bounded
  * by SIZE_AND_USED of the current chunk at the bottom, and LEFT_SIZE of
@@ -61,6 +62,17 @@ typedef struct { char bytes[CHUNK_UNIT]; } chunk_unit_t;
 typedef uint32_t chunkid_t;
 typedef uint32_t chunksz_t;
 
+/* Buckets are split into 1 << BUCKET_SUB_BITS sub-buckets.  The
+ * avail_buckets mask has one bit per group of sub-buckets sharing a
+ * power-of-two size category, so it fits 32 bits either way.
+ */
+#ifdef CONFIG_SYS_HEAP_SEGREGATED_FIT
+#define BUCKET_SUB_BITS 2
+#else
+#define BUCKET_SUB_BITS 0
+#endif
+#define BUCKET_SUBS (1 << BUCKET_SUB_BITS)
+
 struct z_heap_bucket {
 	chunkid_t next;
 };
@@ -239,7 +251,58 @@ static inline size_t chunksz_to_bytes(struct z_heap *h, chunksz_t chunksz_in)
 static inline int bucket_idx(struct z_heap *h, chunksz_t sz)
 {
 	unsigned int usable_sz = sz - min_chunk_size(h) + 1;
-	return 31 - __builtin_clz(usable_sz);
+	int lvl = 31 - __builtin_clz(usable_sz);
+
+	/* Sizes below BUCKET_SUBS each get their own bucket, above
+	 * that the BUCKET_SUB_BITS bits below the top one select the
+	 * sub-bucket.  Without sub-buckets this is just the level.
+	 */
+	if (BUCKET_SUBS > 1 && usable_sz < BUCKET_SUBS) {
+		return usable_sz - 1;
+	}
+	return ((lvl - BUCKET_SUB_BITS + 1) << BUCKET_SUB_BITS) +
+		((usable_sz >> (lvl - BUCKET_SUB_BITS)) & (BUCKET_SUBS - 1)) - 1;
+}
+
+/* Smallest chunk size, in units, stored in a bucket */
+static inline chunksz_t bucket_min_size(struct z_heap *h, int bidx)
+{
+	unsigned int usable_sz;
+
+	if (bidx < BUCKET_SUBS - 1) {
+		usable_sz = bidx + 1;
+	} else {
+		int grp = (bidx + 1) >> BUCKET_SUB_BITS;
+		int sub = (bidx + 1) & (BUCKET_SUBS - 1);
+		int lvl = grp + BUCKET_SUB_BITS - 1;
+
+		usable_sz = (1U << lvl) + (sub << (lvl - BUCKET_SUB_BITS));
+	}
+	return usable_sz + min_chunk_size(h) - 1;
+}
+
+static inline int nb_buckets(struct z_heap *h)
+{
+	return bucket_idx(h, h->end_chunk) + 1;
+}
+
+/* The avail_buckets bit covering a bucket */
+static inline uint32_t bucket_group_bit(int bidx)
+{
+	return 1U << (bidx >> BUCKET_SUB_BITS);
+}
+
+static inline bool bucket_group_empty(struct z_heap *h, int bidx)
+{
+	int first = bidx & ~(BUCKET_SUBS - 1);
+	int end = MIN(first + BUCKET_SUBS, nb_buckets(h));
+
+	for (int b = first; b < end; b++) {
+		if (h->buckets[b].next != 0U) {
+			return false;
+		}
+	}
+	return true;
 }
 
 static inline bool size_too_big(struct z_heap *h, size_t bytes)
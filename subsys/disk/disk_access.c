@@ -13,6 +13,8 @@
 #include <errno.h>
 #include <device.h>
 
+#include "disk_cache.h"
+
 #define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
 #include <logging/log.h>
 LOG_MODULE_REGISTER(disk);
@@ -60,6 +62,12 @@ int disk_access_init(const char *pdrv)
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->init != NULL)) {
+#if defined(CONFIG_DISK_CACHE)
+		rc = disk_cache_drop(disk);
+		if (rc != 0) {
+			return rc;
+		}
+#endif
 		rc = disk->ops->init(disk);
 	}
 
@@ -87,7 +95,11 @@ int disk_access_read(const char *pdrv, uint8_t *data_buf,
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->read != NULL)) {
+#if defined(CONFIG_DISK_CACHE)
+		rc = disk_cache_read(disk, data_buf, start_sector, num_sector);
+#else
 		rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+#endif
 	}
 
 	return rc;
@@ -101,7 +113,11 @@ int disk_access_write(const char *pdrv, const uint8_t *data_buf,
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->write != NULL)) {
+#if defined(CONFIG_DISK_CACHE)
+		rc = disk_cache_write(disk, data_buf, start_sector, num_sector);
+#else
 		rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+#endif
 	}
 
 	return rc;
@@ -114,6 +130,14 @@ int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buf)
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->ioctl != NULL)) {
+#if defined(CONFIG_DISK_CACHE)
+		if (cmd == DISK_IOCTL_CTRL_SYNC) {
+			rc = disk_cache_sync(disk);
+			if (rc != 0) {
+				return rc;
+			}
+		}
+#endif
 		rc = disk->ops->ioctl(disk, cmd, buf);
 	}
 
@@ -161,6 +185,12 @@ int disk_access_unregister(struct disk_info *disk)
 		rc = -EINVAL;
 		goto unreg_err;
 	}
+#if defined(CONFIG_DISK_CACHE)
+	if (disk_cache_drop(disk) != 0) {
+		LOG_WRN("disk interface(%s) cache not written back",
+			disk->name);
+	}
+#endif
 	/* remove disk node from the list */
 	sys_dlist_remove(&disk->node);
 	LOG_DBG("disk interface(%s) unregistred", disk->name);
@@ -169,12 +199,24 @@ unreg_err:
 	return rc;
 }
 
+#if !defined(CONFIG_DISK_CACHE)
+int disk_access_cache_stats(struct disk_cache_stats *stats)
+{
+	ARG_UNUSED(stats);
+
+	return -ENOTSUP;
+}
+#endif
+
 static int disk_init(const struct device *dev)
 {
 	ARG_UNUSED(dev);
 
 	k_mutex_init(&mutex);
 	sys_dlist_init(&disk_access_list);
+#if defined(CONFIG_DISK_CACHE)
+	disk_cache_init();
+#endif
 	return 0;
 }
 
@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <kernel.h>
+#include <sys/dlist.h>
+#include <sys/util.h>
+#include <storage/disk_access.h>
+#include "disk_cache.h"
+
+#define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_DECLARE(disk);
+
+#define BLOCK_SIZE CONFIG_DISK_CACHE_BLOCK_SIZE
+
+/* Largest request done to a driver by the cache */
+#define RUN_SECTORS MIN(CONFIG_DISK_CACHE_READ_AHEAD + 1, \
+			CONFIG_DISK_CACHE_BLOCKS)
+
+/* Requests above this size are not worth caching */
+#define BYPASS_SECTORS (CONFIG_DISK_CACHE_BLOCKS / 2)
+
+struct disk_cache_block {
+	sys_dnode_t node;
+	/* NULL when the block holds no sector */
+	struct disk_info *disk;
+	uint32_t sector;
+	bool dirty;
+	uint8_t data[BLOCK_SIZE] __aligned(4);
+};
+
+static struct disk_cache_block blocks[CONFIG_DISK_CACHE_BLOCKS];
+/* Buffer for the multi-sector requests done to the drivers */
+static uint8_t stage[RUN_SECTORS * BLOCK_SIZE] __aligned(4);
+
+/* Blocks ordered from the most to the least recently used */
+static sys_dlist_t lru;
+static K_MUTEX_DEFINE(cache_lock);
+static struct disk_cache_stats stats;
+
+/* Sequential reader detection */
+static struct disk_info *seq_disk;
+static uint32_t seq_next;
+
+static bool cache_usable(struct disk_info *disk)
+{
+	uint32_t sector_size;
+
+	if (disk->ops->ioctl == NULL ||
+	    disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_SIZE,
+			     &sector_size) != 0) {
+		return false;
+	}
+
+	return sector_size == BLOCK_SIZE;
+}
+
+static struct disk_cache_block *cache_find(struct disk_info *disk,
+					   uint32_t sector)
+{
+	struct disk_cache_block *blk;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&lru, blk, node) {
+		if (blk->disk == disk && blk->sector == sector) {
+			return blk;
+		}
+	}
+
+	return NULL;
+}
+
+static void cache_touch(struct disk_cache_block *blk)
+{
+	sys_dlist_remove(&blk->node);
+	sys_dlist_prepend(&lru, &blk->node);
+}
+
+static void cache_forget(struct disk_cache_block *blk)
+{
+	blk->disk = NULL;
+	blk->dirty = false;
+	sys_dlist_remove(&blk->node);
+	sys_dlist_append(&lru, &blk->node);
+}
+
+/*
+ * Write the dirty blocks of a disk back, lowest sector first, merging
+ * adjacent dirty sectors into a single driver request.
+ */
+static int cache_write_back(struct disk_info *disk)
+{
+	struct disk_cache_block *blk, *first;
+	uint32_t count;
+	int rc;
+
+	while (true) {
+		first = NULL;
+		SYS_DLIST_FOR_EACH_CONTAINER(&lru, blk, node) {
+			if (blk->disk == disk && blk->dirty &&
+			    (first == NULL || blk->sector < first->sector)) {
+				first = blk;
+			}
+		}
+
+		if (first == NULL) {
+			return 0;
+		}
+
+		count = 0U;
+		blk = first;
+		do {
+			memcpy(&stage[count * BLOCK_SIZE], blk->data,
+			       BLOCK_SIZE);
+			count++;
+			blk = cache_find(disk, first->sector + count);
+		} while (count < RUN_SECTORS && blk != NULL && blk->dirty);
+
+		rc = disk->ops->write(disk, stage, first->sector, count);
+		stats.disk_writes++;
+		if (rc != 0) {
+			LOG_ERR("write back of sector %u failed (%d)",
+				first->sector, rc);
+			return rc;
+		}
+		stats.write_backs += count;
+
+		for (uint32_t i = 0U; i < count; i++) {
+			cache_find(disk, first->sector + i)->dirty = false;
+		}
+	}
+}
+
+/*
+ * Take the least recently used block for a new sector. The block is moved
+ * to the head of the list with no sector, so that the following calls pick
+ * other blocks.
+ */
+static struct disk_cache_block *cache_alloc(int *rc)
+{
+	struct disk_cache_block *blk;
+
+	blk = SYS_DLIST_CONTAINER(sys_dlist_peek_tail(&lru), blk, node);
+	if (blk->dirty) {
+		*rc = cache_write_back(blk->disk);
+		if (*rc != 0) {
+			return NULL;
+		}
+	}
+
+	blk->disk = NULL;
+	cache_touch(blk);
+
+	return blk;
+}
+
+/* Read count sectors starting at sector, which are all missing */
+static int cache_fill(struct disk_info *disk, uint32_t sector,
+		      uint32_t count)
+{
+	struct disk_cache_block *run[RUN_SECTORS];
+	uint32_t i;
+	int rc = 0;
+
+	for (i = 0U; i < count; i++) {
+		run[i] = cache_alloc(&rc);
+		if (run[i] == NULL) {
+			break;
+		}
+	}
+
+	if (rc == 0) {
+		rc = disk->ops->read(disk, stage, sector, count);
+		stats.disk_reads++;
+	}
+
+	if (rc != 0) {
+		while (i-- > 0U) {
+			cache_forget(run[i]);
+		}
+		return rc;
+	}
+
+	for (i = 0U; i < count; i++) {
+		memcpy(run[i]->data, &stage[i * BLOCK_SIZE], BLOCK_SIZE);
+		run[i]->sector = sector + i;
+		run[i]->disk = disk;
+	}
+
+	return 0;
+}
+
+/* Number of uncached sectors that can be read ahead after sector */
+static uint32_t cache_read_ahead(struct disk_info *disk, uint32_t sector,
+				 uint32_t max)
+{
+	uint32_t sector_count;
+	uint32_t count = 0U;
+
+	if (disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_COUNT,
+			     &sector_count) != 0) {
+		return 0U;
+	}
+
+	while (count < max && sector + count < sector_count &&
+	       cache_find(disk, sector + count) == NULL) {
+		count++;
+	}
+
+	return count;
+}
+
+static int cache_read(struct disk_info *disk, uint8_t *data_buf,
+		      uint32_t start_sector, uint32_t num_sector)
+{
+	struct disk_cache_block *blk;
+	bool sequential;
+	uint32_t end = start_sector + num_sector;
+	uint32_t sector = start_sector;
+	uint32_t count, extra;
+	int rc;
+
+	sequential = (seq_disk == disk && seq_next == start_sector);
+	seq_disk = disk;
+	seq_next = end;
+
+	if (num_sector > BYPASS_SECTORS) {
+		rc = cache_write_back(disk);
+		if (rc == 0) {
+			rc = disk->ops->read(disk, data_buf, start_sector,
+					     num_sector);
+			stats.disk_reads++;
+			stats.misses += num_sector;
+		}
+		return rc;
+	}
+
+	while (sector < end) {
+		blk = cache_find(disk, sector);
+		if (blk != NULL) {
+			memcpy(data_buf, blk->data, BLOCK_SIZE);
+			cache_touch(blk);
+			stats.hits++;
+			data_buf += BLOCK_SIZE;
+			sector++;
+			continue;
+		}
+
+		count = 1U;
+		while (sector + count < end && count < RUN_SECTORS &&
+		       cache_find(disk, sector + count) == NULL) {
+			count++;
+		}
+
+		extra = 0U;
+		if (sequential && sector + count == end &&
+		    count < RUN_SECTORS) {
+			extra = cache_read_ahead(disk, end,
+						 RUN_SECTORS - count);
+		}
+
+		rc = cache_fill(disk, sector, count + extra);
+		if (rc != 0) {
+			return rc;
+		}
+		stats.misses += count;
+		stats.read_ahead += extra;
+
+		memcpy(data_buf, stage, count * BLOCK_SIZE);
+		data_buf += count * BLOCK_SIZE;
+		sector += count;
+	}
+
+	return 0;
+}
+
+static int cache_write(struct disk_info *disk, const uint8_t *data_buf,
+		       uint32_t start_sector, uint32_t num_sector)
+{
+	struct disk_cache_block *blk;
+	uint32_t i;
+	int rc = 0;
+
+	if (!IS_ENABLED(CONFIG_DISK_CACHE_WRITE_BACK) ||
+	    num_sector > BYPASS_SECTORS) {
+		rc = disk->ops->write(disk, data_buf, start_sector,
+				      num_sector);
+		stats.disk_writes++;
+		if (rc != 0) {
+			return rc;
+		}
+
+		/* Refresh the cached copies, now matching the disk */
+		for (i = 0U; i < num_sector; i++) {
+			blk = cache_find(disk, start_sector + i);
+			if (blk != NULL) {
+				memcpy(blk->data, &data_buf[i * BLOCK_SIZE],
+				       BLOCK_SIZE);
+				blk->dirty = false;
+			}
+		}
+
+		return 0;
+	}
+
+	for (i = 0U; i < num_sector; i++) {
+		blk = cache_find(disk, start_sector + i);
+		if (blk == NULL) {
+			blk = cache_alloc(&rc);
+			if (blk == NULL) {
+				return rc;
+			}
+			blk->sector = start_sector + i;
+			blk->disk = disk;
+		}
+
+		memcpy(blk->data, &data_buf[i * BLOCK_SIZE], BLOCK_SIZE);
+		blk->dirty = true;
+		cache_touch(blk);
+		stats.writes++;
+	}
+
+	return 0;
+}
+
+int disk_cache_read(struct disk_info *disk, uint8_t *data_buf,
+		    uint32_t start_sector, uint32_t num_sector)
+{
+	int rc;
+
+	if (!cache_usable(disk)) {
+		return disk->ops->read(disk, data_buf, start_sector,
+				       num_sector);
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	rc = cache_read(disk, data_buf, start_sector, num_sector);
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+int disk_cache_write(struct disk_info *disk, const uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	int rc;
+
+	if (!cache_usable(disk)) {
+		return disk->ops->write(disk, data_buf, start_sector,
+					num_sector);
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	rc = cache_write(disk, data_buf, start_sector, num_sector);
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+int disk_cache_sync(struct disk_info *disk)
+{
+	int rc;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	rc = cache_write_back(disk);
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+int disk_cache_drop(struct disk_info *disk)
+{
+	struct disk_cache_block *blk, *next;
+	int rc;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	rc = cache_write_back(disk);
+	if (rc == 0) {
+		SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&lru, blk, next, node) {
+			if (blk->disk == disk) {
+				cache_forget(blk);
+			}
+		}
+	}
+
+	if (seq_disk == disk) {
+		seq_disk = NULL;
+	}
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+void disk_cache_init(void)
+{
+	sys_dlist_init(&lru);
+	for (size_t i = 0; i < ARRAY_SIZE(blocks); i++) {
+		sys_dlist_append(&lru, &blocks[i].node);
+	}
+}
+
+int disk_access_cache_stats(struct disk_cache_stats *out)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	*out = stats;
+	k_mutex_unlock(&cache_lock);
+
+	return 0;
+}
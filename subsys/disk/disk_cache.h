@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_
+#define ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_
+
+#include <drivers/disk.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void disk_cache_init(void);
+
+int disk_cache_read(struct disk_info *disk, uint8_t *data_buf,
+		    uint32_t start_sector, uint32_t num_sector);
+
+int disk_cache_write(struct disk_info *disk, const uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector);
+
+/* Write back the dirty sectors of a disk */
+int disk_cache_sync(struct disk_info *disk);
+
+/* Write back and forget the sectors of a disk */
+int disk_cache_drop(struct disk_info *disk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_ */
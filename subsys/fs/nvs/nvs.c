@@ -10,6 +10,7 @@
 #include <errno.h>
 #include <inttypes.h>
 #include <fs/nvs.h>
+#include <init.h>
 #include <sys/crc.h>
 #include "nvs_priv.h"
 
@@ -27,6 +28,31 @@ static inline size_t nvs_al_size(struct nvs_fs *fs, size_t len)
 	}
 	return (len + (write_block_size - 1U)) & ~(write_block_size - 1U);
 }
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* nvs_lookup_cache_pos returns the lookup cache slot of an id. Ids are
+ * usually allocated in sequence, so a plain modulo keeps them apart.
+ */
+static inline size_t nvs_lookup_cache_pos(uint16_t id)
+{
+	return id % CONFIG_NVS_LOOKUP_CACHE_SIZE;
+}
+
+/* Drop the slots pointing into an erased sector. Another id of the same
+ * slot can still live in an older sector, so such a slot restarts from the
+ * current write position: any later ate for the slot overwrites it, and
+ * the walk from there still reaches every older ate.
+ */
+static void nvs_lookup_cache_invalidate(struct nvs_fs *fs, uint32_t sector)
+{
+	for (size_t i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		if ((fs->lookup_cache[i] != NVS_LOOKUP_CACHE_NO_ADDR) &&
+		    ((fs->lookup_cache[i] >> ADDR_SECT_SHIFT) == sector)) {
+			fs->lookup_cache[i] = fs->ate_wra;
+		}
+	}
+}
+#endif
 /* end basic routines */
 
 /* flash routines */
@@ -96,6 +122,12 @@ static int nvs_flash_ate_wrt(struct nvs_fs *fs, const struct nvs_ate *entry)
 
 	rc = nvs_flash_al_wrt(fs, fs->ate_wra, entry,
 			       sizeof(struct nvs_ate));
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	/* id 0xFFFF is reserved for the close and gc done ates */
+	if (!rc && (entry->id != 0xFFFF)) {
+		fs->lookup_cache[nvs_lookup_cache_pos(entry->id)] = fs->ate_wra;
+	}
+#endif
 	fs->ate_wra -= nvs_al_size(fs, sizeof(struct nvs_ate));
 
 	return rc;
@@ -227,6 +259,10 @@ static int nvs_flash_erase_sector(struct nvs_fs *fs, uint32_t addr)
 		fs->sector_size);
 	rc = flash_erase(fs->flash_device, offset, fs->sector_size);
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	nvs_lookup_cache_invalidate(fs, addr >> ADDR_SECT_SHIFT);
+#endif
+
 	if (rc) {
 		return rc;
 	}
@@ -617,6 +653,105 @@ gc_done:
 	return 0;
 }
 
+#ifdef CONFIG_NVS_BACKGROUND_GC
+static struct k_work_q nvs_gc_work_q;
+static K_KERNEL_STACK_DEFINE(nvs_gc_stack, CONFIG_NVS_BACKGROUND_GC_STACK_SIZE);
+
+/* nvs_gc_below_threshold returns true when the free space in the active
+ * sector calls for a background gc
+ */
+static bool nvs_gc_below_threshold(struct nvs_fs *fs)
+{
+	return (fs->ate_wra - fs->data_wra) <
+	       ((uint32_t)fs->sector_size * CONFIG_NVS_BACKGROUND_GC_THRESHOLD /
+		100U);
+}
+
+/* Close the active sector before it is full: the gc of the next sector then
+ * runs here instead of in the write that would not fit.
+ */
+static void nvs_gc_work_handler(struct k_work *work)
+{
+	struct nvs_fs *fs = CONTAINER_OF(work, struct nvs_fs, gc_work);
+	int rc;
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	/* a write may have moved to another sector meanwhile */
+	if ((!fs->ready) ||
+	    (fs->gc_sector != (fs->ate_wra >> ADDR_SECT_SHIFT)) ||
+	    (!nvs_gc_below_threshold(fs))) {
+		goto end;
+	}
+
+	rc = nvs_sector_close(fs);
+	if (!rc) {
+		rc = nvs_gc(fs);
+	}
+
+	if (rc) {
+		LOG_ERR("Background gc failed: %d", rc);
+	}
+
+end:
+	k_mutex_unlock(&fs->nvs_lock);
+}
+
+static int nvs_gc_work_q_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_queue_start(&nvs_gc_work_q, nvs_gc_stack,
+			   K_KERNEL_STACK_SIZEOF(nvs_gc_stack),
+			   K_PRIO_PREEMPT(CONFIG_NUM_PREEMPT_PRIORITIES - 1),
+			   NULL);
+	k_thread_name_set(&nvs_gc_work_q.thread, "nvs_gc");
+
+	return 0;
+}
+
+SYS_INIT(nvs_gc_work_q_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* fill the lookup cache by walking once through all the ates, from newest
+ * to oldest: the first valid ate found for a slot is the most recent one.
+ */
+static int nvs_lookup_cache_rebuild(struct nvs_fs *fs)
+{
+	int rc;
+	uint32_t addr, ate_addr;
+	uint32_t *cache_entry;
+	struct nvs_ate ate;
+
+	(void)memset(fs->lookup_cache, 0xff, sizeof(fs->lookup_cache));
+	addr = fs->ate_wra;
+
+	while (1) {
+		/* nvs_prev_ate moves addr to the previous ate */
+		ate_addr = addr;
+		rc = nvs_prev_ate(fs, &addr, &ate);
+		if (rc) {
+			return rc;
+		}
+
+		cache_entry = &fs->lookup_cache[nvs_lookup_cache_pos(ate.id)];
+
+		if ((ate.id != 0xFFFF) &&
+		    (*cache_entry == NVS_LOOKUP_CACHE_NO_ADDR) &&
+		    nvs_ate_valid(fs, &ate)) {
+			*cache_entry = ate_addr;
+		}
+
+		if (addr == fs->ate_wra) {
+			break;
+		}
+	}
+
+	return 0;
+}
+#endif
+
 static int nvs_startup(struct nvs_fs *fs)
 {
 	int rc;
@@ -819,6 +954,13 @@ end:
 
 		rc = nvs_add_gc_done_ate(fs);
 	}
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	if (!rc) {
+		rc = nvs_lookup_cache_rebuild(fs);
+	}
+#endif
+
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
 }
@@ -827,12 +969,19 @@ int nvs_clear(struct nvs_fs *fs)
 {
 	int rc;
 	uint32_t addr;
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	struct k_work_sync sync;
+#endif
 
 	if (!fs->ready) {
 		LOG_ERR("NVS not initialized");
 		return -EACCES;
 	}
 
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	(void)k_work_cancel_sync(&fs->gc_work, &sync);
+#endif
+
 	for (uint16_t i = 0; i < fs->sector_count; i++) {
 		addr = i << ADDR_SECT_SHIFT;
 		rc = nvs_flash_erase_sector(fs, addr);
@@ -850,6 +999,20 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name)
 	struct flash_pages_info info;
 	size_t write_block_size;
 
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	struct k_work_sync sync;
+
+	/* the file system may be mounted again with gc work still pending,
+	 * the work item of a file system that was never mounted is zeroed
+	 */
+	if (k_work_busy_get(&fs->gc_work) != 0) {
+		(void)k_work_cancel_sync(&fs->gc_work, &sync);
+	}
+	k_work_init(&fs->gc_work, nvs_gc_work_handler);
+#endif
+
+	fs->ready = false;
+
 	k_mutex_init(&fs->nvs_lock);
 
 	fs->flash_device = device_get_binding(dev_name);
@@ -916,6 +1079,9 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	uint32_t wlk_addr, rd_addr;
 	uint16_t required_space = 0U; /* no space, appropriate for delete ate */
 	bool prev_found = false;
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	bool gc_armed;
+#endif
 
 	if (!fs->ready) {
 		LOG_ERR("NVS not initialized");
@@ -935,7 +1101,16 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	}
 
 	/* find latest entry with same id */
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	/* no newer ate can have this id */
+	wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
+
+	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+		goto no_cached_entry;
+	}
+#else
 	wlk_addr = fs->ate_wra;
+#endif
 	rd_addr = wlk_addr;
 
 	while (1) {
@@ -953,6 +1128,10 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		}
 	}
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+no_cached_entry:
+#endif
+
 	if (prev_found) {
 		/* previous entry found */
 		rd_addr &= ADDR_SECT_MASK;
@@ -1000,11 +1179,25 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		}
 
 		if (fs->ate_wra >= (fs->data_wra + required_space)) {
+#ifdef CONFIG_NVS_BACKGROUND_GC
+			/* only the write crossing the threshold requests a
+			 * background gc
+			 */
+			gc_armed = !nvs_gc_below_threshold(fs);
+#endif
 
 			rc = nvs_flash_wrt_entry(fs, id, data, len);
 			if (rc) {
 				goto end;
 			}
+
+#ifdef CONFIG_NVS_BACKGROUND_GC
+			if (gc_armed && nvs_gc_below_threshold(fs)) {
+				fs->gc_sector = fs->ate_wra >> ADDR_SECT_SHIFT;
+				(void)k_work_submit_to_queue(&nvs_gc_work_q,
+							     &fs->gc_work);
+			}
+#endif
 			break;
 		}
 
@@ -1053,7 +1246,16 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 
 	cnt_his = 0U;
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
+
+	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+		rc = -ENOENT;
+		goto err;
+	}
+#else
 	wlk_addr = fs->ate_wra;
+#endif
 	rd_addr = wlk_addr;
 
 	while (cnt_his <= cnt) {
@@ -16,6 +16,10 @@
 #include <limits.h>
 
 /* FAT */
+#if defined(CONFIG_DISK_CACHE)
+#include <storage/disk_access.h>
+#endif
+
 #ifdef CONFIG_FAT_FILESYSTEM_ELM
 #include <ff.h>
 #define FATFS_MNTP      "/RAM:"
@@ -409,6 +413,31 @@ static int cmd_statvfs(const struct shell *shell, size_t argc, char **argv)
 	return 0;
 }
 
+#if defined(CONFIG_DISK_CACHE)
+static int cmd_cache(const struct shell *shell, size_t argc, char **argv)
+{
+	struct disk_cache_stats stats;
+	uint32_t reads;
+
+	disk_access_cache_stats(&stats);
+	reads = stats.hits + stats.misses;
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "hits %u, misses %u (%u%% hit), read ahead %u\n",
+		      stats.hits, stats.misses,
+		      reads ? (stats.hits * 100U / reads) : 0U,
+		      stats.read_ahead);
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "writes %u, write backs %u\n",
+		      stats.writes, stats.write_backs);
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "disk reads %u, disk writes %u\n",
+		      stats.disk_reads, stats.disk_writes);
+
+	return 0;
+}
+#endif
+
 static int cmd_write(const struct shell *shell, size_t argc, char **argv)
 {
 	char path[MAX_PATH_LEN];
@@ -564,6 +593,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_fs_mount,
 #endif
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_fs,
+#if defined(CONFIG_DISK_CACHE)
+	SHELL_CMD(cache, NULL, "Show disk cache statistics", cmd_cache),
+#endif
 	SHELL_CMD(cd, NULL, "Change working directory", cmd_cd),
 	SHELL_CMD(ls, NULL, "List files in current directory", cmd_ls),
 	SHELL_CMD_ARG(mkdir, NULL, "Create directory", cmd_mkdir, 2, 0),
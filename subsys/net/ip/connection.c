@@ -54,11 +54,26 @@ LOG_MODULE_REGISTER(net_conn, CONFIG_NET_CONN_LOG_LEVEL);
 
 #define NET_CONN_RANK(_flags)		(_flags & 0x78)
 
+/** Both addresses and both ports specified */
+#define NET_CONN_EXACT			(NET_CONN_REMOTE_ADDR_SPEC | \
+					 NET_CONN_LOCAL_ADDR_SPEC | \
+					 NET_CONN_REMOTE_PORT_SPEC | \
+					 NET_CONN_LOCAL_PORT_SPEC)
+
 static struct net_conn conns[CONFIG_NET_MAX_CONN];
 
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+#if defined(CONFIG_NET_CONN_HASH)
+/* Fully specified connections, hashed on the 5-tuple. Everything else
+ * lives in conn_wildcard. Both are linked through lookup_node and keep
+ * the same newest-first order as conn_used.
+ */
+static sys_slist_t conn_hash_table[CONFIG_NET_CONN_HASH_BUCKETS];
+static sys_slist_t conn_wildcard;
+#endif
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -127,11 +142,191 @@ static struct net_conn *conn_get_unused(void)
 	return CONTAINER_OF(node, struct net_conn, node);
 }
 
+#if defined(CONFIG_NET_CONN_HASH)
+static const uint8_t *conn_addr_bytes(const struct sockaddr *addr)
+{
+	if (IS_ENABLED(CONFIG_NET_IPV6) && addr->sa_family == AF_INET6) {
+		return net_sin6(addr)->sin6_addr.s6_addr;
+	}
+
+	return net_sin(addr)->sin_addr.s4_addr;
+}
+
+/* Ports are in network byte order. The addresses may come from a packed
+ * IP header so they are read without assuming any alignment.
+ */
+static uint32_t conn_hash(uint16_t proto, uint8_t family,
+			  const uint8_t *remote, const uint8_t *local,
+			  uint16_t remote_port, uint16_t local_port)
+{
+	size_t len = family == AF_INET6 ? sizeof(struct in6_addr) :
+					  sizeof(struct in_addr);
+	uint32_t hash = ((uint32_t)remote_port << 16 | local_port) ^ proto;
+	size_t i;
+
+	for (i = 0; i < len; i += sizeof(uint32_t)) {
+		hash = (hash ^ UNALIGNED_GET((const uint32_t *)&remote[i])) *
+			0x9e3779b1U;
+		hash = (hash ^ UNALIGNED_GET((const uint32_t *)&local[i])) *
+			0x9e3779b1U;
+	}
+
+	return hash ^ (hash >> 16);
+}
+
+static bool conn_is_exact(struct net_conn *conn)
+{
+	return (conn->flags & NET_CONN_EXACT) == NET_CONN_EXACT &&
+		conn->remote_addr.sa_family == conn->family &&
+		conn->local_addr.sa_family == conn->family;
+}
+
+static sys_slist_t *conn_lookup_list(struct net_conn *conn)
+{
+	if (!conn_is_exact(conn)) {
+		return &conn_wildcard;
+	}
+
+	return &conn_hash_table[conn->hash % CONFIG_NET_CONN_HASH_BUCKETS];
+}
+
+/* Return the list a connection identical to the given one would be in */
+static sys_slist_t *conn_find_list(uint16_t proto, uint8_t family,
+				   const struct sockaddr *remote_addr,
+				   const struct sockaddr *local_addr,
+				   uint16_t remote_port,
+				   uint16_t local_port)
+{
+	uint32_t hash;
+
+	if (!remote_addr || !local_addr || !remote_port || !local_port ||
+	    remote_addr->sa_family != family ||
+	    local_addr->sa_family != family) {
+		return &conn_wildcard;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6) {
+		if (net_ipv6_is_addr_unspecified(
+			    &net_sin6(remote_addr)->sin6_addr) ||
+		    net_ipv6_is_addr_unspecified(
+			    &net_sin6(local_addr)->sin6_addr)) {
+			return &conn_wildcard;
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) && family == AF_INET) {
+		if (!net_sin(remote_addr)->sin_addr.s_addr ||
+		    !net_sin(local_addr)->sin_addr.s_addr) {
+			return &conn_wildcard;
+		}
+	} else {
+		return &conn_wildcard;
+	}
+
+	hash = conn_hash(proto, family, conn_addr_bytes(remote_addr),
+			 conn_addr_bytes(local_addr), htons(remote_port),
+			 htons(local_port));
+
+	return &conn_hash_table[hash % CONFIG_NET_CONN_HASH_BUCKETS];
+}
+
+/* Exact 5-tuple match for a unicast UDP or TCP packet */
+static struct net_conn *conn_hash_lookup(struct net_pkt *pkt,
+					 union net_ip_header *ip_hdr,
+					 uint8_t proto,
+					 uint16_t src_port,
+					 uint16_t dst_port)
+{
+	uint8_t family = net_pkt_family(pkt);
+	const uint8_t *remote, *local;
+	struct net_conn *conn;
+	uint32_t hash;
+	size_t len;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6) {
+		remote = ip_hdr->ipv6->src.s6_addr;
+		local = ip_hdr->ipv6->dst.s6_addr;
+		len = sizeof(struct in6_addr);
+	} else {
+		remote = ip_hdr->ipv4->src.s4_addr;
+		local = ip_hdr->ipv4->dst.s4_addr;
+		len = sizeof(struct in_addr);
+	}
+
+	hash = conn_hash(proto, family, remote, local, src_port, dst_port);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(
+		&conn_hash_table[hash % CONFIG_NET_CONN_HASH_BUCKETS],
+		conn, lookup_node) {
+		if (conn->hash != hash || conn->proto != proto ||
+		    conn->family != family) {
+			continue;
+		}
+
+		if (net_sin(&conn->remote_addr)->sin_port != src_port ||
+		    net_sin(&conn->local_addr)->sin_port != dst_port) {
+			continue;
+		}
+
+		if (memcmp(conn_addr_bytes(&conn->remote_addr), remote, len) ||
+		    memcmp(conn_addr_bytes(&conn->local_addr), local, len)) {
+			continue;
+		}
+
+		if (conn->context != NULL &&
+		    net_context_is_bound_to_iface(conn->context) &&
+		    net_pkt_iface(pkt) != net_context_get_iface(conn->context)) {
+			continue;
+		}
+
+		return conn;
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_NET_CONN_HASH */
+
+/* Walk conn_used, or a lookup list when one is given */
+static inline struct net_conn *conn_first(sys_slist_t *lookup)
+{
+	struct net_conn *conn = NULL;
+
+#if defined(CONFIG_NET_CONN_HASH)
+	if (lookup) {
+		return SYS_SLIST_PEEK_HEAD_CONTAINER(lookup, conn, lookup_node);
+	}
+#endif
+
+	return SYS_SLIST_PEEK_HEAD_CONTAINER(&conn_used, conn, node);
+}
+
+static inline struct net_conn *conn_next(struct net_conn *conn,
+					 sys_slist_t *lookup)
+{
+#if defined(CONFIG_NET_CONN_HASH)
+	if (lookup) {
+		return SYS_SLIST_PEEK_NEXT_CONTAINER(conn, lookup_node);
+	}
+#endif
+
+	return SYS_SLIST_PEEK_NEXT_CONTAINER(conn, node);
+}
+
 static void conn_set_used(struct net_conn *conn)
 {
 	conn->flags |= NET_CONN_IN_USE;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+
+#if defined(CONFIG_NET_CONN_HASH)
+	if (conn_is_exact(conn)) {
+		conn->hash = conn_hash(conn->proto, conn->family,
+				       conn_addr_bytes(&conn->remote_addr),
+				       conn_addr_bytes(&conn->local_addr),
+				       net_sin(&conn->remote_addr)->sin_port,
+				       net_sin(&conn->local_addr)->sin_port);
+	}
+
+	sys_slist_prepend(conn_lookup_list(conn), &conn->lookup_node);
+#endif
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -148,10 +343,15 @@ static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
 					  uint16_t remote_port,
 					  uint16_t local_port)
 {
+	sys_slist_t *lookup = NULL;
 	struct net_conn *conn;
-	struct net_conn *tmp;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&conn_used, conn, tmp, node) {
+#if defined(CONFIG_NET_CONN_HASH)
+	lookup = conn_find_list(proto, family, remote_addr, local_addr,
+				remote_port, local_port);
+#endif
+
+	for (conn = conn_first(lookup); conn; conn = conn_next(conn, lookup)) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -381,6 +581,10 @@ int net_conn_unregister(struct net_conn_handle *handle)
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
 
+#if defined(CONFIG_NET_CONN_HASH)
+	sys_slist_find_and_remove(conn_lookup_list(conn), &conn->lookup_node);
+#endif
+
 	conn_set_unused(conn);
 
 	return 0;
@@ -558,6 +762,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	bool raw_pkt_delivered = false;
 	bool raw_pkt_continue = false;
 	int16_t best_rank = -1;
+	sys_slist_t *lookup = NULL;
 	struct net_conn *conn;
 	enum net_verdict ret;
 	uint16_t src_port;
@@ -623,7 +828,25 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+#if defined(CONFIG_NET_CONN_HASH)
+	/* A fully specified connection always has the highest rank, so a
+	 * hit in the hash table is the best match for a unicast packet.
+	 * Otherwise only the wildcard connections can match.
+	 */
+	if (!is_mcast_pkt && !is_bcast_pkt &&
+	    ((IS_ENABLED(CONFIG_NET_UDP) && proto == IPPROTO_UDP) ||
+	     (IS_ENABLED(CONFIG_NET_TCP) && proto == IPPROTO_TCP)) &&
+	    ((IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) ||
+	     (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET))) {
+		best_match = conn_hash_lookup(pkt, ip_hdr, proto, src_port,
+					      dst_port);
+		lookup = &conn_wildcard;
+	}
+#endif
+
+	conn = best_match ? NULL : conn_first(lookup);
+
+	for (; conn; conn = conn_next(conn, lookup)) {
 		if (conn->context != NULL &&
 		    net_context_is_bound_to_iface(conn->context) &&
 		    net_pkt_iface(pkt) != net_context_get_iface(conn->context)) {
@@ -856,6 +1079,14 @@ void net_conn_init(void)
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
 
+#if defined(CONFIG_NET_CONN_HASH)
+	sys_slist_init(&conn_wildcard);
+
+	for (i = 0; i < CONFIG_NET_CONN_HASH_BUCKETS; i++) {
+		sys_slist_init(&conn_hash_table[i]);
+	}
+#endif
+
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
 	}
@@ -51,6 +51,14 @@ struct net_conn {
 	/** Internal slist node */
 	sys_snode_t node;
 
+#if defined(CONFIG_NET_CONN_HASH)
+	/** Node in the hash bucket or the wildcard list */
+	sys_snode_t lookup_node;
+
+	/** Hash of the 5-tuple, only valid for fully specified connections */
+	uint32_t hash;
+#endif
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
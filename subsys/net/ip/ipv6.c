@@ -471,6 +471,19 @@ enum net_verdict net_ipv6_input(struct net_pkt *pkt, bool is_loopback)
 	net_pkt_set_ipv6_hop_limit(pkt, NET_IPV6_HDR(pkt)->hop_limit);
 	net_pkt_set_family(pkt, PF_INET6);
 
+	if (IS_ENABLED(CONFIG_NET_ROUTE_FLOW_CACHE) && !is_loopback) {
+		/* Packets of an already forwarded flow skip the address and
+		 * route lookups.
+		 */
+		enum net_verdict fwd = net_route_flow_forward(pkt, hdr);
+
+		if (fwd == NET_OK) {
+			return NET_OK;
+		} else if (fwd == NET_DROP) {
+			goto drop;
+		}
+	}
+
 	if (IS_ENABLED(CONFIG_NET_ROUTE_MCAST) &&
 		net_ipv6_is_addr_mcast(&hdr->dst)) {
 		/* If the packet is a multicast packet and multicast routing
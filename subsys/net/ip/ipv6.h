@@ -80,6 +80,11 @@ const char *net_ipv6_nbr_state2str(enum net_ipv6_nbr_state state);
  * @brief IPv6 neighbor information.
  */
 struct net_ipv6_nbr_data {
+#if defined(CONFIG_NET_IPV6_NBR_CACHE)
+	/** Node in the neighbor address hash. */
+	sys_snode_t hash_node;
+#endif
+
 	/** Any pending packet waiting ND to finish. */
 	struct net_pkt *pending;
 
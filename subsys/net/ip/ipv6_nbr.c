@@ -137,6 +137,39 @@ static inline struct net_nbr *get_nbr_from_data(struct net_ipv6_nbr_data *data)
 	return NULL;
 }
 
+/* The neighbors are also hashed by IPv6 address, so that the lookup done for
+ * every sent packet does not need to go through the whole table.
+ */
+#define NBR_HASH_SIZE CONFIG_NET_IPV6_MAX_NEIGHBORS
+
+static sys_slist_t nbr_hash[NBR_HASH_SIZE];
+
+static inline sys_slist_t *nbr_hash_bucket(const struct in6_addr *addr)
+{
+	uint32_t hash = UNALIGNED_GET(&addr->s6_addr32[0]) ^
+			UNALIGNED_GET(&addr->s6_addr32[1]) ^
+			UNALIGNED_GET(&addr->s6_addr32[2]) ^
+			UNALIGNED_GET(&addr->s6_addr32[3]);
+
+	/* Multiplicative hashing mixes all the bits into the upper ones */
+	return &nbr_hash[((hash * 2654435769U) >> 16) % NBR_HASH_SIZE];
+}
+
+static inline void nbr_hash_add(struct net_nbr *nbr)
+{
+	struct net_ipv6_nbr_data *data = net_ipv6_nbr_data(nbr);
+
+	sys_slist_prepend(nbr_hash_bucket(&data->addr), &data->hash_node);
+}
+
+static inline void nbr_hash_del(struct net_nbr *nbr)
+{
+	struct net_ipv6_nbr_data *data = net_ipv6_nbr_data(nbr);
+
+	sys_slist_find_and_remove(nbr_hash_bucket(&data->addr),
+				  &data->hash_node);
+}
+
 static void ipv6_nbr_set_state(struct net_nbr *nbr,
 			       enum net_ipv6_nbr_state new_state)
 {
@@ -259,10 +292,10 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  const struct in6_addr *addr)
 {
-	int i;
+	struct net_ipv6_nbr_data *data;
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	SYS_SLIST_FOR_EACH_CONTAINER(nbr_hash_bucket(addr), data, hash_node) {
+		struct net_nbr *nbr = CONTAINER_OF(data, struct net_nbr, __nbr);
 
 		if (!nbr->ref) {
 			continue;
@@ -272,7 +305,7 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 			continue;
 		}
 
-		if (net_ipv6_addr_cmp(&net_ipv6_nbr_data(nbr)->addr, addr)) {
+		if (net_ipv6_addr_cmp(&data->addr, addr)) {
 			return nbr;
 		}
 	}
@@ -417,6 +450,8 @@ static void nbr_init(struct net_nbr *nbr, struct net_if *iface,
 	net_ipv6_nbr_data(nbr)->reachable = 0;
 	net_ipv6_nbr_data(nbr)->reachable_timeout = 0;
 #endif
+
+	nbr_hash_add(nbr);
 }
 
 static struct net_nbr *nbr_new(struct net_if *iface,
@@ -653,7 +688,7 @@ void net_neighbor_data_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Neighbor %p removed", nbr);
 
-	return;
+	nbr_hash_del(nbr);
 }
 
 void net_neighbor_table_clear(struct net_nbr_table *table)
@@ -787,9 +822,10 @@ enum net_verdict net_ipv6_prepare_for_send(struct net_pkt *pkt)
 
 #if defined(CONFIG_NET_IPV6_FRAGMENT)
 	/* If we have already fragmented the packet, the fragment id will
-	 * contain a proper value and we can skip other checks.
+	 * contain a proper value and we can skip other checks. Packets
+	 * using TCP segmentation offload are cut into segments later.
 	 */
-	if (net_pkt_ipv6_fragment_id(pkt) == 0U) {
+	if (net_pkt_ipv6_fragment_id(pkt) == 0U && !net_pkt_gso_size(pkt)) {
 		uint16_t mtu = net_if_get_mtu(net_pkt_iface(pkt));
 		size_t pkt_len = net_pkt_get_len(pkt);
 
@@ -52,6 +52,13 @@ LOG_MODULE_REGISTER(net_ctx, CONFIG_NET_CONTEXT_LOG_LEVEL);
 
 #define NET_MAX_CONTEXT CONFIG_NET_MAX_CONTEXTS
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+#define CONTEXT_RX_QUOTA NET_PKT_QUOTA(CONFIG_NET_PKT_RX_COUNT, \
+				       CONFIG_NET_PKT_RX_CONTEXT_QUOTA)
+#define CONTEXT_TX_QUOTA NET_PKT_QUOTA(CONFIG_NET_PKT_TX_COUNT, \
+				       CONFIG_NET_PKT_TX_CONTEXT_QUOTA)
+#endif
+
 static struct net_context contexts[NET_MAX_CONTEXT];
 
 /* We need to lock the contexts array as these APIs are typically called
@@ -309,6 +316,13 @@ int net_context_get(sa_family_t family,
 		k_sem_init(&contexts[i].recv_data_wait, 1, K_SEM_MAX_LIMIT);
 #endif /* CONFIG_NET_CONTEXT_SYNC_RECV */
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+		k_sem_init(&contexts[i].rx_quota, CONTEXT_RX_QUOTA,
+			   CONTEXT_RX_QUOTA);
+		k_sem_init(&contexts[i].tx_quota, CONTEXT_TX_QUOTA,
+			   CONTEXT_TX_QUOTA);
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 		k_mutex_init(&contexts[i].lock);
 
 		contexts[i].flags |= NET_CONTEXT_IN_USE;
@@ -1338,6 +1352,9 @@ static struct net_pkt *context_alloc_pkt(struct net_context *context,
 					 size_t len, k_timeout_t timeout)
 {
 	struct net_pkt *pkt;
+#if defined(CONFIG_NET_PKT_QUOTA)
+	uint64_t end = sys_clock_timeout_end_calc(timeout);
+#endif
 
 #if defined(CONFIG_NET_CONTEXT_NET_PKT_POOL)
 	if (context->tx_slab) {
@@ -1360,6 +1377,29 @@ static struct net_pkt *context_alloc_pkt(struct net_context *context,
 		return pkt;
 	}
 #endif
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/* Over the quota, wait for the context's own packets to be released
+	 * instead of taking the ones of everybody else.
+	 */
+	if (k_sem_take(&context->tx_quota, timeout)) {
+		net_stats_update_pkt_tx_quota_drop(
+					net_context_get_iface(context));
+		return NULL;
+	}
+
+	if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
+	    !K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+		int64_t remaining = end - sys_clock_tick_get();
+
+		if (remaining <= 0) {
+			timeout = K_NO_WAIT;
+		} else {
+			timeout = Z_TIMEOUT_TICKS(remaining);
+		}
+	}
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 	pkt = net_pkt_alloc_with_buffer(net_context_get_iface(context), len,
 					net_context_get_family(context),
 					net_context_get_ip_proto(context),
@@ -1368,6 +1408,14 @@ static struct net_pkt *context_alloc_pkt(struct net_context *context,
 		net_pkt_set_context(pkt, context);
 	}
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	if (pkt) {
+		net_pkt_quota_set(pkt, &context->tx_quota);
+	} else {
+		k_sem_give(&context->tx_quota);
+	}
+#endif
+
 	return pkt;
 }
 
@@ -1834,6 +1882,17 @@ enum net_verdict net_context_packet_received(struct net_conn *conn,
 		goto unlock;
 	}
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/* Charge the packet to the context until it is read, so that a
+	 * socket nobody reads cannot use up the interface quota. TCP data
+	 * has already been charged before it was acknowledged.
+	 */
+	if (net_pkt_quota_move(pkt, &context->rx_quota) < 0) {
+		net_stats_update_pkt_rx_quota_drop(net_pkt_iface(pkt));
+		goto unlock;
+	}
+#endif
+
 	if (net_context_get_ip_proto(context) == IPPROTO_TCP) {
 		net_stats_update_tcp_recv(net_pkt_iface(pkt),
 					  net_pkt_remaining_data(pkt));
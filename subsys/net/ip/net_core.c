@@ -373,7 +373,8 @@ void net_process_rx_packet(struct net_pkt *pkt)
 	net_rx(net_pkt_iface(pkt), pkt);
 }
 
-static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+/* Update the RX statistics and return the traffic class of the packet */
+static uint8_t net_rx_tc(struct net_if *iface, struct net_pkt *pkt)
 {
 	uint8_t prio = net_pkt_priority(pkt);
 	uint8_t tc = net_rx_priority2tc(prio);
@@ -388,6 +389,13 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	NET_DBG("TC %d with prio %d pkt %p", tc, prio, pkt);
 #endif
 
+	return tc;
+}
+
+static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+{
+	uint8_t tc = net_rx_tc(iface, pkt);
+
 	if (NET_TC_RX_COUNT == 0) {
 		net_process_rx_packet(pkt);
 	} else {
@@ -395,13 +403,8 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	}
 }
 
-/* Called by driver when an IP packet has been received */
-int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
+static int net_recv_prepare(struct net_if *iface, struct net_pkt *pkt)
 {
-	if (!pkt || !iface) {
-		return -EINVAL;
-	}
-
 	if (net_pkt_is_empty(pkt)) {
 		return -ENODATA;
 	}
@@ -422,11 +425,108 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 
 	net_pkt_set_iface(pkt, iface);
 
+	return 0;
+}
+
+/* Called by driver when an IP packet has been received */
+int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
+{
+	int ret;
+
+	if (!pkt || !iface) {
+		return -EINVAL;
+	}
+
+	ret = net_recv_prepare(iface, pkt);
+	if (ret < 0) {
+		return ret;
+	}
+
 	net_queue_rx(iface, pkt);
 
 	return 0;
 }
 
+#if defined(CONFIG_NET_RX_BATCH)
+/* Called by driver when several packets have been received */
+int net_recv_data_batch(struct net_if *iface, struct net_pkt **pkts,
+			size_t count)
+{
+	/* Packets of each traffic class, linked through their fifo field */
+	struct net_pkt *head[MAX(NET_TC_RX_COUNT, 1)] = { NULL };
+	struct net_pkt *tail[MAX(NET_TC_RX_COUNT, 1)];
+	int queued = 0;
+	size_t i;
+	int tc;
+
+	if (!iface || (count && !pkts)) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < count; i++) {
+		struct net_pkt *pkt = pkts[i];
+
+		if (!pkt) {
+			continue;
+		}
+
+		if (net_recv_prepare(iface, pkt) < 0) {
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		tc = net_rx_tc(iface, pkt);
+		queued++;
+
+		if (NET_TC_RX_COUNT == 0) {
+			net_process_rx_packet(pkt);
+			continue;
+		}
+
+		pkt->fifo = 0;
+
+		if (head[tc]) {
+			tail[tc]->fifo = (intptr_t)pkt;
+		} else {
+			head[tc] = pkt;
+		}
+
+		tail[tc] = pkt;
+	}
+
+	for (tc = 0; tc < NET_TC_RX_COUNT; tc++) {
+		if (head[tc]) {
+			net_tc_submit_list_to_rx_queue(tc, head[tc], tail[tc]);
+		}
+	}
+
+	return queued;
+}
+
+static void net_rx_poll_handler(struct k_work *work)
+{
+	struct net_rx_poll *poll = CONTAINER_OF(work, struct net_rx_poll,
+						work);
+
+	/* Budget used up, more packets are probably waiting */
+	if (poll->cb(poll, CONFIG_NET_RX_BATCH_BUDGET) >=
+	    CONFIG_NET_RX_BATCH_BUDGET) {
+		k_work_submit(&poll->work);
+	}
+}
+
+void net_rx_poll_init(struct net_rx_poll *poll, net_rx_poll_cb_t cb)
+{
+	poll->cb = cb;
+	k_work_init(&poll->work, net_rx_poll_handler);
+}
+
+void net_rx_poll_schedule(struct net_rx_poll *poll)
+{
+	k_work_submit(&poll->work);
+}
+#endif /* CONFIG_NET_RX_BATCH */
+
 static inline void l3_init(void)
 {
 	net_icmpv4_init();
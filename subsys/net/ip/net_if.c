@@ -257,7 +257,13 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 			}
 		}
 
-		status = net_if_l2(iface)->send(iface, pkt);
+		/* Cut large TCP packets here if L2 cannot do it */
+		if (IS_ENABLED(CONFIG_NET_TCP_GSO) && net_pkt_gso_size(pkt) &&
+		    !net_if_flag_is_set(iface, NET_IF_GSO)) {
+			status = net_tcp_gso_send(iface, pkt);
+		} else {
+			status = net_if_l2(iface)->send(iface, pkt);
+		}
 
 		if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS)) {
 			uint32_t end_tick = k_cycle_get_32();
@@ -399,6 +405,14 @@ static inline void init_iface(struct net_if *iface)
 {
 	const struct net_if_api *api = net_if_get_device(iface)->api;
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	k_sem_init(&iface->rx_quota,
+		   NET_PKT_QUOTA(CONFIG_NET_PKT_RX_COUNT,
+				 CONFIG_NET_PKT_RX_IFACE_QUOTA),
+		   NET_PKT_QUOTA(CONFIG_NET_PKT_RX_COUNT,
+				 CONFIG_NET_PKT_RX_IFACE_QUOTA));
+#endif
+
 	if (!api || !api->init) {
 		NET_ERR("Iface %p driver API init NULL", iface);
 		return;
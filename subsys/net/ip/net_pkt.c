@@ -39,6 +39,7 @@ LOG_MODULE_REGISTER(net_pkt, CONFIG_NET_PKT_LOG_LEVEL);
 #include <net/udp.h>
 
 #include "net_private.h"
+#include "net_stats.h"
 #include "tcp_internal.h"
 
 /* Find max header size of IP protocol (IPv4 or IPv6) */
@@ -119,6 +120,13 @@ NET_BUF_POOL_FIXED_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT,
 NET_BUF_POOL_FIXED_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT,
 			  CONFIG_NET_BUF_DATA_SIZE, NULL);
 
+#if defined(CONFIG_NET_BUF_SIZE_CLASSES)
+NET_BUF_POOL_FIXED_DEFINE(rx_small_bufs, CONFIG_NET_BUF_SMALL_RX_COUNT,
+			  CONFIG_NET_BUF_SMALL_DATA_SIZE, NULL);
+NET_BUF_POOL_FIXED_DEFINE(tx_small_bufs, CONFIG_NET_BUF_SMALL_TX_COUNT,
+			  CONFIG_NET_BUF_SMALL_DATA_SIZE, NULL);
+#endif /* CONFIG_NET_BUF_SIZE_CLASSES */
+
 #else /* !CONFIG_NET_BUF_FIXED_DATA_SIZE */
 
 NET_BUF_POOL_VAR_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT,
@@ -591,6 +599,12 @@ done:
 		net_pkt_cursor_init(pkt);
 	}
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	if (pkt->quota) {
+		k_sem_give(pkt->quota);
+	}
+#endif
+
 	k_mem_slab_free(pkt->slab, (void **)&pkt);
 }
 
@@ -834,6 +848,48 @@ void net_pkt_get_info(struct k_mem_slab **rx,
 	}
 }
 
+#if defined(CONFIG_NET_BUF_SIZE_CLASSES)
+void net_pkt_get_small_info(struct net_buf_pool **rx_data,
+			    struct net_buf_pool **tx_data)
+{
+	if (rx_data) {
+		*rx_data = &rx_small_bufs;
+	}
+
+	if (tx_data) {
+		*tx_data = &tx_small_bufs;
+	}
+}
+#endif /* CONFIG_NET_BUF_SIZE_CLASSES */
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+void net_pkt_quota_set(struct net_pkt *pkt, struct k_sem *quota)
+{
+	NET_ASSERT(!pkt->quota);
+
+	pkt->quota = quota;
+}
+
+int net_pkt_quota_move(struct net_pkt *pkt, struct k_sem *quota)
+{
+	if (pkt->quota == quota) {
+		return 0;
+	}
+
+	if (k_sem_take(quota, K_NO_WAIT)) {
+		return -ENOBUFS;
+	}
+
+	if (pkt->quota) {
+		k_sem_give(pkt->quota);
+	}
+
+	pkt->quota = quota;
+
+	return 0;
+}
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
 void net_pkt_print(void)
 {
@@ -848,6 +904,37 @@ void net_pkt_print(void)
 
 #if defined(CONFIG_NET_BUF_FIXED_DATA_SIZE)
 
+#if defined(CONFIG_NET_BUF_SIZE_CLASSES)
+static struct net_buf *pkt_alloc_small_buffer(struct net_buf_pool *pool,
+					      size_t size)
+{
+	struct net_buf *buf;
+
+	if (size > CONFIG_NET_BUF_SMALL_DATA_SIZE) {
+		return NULL;
+	}
+
+	if (pool == &rx_bufs) {
+		pool = &rx_small_bufs;
+	} else if (pool == &tx_bufs) {
+		pool = &tx_small_bufs;
+	} else {
+		/* Context specific pools have no small class */
+		return NULL;
+	}
+
+	/* Never wait here, a regular fragment does the job as well */
+	buf = net_buf_alloc_fixed(pool, K_NO_WAIT);
+	if (buf) {
+		net_stats_update_pkt_small_bufs();
+	}
+
+	return buf;
+}
+#else
+#define pkt_alloc_small_buffer(pool, size) NULL
+#endif /* CONFIG_NET_BUF_SIZE_CLASSES */
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
 					size_t size, k_timeout_t timeout,
@@ -864,9 +951,12 @@ static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
 	while (size) {
 		struct net_buf *new;
 
-		new = net_buf_alloc_fixed(pool, timeout);
+		new = pkt_alloc_small_buffer(pool, size);
 		if (!new) {
-			goto error;
+			new = net_buf_alloc_fixed(pool, timeout);
+			if (!new) {
+				goto error;
+			}
 		}
 
 		if (!first && !current) {
@@ -1160,6 +1250,8 @@ int net_pkt_alloc_buffer(struct net_pkt *pkt,
 #endif
 
 	if (!buf) {
+		net_stats_update_pkt_buf_fail(pool == &rx_bufs);
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 		NET_ERR("Data buffer (%zd) allocation failed (%s:%d)",
 			alloc_len, caller, line);
@@ -1198,9 +1290,16 @@ static struct net_pkt *pkt_alloc(struct k_mem_slab *slab, k_timeout_t timeout)
 
 	ret = k_mem_slab_alloc(slab, (void **)&pkt, timeout);
 	if (ret) {
+		net_stats_update_pkt_alloc_fail(slab == &rx_pkts);
 		return NULL;
 	}
 
+	if (IS_ENABLED(CONFIG_NET_STATISTICS_PKT_POOL) &&
+	    (slab == &rx_pkts || slab == &tx_pkts)) {
+		net_stats_update_pkt_used(slab == &rx_pkts,
+					  k_mem_slab_num_used_get(slab));
+	}
+
 	memset(pkt, 0, sizeof(struct net_pkt));
 
 	pkt->atomic_ref = ATOMIC_INIT(1);
@@ -1306,6 +1405,17 @@ static struct net_pkt *pkt_alloc_on_iface(struct k_mem_slab *slab,
 {
 	struct net_pkt *pkt;
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/* Drivers allocate RX packets without waiting, so a packet over the
+	 * interface quota is dropped as early as possible.
+	 */
+	if (slab == &rx_pkts && iface &&
+	    k_sem_take(&iface->rx_quota, K_NO_WAIT)) {
+		net_stats_update_pkt_rx_quota_drop(iface);
+		return NULL;
+	}
+#endif
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 	pkt = pkt_alloc(slab, timeout, caller, line);
 #else
@@ -1316,6 +1426,16 @@ static struct net_pkt *pkt_alloc_on_iface(struct k_mem_slab *slab,
 		net_pkt_set_iface(pkt, iface);
 	}
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	if (slab == &rx_pkts && iface) {
+		if (pkt) {
+			pkt->quota = &iface->rx_quota;
+		} else {
+			k_sem_give(&iface->rx_quota);
+		}
+	}
+#endif
+
 	return pkt;
 }
 
@@ -1739,6 +1859,7 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	net_pkt_set_priority(clone_pkt, net_pkt_priority(pkt));
 	net_pkt_set_orig_iface(clone_pkt, net_pkt_orig_iface(pkt));
 	net_pkt_set_captured(clone_pkt, net_pkt_is_captured(pkt));
+	net_pkt_set_gso_size(clone_pkt, net_pkt_gso_size(pkt));
 
 	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
 		net_pkt_set_ipv4_ttl(clone_pkt, net_pkt_ipv4_ttl(pkt));
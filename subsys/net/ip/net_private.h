@@ -90,7 +90,20 @@ static inline enum net_verdict net_ipv6_input(struct net_pkt *pkt,
 #endif
 extern bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt);
+extern void net_tc_submit_list_to_rx_queue(uint8_t tc, struct net_pkt *head,
+					   struct net_pkt *tail);
+extern bool net_tc_rx_pending(void);
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+/* Number of packets out of count a quota of the given percent allows */
+#define NET_PKT_QUOTA(count, percent) MAX((count) * (percent) / 100, 1)
+
+extern void net_pkt_quota_set(struct net_pkt *pkt, struct k_sem *quota);
+extern int net_pkt_quota_move(struct net_pkt *pkt, struct k_sem *quota);
+#endif
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
+extern int net_tcp_gso_send(struct net_if *iface, struct net_pkt *pkt);
+extern void net_tcp_gro_flush(void);
 
 char *net_sprint_addr(sa_family_t af, const void *addr);
 
@@ -144,6 +157,32 @@ extern char *net_sprint_ll_addr_buf(const uint8_t *ll, uint8_t ll_len,
 				    char *buf, int buflen);
 extern uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto);
 
+/**
+ * @brief Update a checksum after rewriting part of the checksummed data
+ *
+ * Incremental update as per RFC 1624, so that rewriting e.g. an address
+ * or a port does not need another pass over the whole packet. The
+ * checksum and the data are taken as stored in the packet, i.e. in
+ * network byte order. The rewritten field must start at an even offset
+ * of the checksummed data. Note that an UDP checksum of zero means no
+ * checksum, and must not be updated.
+ *
+ * @param chksum	Current checksum
+ * @param old_data	Previous contents of the field
+ * @param new_data	New contents of the field
+ * @param len		Length of the field
+ *
+ * @return Updated checksum
+ */
+uint16_t net_chksum_update(uint16_t chksum, const void *old_data,
+			   const void *new_data, size_t len);
+
+static inline uint16_t net_chksum_update16(uint16_t chksum, uint16_t old_val,
+					   uint16_t new_val)
+{
+	return net_chksum_update(chksum, &old_val, &new_val, sizeof(old_val));
+}
+
 /**
  * @brief Deliver the incoming packet through the recv_cb of the net_context
  *        to the upper layers
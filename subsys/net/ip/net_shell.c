@@ -1174,6 +1174,30 @@ static void print_net_pm_stats(const struct shell *shell, struct net_if *iface)
 #endif
 }
 
+static void print_net_pkt_pool_stats(const struct shell *shell,
+				     struct net_if *iface)
+{
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+	PR("Packet pool stats:\n");
+	PR("\tAlloc failed  : RX pkt %u TX pkt %u RX buf %u TX buf %u\n",
+	   GET_STAT(iface, pkt_pool.rx_alloc_fail),
+	   GET_STAT(iface, pkt_pool.tx_alloc_fail),
+	   GET_STAT(iface, pkt_pool.rx_buf_fail),
+	   GET_STAT(iface, pkt_pool.tx_buf_fail));
+	PR("\tQuota drop    : RX %u TX %u\n",
+	   GET_STAT(iface, pkt_pool.rx_quota_drop),
+	   GET_STAT(iface, pkt_pool.tx_quota_drop));
+	PR("\tMax used pkts : RX %u TX %u\n",
+	   GET_STAT(iface, pkt_pool.rx_max_used),
+	   GET_STAT(iface, pkt_pool.tx_max_used));
+	PR("\tSmall bufs    : %u\n",
+	   GET_STAT(iface, pkt_pool.small_bufs));
+#else
+	ARG_UNUSED(shell);
+	ARG_UNUSED(iface);
+#endif
+}
+
 static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 {
 	struct net_shell_user_data *data = user_data;
@@ -1271,6 +1295,10 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 	   GET_STAT(iface, tcp.conndrop),
 	   GET_STAT(iface, tcp.connrst));
 	PR("TCP pkt drop   %d\n", GET_STAT(iface, tcp.drop));
+	PR("TCP gso        %d\tgso segs\t%d\tgro\t%d\n",
+	   GET_STAT(iface, tcp.gso),
+	   GET_STAT(iface, tcp.gso_segs),
+	   GET_STAT(iface, tcp.gro));
 #endif
 
 	PR("Bytes received %u\n", GET_STAT(iface, bytes.received));
@@ -1309,6 +1337,7 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 #endif /* CONFIG_NET_STATISTICS_PPP && CONFIG_NET_STATISTICS_USER_API */
 
 	print_net_pm_stats(shell, iface);
+	print_net_pkt_pool_stats(shell, iface);
 }
 #endif /* CONFIG_NET_STATISTICS */
 
@@ -3657,6 +3686,10 @@ static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 
 	PR("Fragment length %d bytes\n", CONFIG_NET_BUF_DATA_SIZE);
 
+#if defined(CONFIG_NET_BUF_SIZE_CLASSES)
+	PR("Small fragment length %d bytes\n", CONFIG_NET_BUF_SMALL_DATA_SIZE);
+#endif
+
 	PR("Network buffer pools:\n");
 
 #if defined(CONFIG_NET_BUF_POOL_USAGE)
@@ -3675,6 +3708,18 @@ static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 	PR("%p\t%d\t%d\tTX DATA (%s)\n",
 	       tx_data, tx_data->buf_count,
 	       atomic_get(&tx_data->avail_count), tx_data->name);
+
+#if defined(CONFIG_NET_BUF_SIZE_CLASSES)
+	net_pkt_get_small_info(&rx_data, &tx_data);
+
+	PR("%p\t%d\t%d\tRX SMALL DATA (%s)\n",
+	       rx_data, rx_data->buf_count,
+	       atomic_get(&rx_data->avail_count), rx_data->name);
+
+	PR("%p\t%d\t%d\tTX SMALL DATA (%s)\n",
+	       tx_data, tx_data->buf_count,
+	       atomic_get(&tx_data->avail_count), tx_data->name);
+#endif /* CONFIG_NET_BUF_SIZE_CLASSES */
 #else
 	PR("Address\t\tTotal\tName\n");
 
@@ -3682,6 +3727,14 @@ static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 	PR("%p\t%d\tTX\n", tx, tx->num_blocks);
 	PR("%p\t%d\tRX DATA\n", rx_data, rx_data->buf_count);
 	PR("%p\t%d\tTX DATA\n", tx_data, tx_data->buf_count);
+
+#if defined(CONFIG_NET_BUF_SIZE_CLASSES)
+	net_pkt_get_small_info(&rx_data, &tx_data);
+
+	PR("%p\t%d\tRX SMALL DATA\n", rx_data, rx_data->buf_count);
+	PR("%p\t%d\tTX SMALL DATA\n", tx_data, tx_data->buf_count);
+#endif /* CONFIG_NET_BUF_SIZE_CLASSES */
+
 	PR_INFO("Set %s to enable %s support.\n",
 		"CONFIG_NET_BUF_POOL_USAGE", "net_buf allocation");
 #endif /* CONFIG_NET_BUF_POOL_USAGE */
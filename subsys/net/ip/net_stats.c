@@ -152,6 +152,10 @@ static inline void stats(struct net_if *iface)
 		NET_INFO("TCP conn drop  %d\tconnrst\t%d",
 			 GET_STAT(iface, tcp.conndrop),
 			 GET_STAT(iface, tcp.connrst));
+		NET_INFO("TCP gso        %d\tgso segs\t%d\tgro\t%d",
+			 GET_STAT(iface, tcp.gso),
+			 GET_STAT(iface, tcp.gso_segs),
+			 GET_STAT(iface, tcp.gro));
 #endif
 
 		NET_INFO("Bytes received %u", GET_STAT(iface, bytes.received));
@@ -203,6 +207,23 @@ static inline void stats(struct net_if *iface)
 		NET_INFO("Total suspended time: %llu ms",
 			 GET_STAT(iface, pm.overall_suspend_time));
 #endif
+
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+		NET_INFO("Packet pool statistics:");
+		NET_INFO("Alloc failed\tRX pkt %d\tTX pkt %d\t"
+			 "RX buf %d\tTX buf %d",
+			 GET_STAT(iface, pkt_pool.rx_alloc_fail),
+			 GET_STAT(iface, pkt_pool.tx_alloc_fail),
+			 GET_STAT(iface, pkt_pool.rx_buf_fail),
+			 GET_STAT(iface, pkt_pool.tx_buf_fail));
+		NET_INFO("Quota drop\tRX %d\tTX %d",
+			 GET_STAT(iface, pkt_pool.rx_quota_drop),
+			 GET_STAT(iface, pkt_pool.tx_quota_drop));
+		NET_INFO("Max used\tRX %d\tTX %d\tsmall bufs %d",
+			 GET_STAT(iface, pkt_pool.rx_max_used),
+			 GET_STAT(iface, pkt_pool.tx_max_used),
+			 GET_STAT(iface, pkt_pool.small_bufs));
+#endif
 		next_print = curr + PRINT_STATISTICS_INTERVAL;
 	}
 }
@@ -302,6 +323,12 @@ static int net_stats_get(uint32_t mgmt_request, struct net_if *iface,
 		len_chk = sizeof(struct net_stats_pm);
 		src = GET_STAT_ADDR(iface, pm);
 		break;
+#endif
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+	case NET_REQUEST_STATS_CMD_GET_PKT_POOL:
+		len_chk = sizeof(struct net_stats_pkt_pool);
+		src = GET_STAT_ADDR(iface, pkt_pool);
+		break;
 #endif
 	}
 
@@ -361,6 +388,11 @@ NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PM,
 				  net_stats_get);
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PKT_POOL,
+				  net_stats_get);
+#endif
+
 #endif /* CONFIG_NET_STATISTICS_USER_API */
 
 void net_stats_reset(struct net_if *iface)
@@ -258,6 +258,22 @@ static inline void net_stats_update_tcp_seg_rexmit(struct net_if *iface)
 {
 	UPDATE_STAT(iface, stats.tcp.rexmit++);
 }
+
+static inline void net_stats_update_tcp_seg_gso(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.tcp.gso++);
+}
+
+static inline void net_stats_update_tcp_seg_gso_segs(struct net_if *iface,
+						     uint32_t segs)
+{
+	UPDATE_STAT(iface, stats.tcp.gso_segs += segs);
+}
+
+static inline void net_stats_update_tcp_seg_gro(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.tcp.gro++);
+}
 #else
 #define net_stats_update_tcp_sent(iface, bytes)
 #define net_stats_update_tcp_resent(iface, bytes)
@@ -273,6 +289,9 @@ static inline void net_stats_update_tcp_seg_rexmit(struct net_if *iface)
 #define net_stats_update_tcp_seg_ackerr(iface)
 #define net_stats_update_tcp_seg_rsterr(iface)
 #define net_stats_update_tcp_seg_rexmit(iface)
+#define net_stats_update_tcp_seg_gso(iface)
+#define net_stats_update_tcp_seg_gso_segs(iface, segs)
+#define net_stats_update_tcp_seg_gro(iface)
 #endif /* CONFIG_NET_STATISTICS_TCP */
 
 static inline void net_stats_update_per_proto_recv(struct net_if *iface,
@@ -619,6 +638,71 @@ static inline void net_stats_add_suspend_end_time(struct net_if *iface,
 #define net_stats_add_suspend_end_time(iface, time)
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)	\
+	&& defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_NATIVE)
+/* The packet pools are shared by all the network interfaces, so pool events
+ * are counted globally. Quota drops are also counted per interface when it
+ * is known.
+ */
+#define UPDATE_PKT_POOL_STAT(_iface, _cmd)		\
+	do {						\
+		if (_iface) {				\
+			UPDATE_STAT(_iface, _cmd);	\
+		} else {				\
+			UPDATE_STAT_GLOBAL(_cmd);	\
+		}					\
+	} while (0)
+
+static inline void net_stats_update_pkt_alloc_fail(bool rx)
+{
+	if (rx) {
+		UPDATE_STAT_GLOBAL(stats.pkt_pool.rx_alloc_fail++);
+	} else {
+		UPDATE_STAT_GLOBAL(stats.pkt_pool.tx_alloc_fail++);
+	}
+}
+
+static inline void net_stats_update_pkt_buf_fail(bool rx)
+{
+	if (rx) {
+		UPDATE_STAT_GLOBAL(stats.pkt_pool.rx_buf_fail++);
+	} else {
+		UPDATE_STAT_GLOBAL(stats.pkt_pool.tx_buf_fail++);
+	}
+}
+
+static inline void net_stats_update_pkt_small_bufs(void)
+{
+	UPDATE_STAT_GLOBAL(stats.pkt_pool.small_bufs++);
+}
+
+static inline void net_stats_update_pkt_used(bool rx, uint32_t used)
+{
+	if (rx && used > net_stats.pkt_pool.rx_max_used) {
+		UPDATE_STAT_GLOBAL(stats.pkt_pool.rx_max_used = used);
+	} else if (!rx && used > net_stats.pkt_pool.tx_max_used) {
+		UPDATE_STAT_GLOBAL(stats.pkt_pool.tx_max_used = used);
+	}
+}
+
+static inline void net_stats_update_pkt_rx_quota_drop(struct net_if *iface)
+{
+	UPDATE_PKT_POOL_STAT(iface, stats.pkt_pool.rx_quota_drop++);
+}
+
+static inline void net_stats_update_pkt_tx_quota_drop(struct net_if *iface)
+{
+	UPDATE_PKT_POOL_STAT(iface, stats.pkt_pool.tx_quota_drop++);
+}
+#else
+#define net_stats_update_pkt_alloc_fail(rx)
+#define net_stats_update_pkt_buf_fail(rx)
+#define net_stats_update_pkt_small_bufs()
+#define net_stats_update_pkt_used(rx, used)
+#define net_stats_update_pkt_rx_quota_drop(iface)
+#define net_stats_update_pkt_tx_quota_drop(iface)
+#endif /* CONFIG_NET_STATISTICS_PKT_POOL */
+
 #if defined(CONFIG_NET_STATISTICS_PERIODIC_OUTPUT) \
 	&& defined(CONFIG_NET_NATIVE)
 /* A simple periodic statistic printer, used only in net core */
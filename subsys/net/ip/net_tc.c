@@ -13,6 +13,7 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 #include <net/net_core.h>
 #include <net/net_pkt.h>
 #include <net/net_stats.h>
+#include <net/ethernet.h>
 
 #include "net_private.h"
 #include "net_stats.h"
@@ -21,23 +22,36 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 /* Template for thread name. The "xx" is either "TX" denoting transmit thread,
  * or "RX" denoting receive thread. The "q[y]" denotes the traffic class queue
  * where y indicates the traffic class id. The value of y can be from 0 to 7.
+ * With flow queues, "q[y.z]" denotes the flow queue z of the traffic class.
  */
-#define MAX_NAME_LEN sizeof("xx_q[y]")
+#define MAX_NAME_LEN sizeof("xx_q[y.z]")
+
+/* Every traffic class has this many queues and threads, each handling its
+ * own set of flows.
+ */
+#if defined(CONFIG_NET_TC_FLOW_QUEUES)
+#define NET_TC_FLOW_QUEUES CONFIG_NET_TC_FLOW_QUEUES
+#else
+#define NET_TC_FLOW_QUEUES 1
+#endif
+
+#define NET_TC_TX_QUEUES (NET_TC_TX_COUNT * NET_TC_FLOW_QUEUES)
+#define NET_TC_RX_QUEUES (NET_TC_RX_COUNT * NET_TC_FLOW_QUEUES)
 
 /* Stacks for TX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, NET_TC_TX_COUNT,
+K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, NET_TC_TX_QUEUES,
 			    CONFIG_NET_TX_STACK_SIZE);
 
 /* Stacks for RX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT,
+K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_QUEUES,
 			    CONFIG_NET_RX_STACK_SIZE);
 
 #if NET_TC_TX_COUNT > 0
-static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
+static struct net_traffic_class tx_classes[NET_TC_TX_QUEUES];
 #endif
 
 #if NET_TC_RX_COUNT > 0
-static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
+static struct net_traffic_class rx_classes[NET_TC_RX_QUEUES];
 #endif
 
 #if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
@@ -47,12 +61,124 @@ static void submit_to_queue(struct k_fifo *queue, struct net_pkt *pkt)
 }
 #endif
 
+#if NET_TC_FLOW_QUEUES > 1
+/* Hash the addresses, the protocol and the ports of an IP packet. The hash
+ * is the same for both directions of a flow, and all the fragments of a
+ * datagram get the same hash as the ports are only in the first one.
+ */
+static uint32_t flow_hash(struct net_pkt *pkt, bool rx)
+{
+	bool overwrite = net_pkt_is_being_overwritten(pkt);
+	struct net_pkt_cursor backup;
+	union {
+		struct net_ipv4_hdr ipv4;
+		struct net_ipv6_hdr ipv6;
+	} hdr;
+	const uint8_t *src, *dst;
+	uint16_t ports[2] = { 0 };
+	uint32_t hash = 0U;
+	size_t len, skip;
+	uint8_t proto;
+
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	/* Received packets still have their link layer header */
+	if (rx && net_if_l2(net_pkt_iface(pkt)) == &NET_L2_GET_NAME(ETHERNET)) {
+		uint16_t type;
+
+		if (net_pkt_skip(pkt, 2 * sizeof(struct net_eth_addr)) ||
+		    net_pkt_read_be16(pkt, &type)) {
+			goto out;
+		}
+
+		if (type == NET_ETH_PTYPE_VLAN &&
+		    (net_pkt_skip(pkt, sizeof(uint16_t)) ||
+		     net_pkt_read_be16(pkt, &type))) {
+			goto out;
+		}
+
+		if (type != NET_ETH_PTYPE_IP && type != NET_ETH_PTYPE_IPV6) {
+			goto out;
+		}
+	}
+#else
+	ARG_UNUSED(rx);
+#endif
+
+	if (net_pkt_read(pkt, &hdr, sizeof(hdr.ipv4))) {
+		goto out;
+	}
+
+	if ((hdr.ipv4.vhl & 0xf0) == 0x40) {
+		src = hdr.ipv4.src.s4_addr;
+		dst = hdr.ipv4.dst.s4_addr;
+		len = sizeof(struct in_addr);
+		proto = hdr.ipv4.proto;
+		skip = (hdr.ipv4.vhl & 0x0f) * 4U - sizeof(hdr.ipv4);
+
+		/* Fragmented, no ports or not in every fragment */
+		if ((hdr.ipv4.offset[0] & 0x3f) || hdr.ipv4.offset[1]) {
+			proto = 0U;
+		}
+	} else if ((hdr.ipv4.vhl & 0xf0) == 0x60) {
+		if (net_pkt_read(pkt, (uint8_t *)&hdr + sizeof(hdr.ipv4),
+				 sizeof(hdr.ipv6) - sizeof(hdr.ipv4))) {
+			goto out;
+		}
+
+		src = hdr.ipv6.src.s6_addr;
+		dst = hdr.ipv6.dst.s6_addr;
+		len = sizeof(struct in6_addr);
+		proto = hdr.ipv6.nexthdr;
+		skip = 0;
+	} else {
+		goto out;
+	}
+
+	if ((proto == IPPROTO_TCP || proto == IPPROTO_UDP) &&
+	    (net_pkt_skip(pkt, skip) ||
+	     net_pkt_read(pkt, ports, sizeof(ports)))) {
+		ports[0] = ports[1] = 0U;
+	}
+
+	hash = (uint32_t)(ports[0] ^ ports[1]) << 8 | proto;
+
+	for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+		hash = (hash ^ UNALIGNED_GET((const uint32_t *)&src[i]) ^
+			UNALIGNED_GET((const uint32_t *)&dst[i])) * 0x9e3779b1U;
+	}
+
+	hash ^= hash >> 16;
+out:
+	net_pkt_cursor_restore(pkt, &backup);
+	net_pkt_set_overwrite(pkt, overwrite);
+
+	return hash;
+}
+
+static inline int flow_queue(uint8_t tc, struct net_pkt *pkt, bool rx)
+{
+	return tc * NET_TC_FLOW_QUEUES + flow_hash(pkt, rx) % NET_TC_FLOW_QUEUES;
+}
+#else
+static inline int flow_queue(uint8_t tc, struct net_pkt *pkt, bool rx)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(rx);
+
+	return tc;
+}
+#endif /* NET_TC_FLOW_QUEUES > 1 */
+
 bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 #if NET_TC_TX_COUNT > 0
 	net_pkt_set_tx_stats_tick(pkt, k_cycle_get_32());
 
-	submit_to_queue(&tx_classes[tc].fifo, pkt);
+	submit_to_queue(&tx_classes[flow_queue(tc, pkt, false)].fifo, pkt);
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
@@ -65,13 +191,83 @@ void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 #if NET_TC_RX_COUNT > 0
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
-	submit_to_queue(&rx_classes[tc].fifo, pkt);
+	submit_to_queue(&rx_classes[flow_queue(tc, pkt, true)].fifo, pkt);
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
 #endif
 }
 
+#if defined(CONFIG_NET_RX_BATCH)
+/* Queue a list of packets linked through their fifo field at once */
+void net_tc_submit_list_to_rx_queue(uint8_t tc, struct net_pkt *head,
+				    struct net_pkt *tail)
+{
+#if NET_TC_RX_COUNT > 0
+	struct net_pkt *pkt;
+
+#if NET_TC_FLOW_QUEUES > 1
+	/* Split the list by flow queue, keeping the order of each flow */
+	struct net_pkt *heads[NET_TC_FLOW_QUEUES] = { NULL };
+	struct net_pkt *tails[NET_TC_FLOW_QUEUES];
+	struct net_pkt *next;
+	int q;
+
+	for (pkt = head; pkt; pkt = next) {
+		next = (struct net_pkt *)pkt->fifo;
+		net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
+
+		q = flow_queue(tc, pkt, true) - tc * NET_TC_FLOW_QUEUES;
+		pkt->fifo = 0;
+
+		if (heads[q]) {
+			tails[q]->fifo = (intptr_t)pkt;
+		} else {
+			heads[q] = pkt;
+		}
+
+		tails[q] = pkt;
+	}
+
+	for (q = 0; q < NET_TC_FLOW_QUEUES; q++) {
+		if (heads[q]) {
+			k_fifo_put_list(
+				&rx_classes[tc * NET_TC_FLOW_QUEUES + q].fifo,
+				heads[q], tails[q]);
+		}
+	}
+
+	ARG_UNUSED(tail);
+#else
+	for (pkt = head; pkt; pkt = (struct net_pkt *)pkt->fifo) {
+		net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
+	}
+
+	k_fifo_put_list(&rx_classes[tc].fifo, head, tail);
+#endif
+#else
+	ARG_UNUSED(tc);
+	ARG_UNUSED(head);
+	ARG_UNUSED(tail);
+#endif
+}
+#endif
+
+/* Are more packets queued for the RX thread calling this */
+bool net_tc_rx_pending(void)
+{
+#if NET_TC_RX_COUNT > 0
+	k_tid_t current = k_current_get();
+
+	for (int i = 0; i < NET_TC_RX_QUEUES; i++) {
+		if (current == &rx_classes[i].handler) {
+			return !k_fifo_is_empty(&rx_classes[i].fifo);
+		}
+	}
+#endif
+	return false;
+}
+
 int net_tx_priority2tc(enum net_priority prio)
 {
 #if NET_TC_TX_COUNT > 0
@@ -237,9 +433,15 @@ static void net_tc_rx_stats_priority_setup(struct net_if *iface,
 #endif
 
 #if NET_TC_RX_COUNT > 0
+/* Coalesced TCP segments are passed up at least this often */
+#define GRO_FLUSH_BUDGET 16
+
 static void tc_rx_handler(struct k_fifo *fifo)
 {
 	struct net_pkt *pkt;
+#if defined(CONFIG_NET_TCP_GRO)
+	int budget = GRO_FLUSH_BUDGET;
+#endif
 
 	while (1) {
 		pkt = k_fifo_get(fifo, K_FOREVER);
@@ -248,10 +450,46 @@ static void tc_rx_handler(struct k_fifo *fifo)
 		}
 
 		net_process_rx_packet(pkt);
+
+#if defined(CONFIG_NET_TCP_GRO)
+		if (k_fifo_is_empty(fifo) || --budget == 0) {
+			net_tcp_gro_flush();
+			budget = GRO_FLUSH_BUDGET;
+		}
+#endif
 	}
 }
 #endif
 
+#if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
+static void flow_queue_setup(k_tid_t tid, const char *dir, int i)
+{
+#if NET_TC_FLOW_QUEUES > 1
+	if (IS_ENABLED(CONFIG_THREAD_NAME)) {
+		char name[MAX_NAME_LEN];
+
+		snprintk(name, sizeof(name), "%s_q[%d.%d]", dir,
+			 i / NET_TC_FLOW_QUEUES, i % NET_TC_FLOW_QUEUES);
+		k_thread_name_set(tid, name);
+	}
+
+#if defined(CONFIG_SCHED_CPU_MASK) && CONFIG_MP_NUM_CPUS > 1
+	/* Run each flow queue of a traffic class on its own CPU */
+	k_thread_cpu_mask_clear(tid);
+	k_thread_cpu_mask_enable(tid, (i % NET_TC_FLOW_QUEUES) %
+				 CONFIG_MP_NUM_CPUS);
+#endif
+#else
+	if (IS_ENABLED(CONFIG_THREAD_NAME)) {
+		char name[MAX_NAME_LEN];
+
+		snprintk(name, sizeof(name), "%s_q[%d]", dir, i);
+		k_thread_name_set(tid, name);
+	}
+#endif
+}
+#endif
+
 #if NET_TC_TX_COUNT > 0
 static void tc_tx_handler(struct k_fifo *fifo)
 {
@@ -285,12 +523,12 @@ void net_tc_tx_init(void)
 	net_if_foreach(net_tc_tx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_TX_COUNT; i++) {
+	for (i = 0; i < NET_TC_TX_QUEUES; i++) {
 		uint8_t thread_priority;
 		int priority;
 		k_tid_t tid;
 
-		thread_priority = tx_tc2thread(i);
+		thread_priority = tx_tc2thread(i / NET_TC_FLOW_QUEUES);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 			K_PRIO_COOP(thread_priority) :
@@ -317,12 +555,7 @@ void net_tc_tx_init(void)
 			continue;
 		}
 
-		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
-			char name[MAX_NAME_LEN];
-
-			snprintk(name, sizeof(name), "tx_q[%d]", i);
-			k_thread_name_set(tid, name);
-		}
+		flow_queue_setup(tid, "tx", i);
 
 		k_thread_start(tid);
 	}
@@ -343,12 +576,12 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+	for (i = 0; i < NET_TC_RX_QUEUES; i++) {
 		uint8_t thread_priority;
 		int priority;
 		k_tid_t tid;
 
-		thread_priority = rx_tc2thread(i);
+		thread_priority = rx_tc2thread(i / NET_TC_FLOW_QUEUES);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 			K_PRIO_COOP(thread_priority) :
@@ -375,12 +608,7 @@ void net_tc_rx_init(void)
 			continue;
 		}
 
-		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
-			char name[MAX_NAME_LEN];
-
-			snprintk(name, sizeof(name), "rx_q[%d]", i);
-			k_thread_name_set(tid, name);
-		}
+		flow_queue_setup(tid, "rx", i);
 
 		k_thread_start(tid);
 	}
@@ -36,7 +36,221 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
+
+#if defined(CONFIG_NET_ROUTE_TRIE)
+/* The routes are also kept in a path compressed binary trie keyed by their
+ * prefix. A node holds the routes having exactly its prefix, and a node
+ * without routes only exists to join two branches. So there are never more
+ * than two nodes per route.
+ */
+struct route_trie_node {
+	struct route_trie_node *child[2];
+
+	/** Routes with this prefix, on different network interfaces */
+	sys_slist_t routes;
+
+	/** Prefix with all the bits after len cleared */
+	struct in6_addr prefix;
+
+	uint8_t len;
+};
+
+static struct route_trie_node trie_root;
+static struct route_trie_node trie_nodes[2 * CONFIG_NET_MAX_ROUTES];
+
+/* Free nodes are linked through their first child pointer */
+static struct route_trie_node *trie_free;
+
+static inline int addr_bit(const struct in6_addr *addr, uint8_t pos)
+{
+	return (addr->s6_addr[pos / 8U] >> (7 - pos % 8U)) & 1;
+}
+
+static uint8_t common_prefix_len(const struct in6_addr *addr1,
+				 const struct in6_addr *addr2, uint8_t max)
+{
+	uint8_t len = 0U;
+	int i;
+
+	for (i = 0; i < 16 && len < max; i++) {
+		uint8_t diff = addr1->s6_addr[i] ^ addr2->s6_addr[i];
+
+		if (diff) {
+			len += __builtin_clz(diff) - 24;
+			break;
+		}
+
+		len += 8U;
+	}
+
+	return MIN(len, max);
+}
+
+static struct route_trie_node *trie_node_alloc(const struct in6_addr *addr,
+					       uint8_t len)
+{
+	struct route_trie_node *node = trie_free;
+
+	if (!node) {
+		return NULL;
+	}
+
+	trie_free = node->child[0];
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	sys_slist_init(&node->routes);
+
+	(void)memset(&node->prefix, 0, sizeof(node->prefix));
+	memcpy(node->prefix.s6_addr, addr->s6_addr, len / 8U);
+
+	if (len % 8U) {
+		node->prefix.s6_addr[len / 8U] = addr->s6_addr[len / 8U] &
+			(uint8_t)(0xff << (8 - len % 8U));
+	}
+
+	node->len = len;
+
+	return node;
+}
+
+static void trie_node_free(struct route_trie_node *node)
+{
+	node->child[0] = trie_free;
+	trie_free = node;
+}
+
+static int trie_insert(struct net_route_entry *route)
+{
+	const struct in6_addr *addr = &route->addr;
+	uint8_t len = route->prefix_len;
+	struct route_trie_node *node = &trie_root;
+	struct route_trie_node *child, *new, *glue;
+	struct route_trie_node **link;
+	uint8_t common = 0U;
+
+	while (node->len < len) {
+		link = &node->child[addr_bit(addr, node->len)];
+		child = *link;
+
+		if (child) {
+			common = common_prefix_len(addr, &child->prefix,
+						   MIN(len, child->len));
+			if (common == child->len) {
+				node = child;
+				continue;
+			}
+		}
+
+		new = trie_node_alloc(addr, len);
+		if (!new) {
+			return -ENOMEM;
+		}
+
+		if (!child) {
+			/* Empty branch */
+			*link = new;
+		} else if (common == len) {
+			/* The new prefix is a prefix of the child one */
+			new->child[addr_bit(&child->prefix, len)] = child;
+			*link = new;
+		} else {
+			/* The prefixes diverge, join them with a new node */
+			glue = trie_node_alloc(addr, common);
+			if (!glue) {
+				trie_node_free(new);
+				return -ENOMEM;
+			}
+
+			glue->child[addr_bit(&child->prefix, common)] = child;
+			glue->child[addr_bit(addr, common)] = new;
+			*link = glue;
+		}
+
+		node = new;
+	}
+
+	sys_slist_append(&node->routes, &route->prefix_node);
+
+	return 0;
+}
+
+static void trie_unlink(struct route_trie_node *parent,
+			struct route_trie_node *node)
+{
+	struct route_trie_node *child = node->child[0] ? node->child[0] :
+							  node->child[1];
+
+	parent->child[parent->child[0] == node ? 0 : 1] = child;
+
+	trie_node_free(node);
+}
+
+static void trie_remove(struct net_route_entry *route)
+{
+	struct route_trie_node *node = &trie_root;
+	struct route_trie_node *parent = NULL, *grandparent = NULL;
+	bool leaf;
+
+	while (node && node->len < route->prefix_len) {
+		grandparent = parent;
+		parent = node;
+		node = node->child[addr_bit(&route->addr, node->len)];
+	}
+
+	if (!node || node->len != route->prefix_len ||
+	    !sys_slist_find_and_remove(&node->routes, &route->prefix_node)) {
+		return;
+	}
+
+	if (node == &trie_root || !sys_slist_is_empty(&node->routes) ||
+	    (node->child[0] && node->child[1])) {
+		return;
+	}
+
+	leaf = !node->child[0] && !node->child[1];
+
+	trie_unlink(parent, node);
+
+	/* A node without routes that is left with one branch only is not
+	 * needed anymore.
+	 */
+	if (leaf && parent != &trie_root &&
+	    sys_slist_is_empty(&parent->routes)) {
+		trie_unlink(grandparent, parent);
+	}
+}
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
+{
+	struct route_trie_node *node = &trie_root;
+	struct net_route_entry *route, *found = NULL;
+
+	while (node && net_ipv6_is_prefix(dst->s6_addr, node->prefix.s6_addr,
+					  node->len)) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route,
+					     prefix_node) {
+			if (!iface || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->len == 128U) {
+			break;
+		}
+
+		node = node->child[addr_bit(dst, node->len)];
+	}
+
+	return found;
+}
+#else
+#define trie_insert(route) 0
+#define trie_remove(route)
+#endif /* CONFIG_NET_ROUTE_TRIE */
 
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
@@ -253,12 +467,13 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+#if !defined(CONFIG_NET_ROUTE_TRIE)
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
 {
 	struct net_route_entry *route, *found = NULL;
 	uint8_t longest_match = 0U;
@@ -286,6 +501,16 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+	return found;
+}
+#endif /* !CONFIG_NET_ROUTE_TRIE */
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+
+	found = route_find(iface, dst);
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -353,9 +578,9 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
-		sys_slist_find_and_remove(&routes, last);
+		sys_dlist_remove(last);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -401,7 +626,14 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
-	sys_slist_prepend(&routes, &route->node);
+	if (trie_insert(route) < 0) {
+		NET_ERR("No route trie node available!");
+		nbr_nexthop_put(tmp);
+		nbr_free(nbr);
+		return NULL;
+	}
+
+	sys_dlist_prepend(&routes, &route->node);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -414,6 +646,8 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 
 	net_route_info("Added", route, addr);
 
+	net_route_flow_flush();
+
 #if defined(CONFIG_NET_MGMT_EVENT_INFO)
 	net_ipaddr_copy(&info.addr, addr);
 	net_ipaddr_copy(&info.nexthop, nexthop);
@@ -454,7 +688,13 @@ int net_route_del(struct net_route_entry *route)
 	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route->iface);
 #endif
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+	}
+
+	trie_remove(route);
+
+	net_route_flow_flush();
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
@@ -821,6 +1061,190 @@ bool net_route_get_info(struct net_if *iface,
 	return false;
 }
 
+#if defined(CONFIG_NET_ROUTE_FLOW_CACHE)
+/* Forwarded flows remember their next hop neighbor, so that the following
+ * packets skip the address, route and neighbor lookups. The cache is direct
+ * mapped and a new flow simply replaces the one in its slot.
+ *
+ * Route changes flush the cache directly, as the events about them are
+ * delivered later and can be lost if the event queue is full. The other
+ * changes are caught with net_mgmt events, and a neighbor that got released
+ * or relinked meanwhile is detected when a flow is looked up.
+ */
+struct route_flow {
+	struct in6_addr src;
+	struct in6_addr dst;
+
+	/** Interface the flow is received from */
+	struct net_if *iface;
+
+	/** Next hop neighbor, NULL if the slot is unused */
+	struct net_nbr *nbr;
+
+	/** Link layer address index of the neighbor when it was cached */
+	uint8_t idx;
+};
+
+static struct route_flow flows[CONFIG_NET_ROUTE_FLOW_CACHE_SIZE];
+static struct k_spinlock flows_lock;
+
+static struct net_mgmt_event_callback flows_ipv6_cb;
+static struct net_mgmt_event_callback flows_iface_cb;
+
+static struct route_flow *flow_slot(struct net_if *iface,
+				    const struct in6_addr *src,
+				    const struct in6_addr *dst)
+{
+	uint32_t hash = POINTER_TO_UINT(iface);
+	int i;
+
+	/* Mix the addresses in order, so that the reply direction of a flow
+	 * does not land in the same slot.
+	 */
+	for (i = 0; i < 4; i++) {
+		hash = (hash ^ UNALIGNED_GET(&src->s6_addr32[i])) * 2654435769U;
+	}
+
+	for (i = 0; i < 4; i++) {
+		hash = (hash ^ UNALIGNED_GET(&dst->s6_addr32[i])) * 2654435769U;
+	}
+
+	return &flows[(hash >> 16) % ARRAY_SIZE(flows)];
+}
+
+void net_route_flow_add(struct net_if *iface,
+			const struct in6_addr *src,
+			const struct in6_addr *dst,
+			struct net_nbr *nbr)
+{
+	struct route_flow *flow = flow_slot(iface, src, dst);
+	k_spinlock_key_t key;
+
+	if (nbr->idx == NET_NBR_LLADDR_UNKNOWN) {
+		return;
+	}
+
+	key = k_spin_lock(&flows_lock);
+
+	net_ipaddr_copy(&flow->src, src);
+	net_ipaddr_copy(&flow->dst, dst);
+	flow->iface = iface;
+	flow->nbr = nbr;
+	flow->idx = nbr->idx;
+
+	k_spin_unlock(&flows_lock, key);
+}
+
+struct net_nbr *net_route_flow_lookup(struct net_if *iface,
+				      const struct in6_addr *src,
+				      const struct in6_addr *dst)
+{
+	struct route_flow *flow = flow_slot(iface, src, dst);
+	k_spinlock_key_t key;
+	struct net_nbr *nbr;
+
+	key = k_spin_lock(&flows_lock);
+
+	nbr = flow->nbr;
+	if (!nbr || flow->iface != iface ||
+	    !net_ipv6_addr_cmp(&flow->dst, dst) ||
+	    !net_ipv6_addr_cmp(&flow->src, src)) {
+		nbr = NULL;
+		goto out;
+	}
+
+	if (!nbr->ref || nbr->idx != flow->idx) {
+		flow->nbr = NULL;
+		nbr = NULL;
+	}
+
+out:
+	k_spin_unlock(&flows_lock, key);
+
+	return nbr;
+}
+
+enum net_verdict net_route_flow_forward(struct net_pkt *pkt,
+					struct net_ipv6_hdr *hdr)
+{
+	struct net_linkaddr_storage *lladdr;
+	struct net_nbr *nbr;
+
+	nbr = net_route_flow_lookup(net_pkt_iface(pkt), &hdr->src, &hdr->dst);
+	if (!nbr) {
+		return NET_CONTINUE;
+	}
+
+	lladdr = net_nbr_get_lladdr(nbr->idx);
+	if (!lladdr) {
+		return NET_CONTINUE;
+	}
+
+	/* As ipv6_route_packet() does, switch to the outgoing interface
+	 * first so that its link address becomes the source.
+	 */
+	net_pkt_set_orig_iface(pkt, net_pkt_iface(pkt));
+	net_pkt_set_iface(pkt, nbr->iface);
+	net_pkt_set_forwarding(pkt, true);
+
+	net_pkt_lladdr_src(pkt)->addr = net_pkt_lladdr_if(pkt)->addr;
+	net_pkt_lladdr_src(pkt)->type = net_pkt_lladdr_if(pkt)->type;
+	net_pkt_lladdr_src(pkt)->len = net_pkt_lladdr_if(pkt)->len;
+
+	net_pkt_lladdr_dst(pkt)->addr = lladdr->addr;
+	net_pkt_lladdr_dst(pkt)->type = lladdr->type;
+	net_pkt_lladdr_dst(pkt)->len = lladdr->len;
+
+	if (net_send_data(pkt) < 0) {
+		NET_DBG("Cannot forward cached flow pkt %p", pkt);
+		return NET_DROP;
+	}
+
+	return NET_OK;
+}
+
+void net_route_flow_flush(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&flows_lock);
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(flows); i++) {
+		flows[i].nbr = NULL;
+	}
+
+	k_spin_unlock(&flows_lock, key);
+}
+
+static void flows_event_handler(struct net_mgmt_event_callback *cb,
+				uint32_t mgmt_event, struct net_if *iface)
+{
+	ARG_UNUSED(cb);
+	ARG_UNUSED(iface);
+
+	NET_DBG("Flushing flows on event 0x%08x", mgmt_event);
+
+	net_route_flow_flush();
+}
+
+static void flows_init(void)
+{
+	net_mgmt_init_event_callback(&flows_ipv6_cb, flows_event_handler,
+				     NET_EVENT_IPV6_NBR_ADD |
+				     NET_EVENT_IPV6_NBR_DEL |
+				     NET_EVENT_IPV6_ROUTER_ADD |
+				     NET_EVENT_IPV6_ROUTER_DEL |
+				     NET_EVENT_IPV6_ADDR_ADD |
+				     NET_EVENT_IPV6_ADDR_DEL);
+	net_mgmt_add_event_callback(&flows_ipv6_cb);
+
+	net_mgmt_init_event_callback(&flows_iface_cb, flows_event_handler,
+				     NET_EVENT_IF_DOWN);
+	net_mgmt_add_event_callback(&flows_iface_cb);
+}
+#else
+#define flows_init(...)
+#endif /* CONFIG_NET_ROUTE_FLOW_CACHE */
+
 int net_route_packet(struct net_pkt *pkt, struct in6_addr *nexthop)
 {
 	struct net_linkaddr_storage *lladdr;
@@ -887,6 +1311,9 @@ int net_route_packet(struct net_pkt *pkt, struct in6_addr *nexthop)
 
 	net_pkt_set_iface(pkt, nbr->iface);
 
+	net_route_flow_add(net_pkt_orig_iface(pkt), &NET_IPV6_HDR(pkt)->src,
+			   &NET_IPV6_HDR(pkt)->dst, nbr);
+
 	return net_send_data(pkt);
 }
 
@@ -910,6 +1337,16 @@ int net_route_packet_if(struct net_pkt *pkt, struct net_if *iface)
 
 void net_route_init(void)
 {
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(trie_nodes); i++) {
+		trie_node_free(&trie_nodes[i]);
+	}
+#endif
+
+	flows_init();
+
 	NET_DBG("Allocated %d routing entries (%zu bytes)",
 		CONFIG_NET_MAX_ROUTES, sizeof(net_route_entries_pool));
 
@@ -15,8 +15,10 @@
 
 #include <kernel.h>
 #include <sys/slist.h>
+#include <sys/dlist.h>
 
 #include <net/net_ip.h>
+#include <net/net_core.h>
 
 #include "nbr.h"
 
@@ -46,7 +48,12 @@ struct net_route_entry {
 	 * we can remove it if we run out of available routes.
 	 * The oldest one is the last entry in the list.
 	 */
-	sys_snode_t node;
+	sys_dnode_t node;
+
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	/** Node in the list of routes having the same prefix. */
+	sys_snode_t prefix_node;
+#endif
 
 	/** List of neighbors that the routes go through. */
 	sys_slist_t nexthop;
@@ -290,6 +297,66 @@ int net_route_packet(struct net_pkt *pkt, struct in6_addr *nexthop);
  */
 int net_route_packet_if(struct net_pkt *pkt, struct net_if *iface);
 
+#if defined(CONFIG_NET_ROUTE_FLOW_CACHE)
+/**
+ * @brief Remember the next hop of a forwarded flow.
+ *
+ * @param iface Network interface the flow is received from.
+ * @param src Source IPv6 address of the flow.
+ * @param dst Destination IPv6 address of the flow.
+ * @param nbr Next hop neighbor the flow is forwarded to.
+ */
+void net_route_flow_add(struct net_if *iface,
+			const struct in6_addr *src,
+			const struct in6_addr *dst,
+			struct net_nbr *nbr);
+
+/**
+ * @brief Find the next hop of a forwarded flow.
+ *
+ * @param iface Network interface the flow is received from.
+ * @param src Source IPv6 address of the flow.
+ * @param dst Destination IPv6 address of the flow.
+ *
+ * @return Next hop neighbor, NULL if the flow is not cached.
+ */
+struct net_nbr *net_route_flow_lookup(struct net_if *iface,
+				      const struct in6_addr *src,
+				      const struct in6_addr *dst);
+
+/**
+ * @brief Forward a received packet using the flow cache.
+ *
+ * @param pkt Network packet to forward.
+ * @param hdr IPv6 header of the packet.
+ *
+ * @return NET_OK if the packet was sent, NET_DROP if sending it failed
+ * and NET_CONTINUE if its flow is not cached.
+ */
+enum net_verdict net_route_flow_forward(struct net_pkt *pkt,
+					struct net_ipv6_hdr *hdr);
+
+/**
+ * @brief Forget all the cached flows.
+ */
+void net_route_flow_flush(void);
+#else
+static inline void net_route_flow_add(struct net_if *iface,
+				      const struct in6_addr *src,
+				      const struct in6_addr *dst,
+				      struct net_nbr *nbr)
+{
+}
+
+static inline enum net_verdict net_route_flow_forward(
+	struct net_pkt *pkt, struct net_ipv6_hdr *hdr)
+{
+	return NET_CONTINUE;
+}
+
+#define net_route_flow_flush(...)
+#endif /* CONFIG_NET_ROUTE_FLOW_CACHE */
+
 #if defined(CONFIG_NET_ROUTE) && defined(CONFIG_NET_NATIVE)
 void net_route_init(void);
 #else
@@ -30,13 +30,26 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 #define ACK_TIMEOUT K_MSEC(ACK_TIMEOUT_MS)
 #define FIN_TIMEOUT_MS MSEC_PER_SEC
 #define FIN_TIMEOUT K_MSEC(FIN_TIMEOUT_MS)
+#define DUP_ACK_THRESHOLD 3
 
 static int tcp_rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
 static int tcp_retries = CONFIG_NET_TCP_RETRY_COUNT;
+#if defined(CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE) && \
+	CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE
+static int tcp_window = CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE;
+#else
 static int tcp_window = NET_IPV6_MTU;
+#endif
 
 static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
+/* Connections with both endpoints known, hashed on the 4-tuple. The lock
+ * also covers dropping the last reference of a hashed connection.
+ */
+static sys_slist_t tcp_conns_hash[CONFIG_NET_TCP_CONN_HASH_BUCKETS];
+static struct k_spinlock tcp_conns_hash_lock;
+
+/* Protects tcp_conns, segments are processed under the connection lock */
 static K_MUTEX_DEFINE(tcp_lock);
 
 static K_MEM_SLAB_DEFINE(tcp_conns_slab, sizeof(struct tcp),
@@ -352,38 +365,85 @@ static void tcp_send_queue_flush(struct tcp *conn)
 	}
 }
 
-#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
-#define tcp_conn_unref(conn)				\
-	tcp_conn_unref_debug(conn, __func__, __LINE__)
+static uint32_t tcp_conn_hash(const union tcp_endpoint *local,
+			      const union tcp_endpoint *remote)
+{
+	const uint8_t *l = local->sin.sin_addr.s4_addr;
+	const uint8_t *r = remote->sin.sin_addr.s4_addr;
+	size_t len = sizeof(struct in_addr);
+	uint32_t hash;
+	size_t i;
 
-static int tcp_conn_unref_debug(struct tcp *conn, const char *caller, int line)
-#else
-static int tcp_conn_unref(struct tcp *conn)
-#endif
+	if (IS_ENABLED(CONFIG_NET_IPV6) && local->sa.sa_family == AF_INET6) {
+		l = local->sin6.sin6_addr.s6_addr;
+		r = remote->sin6.sin6_addr.s6_addr;
+		len = sizeof(struct in6_addr);
+	}
+
+	hash = (uint32_t)local->sin.sin_port << 16 | remote->sin.sin_port;
+
+	for (i = 0; i < len; i += sizeof(uint32_t)) {
+		hash = (hash ^ UNALIGNED_GET((const uint32_t *)&l[i])) *
+			0x9e3779b1U;
+		hash = (hash ^ UNALIGNED_GET((const uint32_t *)&r[i])) *
+			0x9e3779b1U;
+	}
+
+	return hash ^ (hash >> 16);
+}
+
+/* Must be called with tcp_conns_hash_lock held */
+static void tcp_conn_hash_remove(struct tcp *conn)
 {
-	int ref_count = atomic_get(&conn->ref_count);
-	struct net_pkt *pkt;
+	sys_slist_find_and_remove(
+		&tcp_conns_hash[conn->hash % CONFIG_NET_TCP_CONN_HASH_BUCKETS],
+		&conn->hash_node);
+	conn->hashed = false;
+}
 
-#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
-	NET_DBG("conn: %p, ref_count=%d (%s():%d)", conn, ref_count,
-		caller, line);
-#endif
+/* Make the connection visible to tcp_conn_search() once its endpoints
+ * are set.
+ */
+static void tcp_conn_hash_add(struct tcp *conn)
+{
+	k_spinlock_key_t key = k_spin_lock(&tcp_conns_hash_lock);
 
-#if !defined(CONFIG_NET_TEST_PROTOCOL)
-	if (conn->in_connect) {
-		NET_DBG("conn: %p is waiting on connect semaphore", conn);
-		tcp_send_queue_flush(conn);
-		goto out;
+	if (conn->hashed) {
+		tcp_conn_hash_remove(conn);
 	}
-#endif /* CONFIG_NET_TEST_PROTOCOL */
 
-	k_mutex_lock(&tcp_lock, K_FOREVER);
+	conn->hash = tcp_conn_hash(&conn->src, &conn->dst);
+	sys_slist_prepend(
+		&tcp_conns_hash[conn->hash % CONFIG_NET_TCP_CONN_HASH_BUCKETS],
+		&conn->hash_node);
+	conn->hashed = true;
+
+	k_spin_unlock(&tcp_conns_hash_lock, key);
+}
+
+/* Drop a reference and free the connection when it was the last one */
+static int tcp_conn_release(struct tcp *conn)
+{
+	k_spinlock_key_t key;
+	struct net_pkt *pkt;
+	int ref_count;
+
+	/* The last reference is dropped under the hash lock so that a
+	 * concurrent lookup cannot pick up a connection being freed.
+	 */
+	key = k_spin_lock(&tcp_conns_hash_lock);
 
 	ref_count = atomic_dec(&conn->ref_count) - 1;
+	if (!ref_count && conn->hashed) {
+		tcp_conn_hash_remove(conn);
+	}
+
+	k_spin_unlock(&tcp_conns_hash_lock, key);
+
 	if (ref_count) {
 		tp_out(net_context_get_family(conn->context), conn->iface,
 		       "TP_TRACE", "event", "CONN_DELETE");
-		goto unlock;
+		return ref_count;
 	}
 
 	/* If there is any pending data, pass that to application */
@@ -417,22 +477,50 @@ static int tcp_conn_unref(struct tcp *conn)
 	tcp_pkt_unref(conn->send_data);
 
 	if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
+		/* The timer must not stay linked in the memory freed below */
+		k_work_cancel_delayable(&conn->recv_queue_timer);
 		tcp_pkt_unref(conn->queue_recv_data);
 	}
 
 	k_work_cancel_delayable(&conn->timewait_timer);
 	k_work_cancel_delayable(&conn->fin_timer);
 
+	k_mutex_lock(&tcp_lock, K_FOREVER);
 	sys_slist_find_and_remove(&tcp_conns, &conn->next);
+	k_mutex_unlock(&tcp_lock);
 
 	memset(conn, 0, sizeof(*conn));
 
 	k_mem_slab_free(&tcp_conns_slab, (void **)&conn);
 
-unlock:
-	k_mutex_unlock(&tcp_lock);
-out:
-	return ref_count;
+	return 0;
+}
+
+#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
+#define tcp_conn_unref(conn)				\
+	tcp_conn_unref_debug(conn, __func__, __LINE__)
+
+static int tcp_conn_unref_debug(struct tcp *conn, const char *caller, int line)
+#else
+static int tcp_conn_unref(struct tcp *conn)
+#endif
+{
+	int ref_count = atomic_get(&conn->ref_count);
+
+#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
+	NET_DBG("conn: %p, ref_count=%d (%s():%d)", conn, ref_count,
+		caller, line);
+#endif
+
+#if !defined(CONFIG_NET_TEST_PROTOCOL)
+	if (conn->in_connect) {
+		NET_DBG("conn: %p is waiting on connect semaphore", conn);
+		tcp_send_queue_flush(conn);
+		return ref_count;
+	}
+#endif /* CONFIG_NET_TEST_PROTOCOL */
+
+	return tcp_conn_release(conn);
 }
 
 int net_tcp_unref(struct net_context *context)
@@ -613,8 +701,12 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
-	recv_options->wnd_found = false;
+	/* The MSS, window scale and SACK permitted options are only sent in
+	 * SYN segments, so keep what was negotiated.
+	 */
+#if defined(CONFIG_NET_TCP_SACK)
+	recv_options->sack_count = 0;
+#endif
 
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
@@ -658,9 +750,36 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 				goto end;
 			}
 
-			recv_options->window = opt;
+			recv_options->window = MIN(options[2], TCP_WSCALE_MAX);
 			recv_options->wnd_found = true;
+			NET_DBG("WS=%hu", recv_options->window);
+			break;
+		case TCPOPT_SACK_PERM:
+			if (opt_len != 2) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm = true;
+			break;
+#if defined(CONFIG_NET_TCP_SACK)
+		case TCPOPT_SACK:
+			if ((opt_len - 2) % 8) {
+				result = false;
+				goto end;
+			}
+
+			for (int i = 0; i < (opt_len - 2) / 8 &&
+				     i < TCP_SACK_BLOCKS; i++) {
+				struct tcp_sack_block *blk =
+					&recv_options->sack[i];
+
+				blk->start = sys_get_be32(options + 2 + i * 8);
+				blk->end = sys_get_be32(options + 6 + i * 8);
+				recv_options->sack_count++;
+			}
 			break;
+#endif
 		default:
 			continue;
 		}
@@ -718,6 +837,19 @@ static int tcp_data_get(struct tcp *conn, struct net_pkt *pkt, size_t *len)
 			goto out;
 		}
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+		/* Charge the data to the context before it is acknowledged.
+		 * Data over the quota is dropped unacknowledged, so the peer
+		 * sends it again once the application has read some.
+		 */
+		if (net_pkt_quota_move(up, &conn->context->rx_quota) < 0) {
+			net_stats_update_pkt_rx_quota_drop(conn->iface);
+			tcp_pkt_unref(up);
+			ret = -ENOBUFS;
+			goto out;
+		}
+#endif
+
 		/* If there is any out-of-order pending data, then pass it
 		 * to the application here.
 		 */
@@ -755,31 +887,97 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+/* Fill in the options of an outgoing segment, the buffer must hold 40 bytes.
+ * Returns the length of the options, a multiple of 4.
+ */
+static size_t tcp_options_build(struct tcp *conn, uint8_t flags, uint8_t *buf)
+{
+	size_t len = 0;
+
+	if (flags & SYN) {
+		/* In a SYN-ACK only answer to what the peer has offered */
+		bool reply = flags & ACK;
+
+		if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) &&
+		    (!reply || conn->recv_options.wnd_found)) {
+			buf[len++] = TCPOPT_NOP;
+			buf[len++] = TCPOPT_WINDOW;
+			buf[len++] = 3;
+			buf[len++] = conn->rcv_wscale;
+		}
+
+		if (IS_ENABLED(CONFIG_NET_TCP_SACK) &&
+		    (!reply || conn->recv_options.sack_perm)) {
+			buf[len++] = TCPOPT_NOP;
+			buf[len++] = TCPOPT_NOP;
+			buf[len++] = TCPOPT_SACK_PERM;
+			buf[len++] = 2;
+		}
+
+		return len;
+	}
+
+#if defined(CONFIG_NET_TCP_SACK)
+	/* The out-of-order queue is a single contiguous run of data, so it
+	 * is described by one block.
+	 */
+	if (conn->sack_ok && (flags & ACK) &&
+	    CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT &&
+	    !net_pkt_is_empty(conn->queue_recv_data)) {
+		struct net_buf *first = conn->queue_recv_data->buffer;
+		struct net_buf *last = net_buf_frag_last(first);
+
+		buf[len++] = TCPOPT_NOP;
+		buf[len++] = TCPOPT_NOP;
+		buf[len++] = TCPOPT_SACK;
+		buf[len++] = 10;
+		sys_put_be32(tcp_get_seq(first), buf + len);
+		sys_put_be32(tcp_get_seq(last) + last->len, buf + len + 4);
+		len += 8;
+	}
+#endif
+
+	return len;
+}
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
-			  uint32_t seq)
+			  uint32_t seq, const uint8_t *options,
+			  size_t options_len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct tcphdr *th;
+	uint32_t win = conn->recv_win;
+	int ret;
 
 	th = (struct tcphdr *)net_pkt_get_data(pkt, &tcp_access);
 	if (!th) {
 		return -ENOBUFS;
 	}
 
+	/* The window of a SYN segment is never scaled */
+	if (conn->wscale_ok && !(flags & SYN)) {
+		win >>= conn->rcv_wscale;
+	}
+
 	memset(th, 0, sizeof(struct tcphdr));
 
 	UNALIGNED_PUT(conn->src.sin.sin_port, &th->th_sport);
 	UNALIGNED_PUT(conn->dst.sin.sin_port, &th->th_dport);
-	th->th_off = 5;
+	th->th_off = 5 + options_len / 4;
 	UNALIGNED_PUT(flags, &th->th_flags);
-	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
+	UNALIGNED_PUT(htons(MIN(win, UINT16_MAX)), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
 
 	if (ACK & flags) {
 		UNALIGNED_PUT(htonl(conn->ack), &th->th_ack);
 	}
 
-	return net_pkt_set_data(pkt, &tcp_access);
+	ret = net_pkt_set_data(pkt, &tcp_access);
+	if (ret < 0 || !options_len) {
+		return ret;
+	}
+
+	return net_pkt_write(pkt, options, options_len);
 }
 
 static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
@@ -802,16 +1000,29 @@ static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
 static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		       uint32_t seq)
 {
+	uint8_t options[40];
+	size_t options_len;
 	struct net_pkt *pkt;
 	int ret = 0;
 
-	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr));
+	options_len = tcp_options_build(conn, flags, options);
+
+	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr) + options_len);
 	if (!pkt) {
 		ret = -ENOBUFS;
 		goto out;
 	}
 
 	if (data) {
+		/* Data larger than the MSS is cut into segments before it
+		 * reaches the wire, see net_tcp_gso_send().
+		 */
+		if (IS_ENABLED(CONFIG_NET_TCP_GSO) &&
+		    net_pkt_get_len(data) > conn_mss(conn)) {
+			net_pkt_set_gso_size(pkt, conn_mss(conn));
+			net_stats_update_tcp_seg_gso(conn->iface);
+		}
+
 		/* Append the data buffer to the pkt */
 		net_pkt_append_buffer(pkt, data->buffer);
 		data->buffer = NULL;
@@ -823,7 +1034,7 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		goto out;
 	}
 
-	ret = tcp_header_add(conn, pkt, flags, seq);
+	ret = tcp_header_add(conn, pkt, flags, seq, options, options_len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
 		goto out;
@@ -897,6 +1108,27 @@ static bool tcp_window_full(struct tcp *conn)
 	return window_full;
 }
 
+static uint32_t tcp_sacked_len(struct tcp *conn)
+{
+	uint32_t len = 0;
+
+#if defined(CONFIG_NET_TCP_SACK)
+	for (int i = 0; i < conn->sacked_count; i++) {
+		len += conn->sacked[i].end - conn->sacked[i].start;
+	}
+#endif
+
+	return len;
+}
+
+/* The data in flight (RFC 6675 "pipe") is limited by the congestion window */
+static bool tcp_cwnd_full(struct tcp *conn)
+{
+	uint32_t pipe = conn->unacked_len - tcp_sacked_len(conn);
+
+	return pipe >= conn->cwnd;
+}
+
 static int tcp_unsent_len(struct tcp *conn)
 {
 	int unsent_len;
@@ -915,17 +1147,12 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
-static int tcp_send_data(struct tcp *conn)
+/* Send len bytes of send_data starting at offset pos */
+static int tcp_send_segment(struct tcp *conn, int pos, int len, bool resend)
 {
 	int ret = 0;
-	int pos, len;
 	struct net_pkt *pkt;
 
-	pos = conn->unacked_len;
-	len = MIN3(conn->send_data_total - conn->unacked_len,
-		   conn->send_win - conn->unacked_len,
-		   conn_mss(conn));
-
 	pkt = tcp_pkt_alloc(conn, len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
@@ -940,11 +1167,9 @@ static int tcp_send_data(struct tcp *conn)
 		goto out;
 	}
 
-	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
+	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + pos);
 	if (ret == 0) {
-		conn->unacked_len += len;
-
-		if (conn->data_mode == TCP_DATA_MODE_RESEND) {
+		if (resend) {
 			net_stats_update_tcp_resent(conn->iface, len);
 			net_stats_update_tcp_seg_rexmit(conn->iface);
 		} else {
@@ -958,13 +1183,301 @@ static int tcp_send_data(struct tcp *conn)
 	 * the packet anyway.
 	 */
 	tcp_pkt_unref(pkt);
+ out:
+	return ret;
+}
+
+/* Largest amount of data to send in one packet. With segmentation offload
+ * this is as many full segments as the congestion window allows.
+ */
+static int tcp_send_max(struct tcp *conn)
+{
+	int mss = conn_mss(conn);
+#if defined(CONFIG_NET_TCP_GSO)
+	uint32_t pipe = conn->unacked_len - tcp_sacked_len(conn);
+	int room;
+
+	room = conn->cwnd > pipe ? conn->cwnd - pipe : 0;
+	room = MIN(room, CONFIG_NET_TCP_GSO_MAX_SIZE);
+
+	return MAX(room - room % mss, mss);
+#else
+	return mss;
+#endif
+}
+
+static int tcp_send_data(struct tcp *conn)
+{
+	bool resend = conn->data_mode == TCP_DATA_MODE_RESEND;
+	int ret;
+	int pos, len;
+
+	pos = conn->unacked_len;
+	len = MIN3(conn->send_data_total - conn->unacked_len,
+		   conn->send_win - conn->unacked_len,
+		   tcp_send_max(conn));
+
+	ret = tcp_send_segment(conn, pos, len, resend);
+	if (ret == -ENOBUFS && len > conn_mss(conn)) {
+		/* Not enough buffers for a large packet, try one segment */
+		len = conn_mss(conn);
+		ret = tcp_send_segment(conn, pos, len, resend);
+	}
+	if (ret == 0) {
+		conn->unacked_len += len;
+
+		/* Time one segment per RTT, but never a retransmitted one
+		 * (Karn's algorithm).
+		 */
+		if (!conn->rtt_pending &&
+		    conn->data_mode == TCP_DATA_MODE_SEND) {
+			conn->rtt_pending = true;
+			conn->rtt_seq = conn->seq + conn->unacked_len;
+			conn->rtt_start = k_uptime_get_32();
+		}
+	}
 
 	conn_send_data_dump(conn);
 
- out:
 	return ret;
 }
 
+/* Retransmit at most one MSS from rexmit_next on, skipping the data the peer
+ * has selectively acknowledged. If holes_only is set, only data below a
+ * SACKed range is sent, i.e. data known to be missing at the peer.
+ */
+static int tcp_retransmit_hole(struct tcp *conn, bool holes_only)
+{
+	uint32_t start = conn->rexmit_next;
+	uint32_t end = conn->seq + conn->unacked_len;
+	bool hole = false;
+	int ret;
+
+	if (net_tcp_seq_cmp(start, conn->seq) < 0) {
+		start = conn->seq;
+	}
+
+#if defined(CONFIG_NET_TCP_SACK)
+	for (int i = 0; i < conn->sacked_count; i++) {
+		struct tcp_sack_block *blk = &conn->sacked[i];
+
+		if (net_tcp_seq_cmp(start, blk->start) < 0) {
+			end = blk->start;
+			hole = true;
+			break;
+		}
+
+		if (net_tcp_seq_cmp(start, blk->end) < 0) {
+			start = blk->end;
+		}
+	}
+#endif
+
+	if ((holes_only && !hole) || net_tcp_seq_cmp(end, start) <= 0) {
+		return 0;
+	}
+
+	ret = tcp_send_segment(conn, start - conn->seq,
+			       MIN(end - start, conn_mss(conn)), true);
+	if (ret == 0) {
+		conn->rexmit_next = start + MIN(end - start, conn_mss(conn));
+		conn->rtt_pending = false;
+	}
+
+	NET_DBG("conn: %p retransmit seq %u ret %d", conn, start, ret);
+
+	return ret;
+}
+
+#if defined(CONFIG_NET_TCP_SACK)
+/* Merge the SACK blocks of the received segment into the scoreboard */
+static void tcp_sack_update(struct tcp *conn)
+{
+	uint32_t snd_nxt = conn->seq + conn->unacked_len;
+	struct tcp_sack_block merged[TCP_SACK_BLOCKS + 1];
+	int i, j, count;
+
+	/* Forget what the cumulative ACK has covered */
+	for (i = 0, j = 0; i < conn->sacked_count; i++) {
+		struct tcp_sack_block blk = conn->sacked[i];
+
+		if (net_tcp_seq_cmp(blk.end, conn->seq) <= 0) {
+			continue;
+		}
+
+		if (net_tcp_seq_cmp(blk.start, conn->seq) < 0) {
+			blk.start = conn->seq;
+		}
+
+		conn->sacked[j++] = blk;
+	}
+
+	conn->sacked_count = j;
+
+	if (!conn->sack_ok) {
+		return;
+	}
+
+	for (int n = 0; n < conn->recv_options.sack_count; n++) {
+		struct tcp_sack_block blk = conn->recv_options.sack[n];
+		bool placed = false;
+
+		/* Ignore blocks outside of the data in flight */
+		if (net_tcp_seq_cmp(blk.start, conn->seq) < 0 ||
+		    net_tcp_seq_cmp(blk.end, snd_nxt) > 0 ||
+		    net_tcp_seq_cmp(blk.end, blk.start) <= 0) {
+			continue;
+		}
+
+		for (i = 0, count = 0; i < conn->sacked_count; i++) {
+			struct tcp_sack_block *cur = &conn->sacked[i];
+
+			if (net_tcp_seq_cmp(cur->end, blk.start) < 0) {
+				merged[count++] = *cur;
+			} else if (net_tcp_seq_cmp(blk.end, cur->start) < 0) {
+				if (!placed) {
+					merged[count++] = blk;
+					placed = true;
+				}
+
+				merged[count++] = *cur;
+			} else {
+				/* Overlapping or adjacent */
+				if (net_tcp_seq_cmp(cur->start, blk.start) < 0) {
+					blk.start = cur->start;
+				}
+
+				if (net_tcp_seq_cmp(cur->end, blk.end) > 0) {
+					blk.end = cur->end;
+				}
+			}
+		}
+
+		if (!placed) {
+			merged[count++] = blk;
+		}
+
+		/* If the scoreboard is full, the highest block is dropped */
+		conn->sacked_count = MIN(count, TCP_SACK_BLOCKS);
+		memcpy(conn->sacked, merged,
+		       conn->sacked_count * sizeof(merged[0]));
+	}
+}
+#else
+static inline void tcp_sack_update(struct tcp *conn)
+{
+	ARG_UNUSED(conn);
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
+static void tcp_sack_clear(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_SACK)
+	conn->sacked_count = 0;
+#endif
+}
+
+/* RTT estimation and RTO computation as described in RFC 6298 */
+static void tcp_rtt_update(struct tcp *conn, uint32_t rtt)
+{
+	int32_t delta;
+
+	rtt = MAX(rtt, 1U);
+
+	if (!conn->srtt) {
+		conn->srtt = rtt << 3;
+		conn->rttvar = rtt << 1;
+	} else {
+		delta = rtt - (conn->srtt >> 3);
+		conn->srtt += delta;
+
+		if (delta < 0) {
+			delta = -delta;
+		}
+
+		delta -= conn->rttvar >> 2;
+		conn->rttvar += delta;
+	}
+
+	conn->rto = CLAMP((conn->srtt >> 3) + MAX(conn->rttvar, 1U),
+			  (uint32_t)tcp_rto, CONFIG_NET_TCP_RTO_MAX);
+
+	NET_DBG("conn: %p rtt=%u srtt=%u rttvar=%u rto=%u", conn, rtt,
+		conn->srtt >> 3, conn->rttvar >> 2, conn->rto);
+}
+
+/* The retransmission timer is doubled after every expiry */
+static k_timeout_t tcp_rto_timeout(struct tcp *conn)
+{
+	uint64_t rto = (uint64_t)conn->rto << MIN(conn->send_data_retries, 16);
+
+	return K_MSEC(MIN(rto, CONFIG_NET_TCP_RTO_MAX));
+}
+
+/* New data was cumulatively acknowledged, conn->seq has been updated */
+static void tcp_new_ack(struct tcp *conn, uint32_t acked)
+{
+	if (conn->rtt_pending &&
+	    net_tcp_seq_cmp(conn->seq, conn->rtt_seq) >= 0) {
+		tcp_rtt_update(conn, k_uptime_get_32() - conn->rtt_start);
+		conn->rtt_pending = false;
+	}
+
+	tcp_sack_update(conn);
+	conn->dup_acks = 0;
+
+	if (!conn->in_recovery) {
+		conn->cc->ack(conn, acked);
+		return;
+	}
+
+	if (net_tcp_seq_cmp(conn->seq, conn->recover) >= 0) {
+		/* Full acknowledgment, RFC 6582 chapter 3.2 step 3 */
+		conn->in_recovery = false;
+		conn->cwnd = conn->ssthresh;
+		return;
+	}
+
+	/* Partial acknowledgment: the next segment was lost as well.
+	 * Retransmit it and deflate the window by the amount acknowledged.
+	 */
+	(void)tcp_retransmit_hole(conn, false);
+
+	conn->cwnd -= MIN(conn->cwnd, acked);
+	conn->cwnd += conn_mss(conn);
+}
+
+static void tcp_dup_ack(struct tcp *conn)
+{
+	tcp_sack_update(conn);
+
+	if (conn->in_recovery) {
+		/* Every duplicate ACK means a segment has left the network */
+		conn->cwnd += conn_mss(conn);
+
+		if (conn->sack_ok) {
+			(void)tcp_retransmit_hole(conn, true);
+		}
+
+		return;
+	}
+
+	if (++conn->dup_acks < DUP_ACK_THRESHOLD) {
+		return;
+	}
+
+	NET_DBG("conn: %p fast retransmit seq %u", conn, conn->seq);
+
+	/* Fast retransmit and fast recovery, RFC 5681 chapter 3.2 */
+	conn->cc->loss(conn, false);
+	conn->cwnd = conn->ssthresh + DUP_ACK_THRESHOLD * conn_mss(conn);
+	conn->recover = conn->seq + conn->unacked_len;
+	conn->rexmit_next = conn->seq;
+	conn->in_recovery = true;
+
+	(void)tcp_retransmit_hole(conn, false);
+}
+
 /* Send all queued but unsent data from the send_data packet by packet
  * until the receiver's window is full. */
 static int tcp_send_queued_data(struct tcp *conn)
@@ -978,7 +1491,7 @@ static int tcp_send_queued_data(struct tcp *conn)
 
 	while (tcp_unsent_len(conn) > 0) {
 
-		if (tcp_window_full(conn)) {
+		if (tcp_window_full(conn) || tcp_cwnd_full(conn)) {
 			subscribe = true;
 			break;
 		}
@@ -1008,7 +1521,7 @@ static int tcp_send_queued_data(struct tcp *conn)
 	if (subscribe) {
 		conn->send_data_retries = 0;
 		k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer,
-					    K_MSEC(tcp_rto));
+					    tcp_rto_timeout(conn));
 	}
  out:
 	return ret;
@@ -1046,13 +1559,33 @@ static void tcp_resend_data(struct k_work *work)
 		goto out;
 	}
 
+	/* Everything in flight is considered lost, go back to the oldest
+	 * unacknowledged byte. The SACK information is not trusted after
+	 * a timeout as the peer may have discarded the data (RFC 2018
+	 * chapter 8).
+	 */
+	if (conn->unacked_len > 0) {
+		if (conn->send_data_retries == 0) {
+			conn->cc->loss(conn, true);
+		}
+
+		conn->cwnd = conn_mss(conn);
+	}
+
+	conn->in_recovery = false;
+	conn->dup_acks = 0;
+	conn->rtt_pending = false;
+	tcp_sack_clear(conn);
+
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
+	/* A resend that found no buffers still counts, or a connection
+	 * starved of buffers would be retried forever.
+	 */
 	ret = tcp_send_data(conn);
+	conn->send_data_retries++;
 	if (ret == 0) {
-		conn->send_data_retries++;
-
 		if (conn->in_close && conn->send_data_total == 0) {
 			NET_DBG("TCP connection in active close, "
 				"not disposing yet (waiting %dms)",
@@ -1073,7 +1606,7 @@ static void tcp_resend_data(struct k_work *work)
 	}
 
 	k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer,
-				    K_MSEC(tcp_rto));
+				    tcp_rto_timeout(conn));
 
  out:
 	k_mutex_unlock(&conn->lock);
@@ -1159,6 +1692,14 @@ static struct tcp *tcp_conn_alloc(void)
 	conn->in_connect = false;
 	conn->state = TCP_LISTEN;
 	conn->recv_win = tcp_window;
+	conn->rto = tcp_rto;
+	conn->cc = TCP_CC_DEFAULT;
+	conn->cc->init(conn);
+
+	while (conn->rcv_wscale < TCP_WSCALE_MAX &&
+	       (conn->recv_win >> conn->rcv_wscale) > UINT16_MAX) {
+		conn->rcv_wscale++;
+	}
 
 	/* The ISN value will be set when we get the connection attempt or
 	 * when trying to create a connection.
@@ -1213,40 +1754,240 @@ out:
 	return ret;
 }
 
-static bool tcp_endpoint_cmp(union tcp_endpoint *ep, struct net_pkt *pkt,
-			     enum pkt_addr which)
+/* Find the connection of a segment. A reference is taken on the returned
+ * connection, the caller releases it with tcp_conn_release().
+ */
+static struct tcp *tcp_conn_search(struct net_pkt *pkt)
+{
+	union tcp_endpoint local, remote;
+	struct tcp *found = NULL;
+	k_spinlock_key_t key;
+	struct tcp *conn;
+	uint32_t hash;
+	size_t len;
+
+	if (tcp_endpoint_set(&local, pkt, TCP_EP_DST) < 0 ||
+	    tcp_endpoint_set(&remote, pkt, TCP_EP_SRC) < 0) {
+		return NULL;
+	}
+
+	hash = tcp_conn_hash(&local, &remote);
+	len = tcp_endpoint_len(local.sa.sa_family);
+
+	key = k_spin_lock(&tcp_conns_hash_lock);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(
+		&tcp_conns_hash[hash % CONFIG_NET_TCP_CONN_HASH_BUCKETS],
+		conn, hash_node) {
+		if (conn->hash == hash && !memcmp(&conn->src, &local, len) &&
+		    !memcmp(&conn->dst, &remote, len)) {
+			atomic_inc(&conn->ref_count);
+			found = conn;
+			break;
+		}
+	}
+
+	k_spin_unlock(&tcp_conns_hash_lock, key);
+
+	return found;
+}
+
+#if defined(CONFIG_NET_TCP_GRO)
+/* Connections holding a coalesced segment, each entry holds a reference */
+static sys_slist_t tcp_gro_list = SYS_SLIST_STATIC_INIT(&tcp_gro_list);
+static struct k_spinlock tcp_gro_lock;
+
+static void tcp_gro_list_add(struct tcp *conn)
+{
+	k_spinlock_key_t key = k_spin_lock(&tcp_gro_lock);
+
+	if (!conn->gro_listed) {
+		tcp_conn_ref(conn);
+		sys_slist_append(&tcp_gro_list, &conn->gro_node);
+		conn->gro_owner = k_current_get();
+		conn->gro_listed = true;
+	}
+
+	k_spin_unlock(&tcp_gro_lock, key);
+}
+
+/* Returns true if the caller now owns the reference of the list entry */
+static bool tcp_gro_list_remove(struct tcp *conn)
+{
+	k_spinlock_key_t key = k_spin_lock(&tcp_gro_lock);
+	bool removed = conn->gro_listed;
+
+	if (removed) {
+		sys_slist_find_and_remove(&tcp_gro_list, &conn->gro_node);
+		conn->gro_listed = false;
+	}
+
+	k_spin_unlock(&tcp_gro_lock, key);
+
+	return removed;
+}
+
+/* A data segment without options or flags other than ACK */
+static bool tcp_gro_mergeable(struct net_pkt *pkt, bool push_ok)
+{
+	struct tcphdr *th = th_get(pkt);
+	uint8_t flags = push_ok ? ACK | PSH : ACK;
+
+	return th && th_off(th) == 5 && (th_flags(th) & ACK) &&
+		!(th_flags(th) & ~flags) && tcp_data_len(pkt) > 0;
+}
+
+/* Append the data of pkt to the held segment if it directly follows it */
+static bool tcp_gro_merge(struct net_pkt *held, struct net_pkt *pkt)
 {
-	union tcp_endpoint ep_tmp;
+	size_t held_len = tcp_data_len(held);
+	struct tcphdr *held_th = th_get(held);
+	struct tcphdr *th;
+
+	if (!tcp_gro_mergeable(pkt, true) ||
+	    held_len + tcp_data_len(pkt) > CONFIG_NET_TCP_GRO_MAX_SIZE) {
+		return false;
+	}
 
-	if (tcp_endpoint_set(&ep_tmp, pkt, which) < 0) {
+	th = th_get(pkt);
+	if (th_seq(th) != th_seq(held_th) + held_len ||
+	    net_tcp_seq_cmp(th_ack(th), th_ack(held_th)) < 0) {
 		return false;
 	}
 
-	return !memcmp(ep, &ep_tmp, tcp_endpoint_len(ep->sa.sa_family));
+	/* The latest acknowledgment and window are the ones that count */
+	UNALIGNED_PUT(UNALIGNED_GET(&th->th_ack), &held_th->th_ack);
+	UNALIGNED_PUT(UNALIGNED_GET(&th->th_win), &held_th->th_win);
+	UNALIGNED_PUT(th_flags(held_th) | th_flags(th), &held_th->th_flags);
+
+	tcp_pkt_pull(pkt, net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt) +
+		     sizeof(*th));
+	net_pkt_append_buffer(held, pkt->buffer);
+	pkt->buffer = NULL;
+	net_pkt_unref(pkt);
+
+	/* The checksums were verified already, only keep the lengths right */
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(held) == AF_INET) {
+		NET_IPV4_HDR(held)->len = htons(net_pkt_get_len(held));
+	} else if (IS_ENABLED(CONFIG_NET_IPV6)) {
+		NET_IPV6_HDR(held)->len = htons(net_pkt_get_len(held) -
+						sizeof(struct net_ipv6_hdr));
+	}
+
+	return true;
 }
 
-static bool tcp_conn_cmp(struct tcp *conn, struct net_pkt *pkt)
+/* Can no more data be appended to the held segment */
+static bool tcp_gro_full(struct tcp *conn, struct net_pkt *held)
 {
-	return tcp_endpoint_cmp(&conn->src, pkt, TCP_EP_DST) &&
-		tcp_endpoint_cmp(&conn->dst, pkt, TCP_EP_SRC);
+	return (th_flags(th_get(held)) & PSH) ||
+		tcp_data_len(held) + conn_mss(conn) >
+		CONFIG_NET_TCP_GRO_MAX_SIZE;
 }
 
-static struct tcp *tcp_conn_search(struct net_pkt *pkt)
+static void tcp_gro_deliver(struct tcp *conn, struct net_pkt *pkt)
 {
-	bool found = false;
-	struct tcp *conn;
-	struct tcp *tmp;
+	tcp_in(conn, pkt);
+	net_pkt_unref(pkt);
+}
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp_conns, conn, tmp, next) {
+/* Coalesce a received segment with the previous ones of the connection.
+ * A segment is only held while more packets are queued for the RX thread,
+ * which calls net_tcp_gro_flush() once the queue is empty. Returns true if
+ * the segment was consumed.
+ */
+static bool tcp_gro_receive(struct tcp *conn, struct net_pkt *pkt)
+{
+	struct net_pkt *flush = NULL;
+	bool consumed = true;
+	bool release = false;
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	if (conn->gro_pkt && tcp_gro_merge(conn->gro_pkt, pkt)) {
+		net_stats_update_tcp_seg_gro(conn->iface);
+
+		if (tcp_gro_full(conn, conn->gro_pkt)) {
+			flush = conn->gro_pkt;
+			conn->gro_pkt = NULL;
+			release = tcp_gro_list_remove(conn);
+		}
+	} else {
+		flush = conn->gro_pkt;
+		conn->gro_pkt = NULL;
+
+		if (conn->state == TCP_ESTABLISHED && net_tc_rx_pending() &&
+		    tcp_gro_mergeable(pkt, false) &&
+		    tcp_data_len(pkt) + conn_mss(conn) <=
+		    CONFIG_NET_TCP_GRO_MAX_SIZE) {
+			conn->gro_pkt = pkt;
+			tcp_gro_list_add(conn);
+		} else {
+			consumed = false;
+			release = tcp_gro_list_remove(conn);
+		}
+	}
+
+	k_mutex_unlock(&conn->lock);
 
-		found = tcp_conn_cmp(conn, pkt);
-		if (found) {
+	/* Segments held earlier go up first */
+	if (flush) {
+		tcp_gro_deliver(conn, flush);
+	}
+
+	if (release) {
+		tcp_conn_release(conn);
+	}
+
+	return consumed;
+}
+
+/* Take the next connection held by the calling RX thread off the list */
+static struct tcp *tcp_gro_list_get(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&tcp_gro_lock);
+	k_tid_t current = k_current_get();
+	sys_snode_t *prev = NULL;
+	struct tcp *conn;
+
+	/* With several RX threads, each one only flushes the flows it
+	 * receives, so that the segments of a flow stay in order.
+	 */
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp_gro_list, conn, gro_node) {
+		if (conn->gro_owner == current) {
+			sys_slist_remove(&tcp_gro_list, prev,
+					 &conn->gro_node);
+			conn->gro_listed = false;
 			break;
 		}
+
+		prev = &conn->gro_node;
 	}
 
-	return found ? conn : NULL;
+	k_spin_unlock(&tcp_gro_lock, key);
+
+	return conn;
+}
+
+void net_tcp_gro_flush(void)
+{
+	struct net_pkt *pkt;
+	struct tcp *conn;
+
+	while ((conn = tcp_gro_list_get()) != NULL) {
+		k_mutex_lock(&conn->lock, K_FOREVER);
+		pkt = conn->gro_pkt;
+		conn->gro_pkt = NULL;
+		k_mutex_unlock(&conn->lock);
+
+		if (pkt) {
+			tcp_gro_deliver(conn, pkt);
+		}
+
+		tcp_conn_release(conn);
+	}
 }
+#endif /* CONFIG_NET_TCP_GRO */
 
 static struct tcp *tcp_conn_new(struct net_pkt *pkt);
 
@@ -1281,10 +2022,20 @@ static enum net_verdict tcp_recv(struct net_conn *net_conn,
 		net_ipaddr_copy(&conn_old->context->remote, &conn->dst.sa);
 
 		conn->accepted_conn = conn_old;
+
+		/* Same as a connection found by tcp_conn_search() */
+		tcp_conn_ref(conn);
 	}
  in:
 	if (conn) {
+#if defined(CONFIG_NET_TCP_GRO)
+		if (tcp_gro_receive(conn, pkt)) {
+			tcp_conn_release(conn);
+			return NET_OK;
+		}
+#endif
 		tcp_in(conn, pkt);
+		tcp_conn_release(conn);
 	}
 
 	return NET_DROP;
@@ -1482,6 +2233,8 @@ static struct tcp *tcp_conn_new(struct net_pkt *pkt)
 		conn = NULL;
 		goto err;
 	}
+
+	tcp_conn_hash_add(conn);
 err:
 	if (!conn) {
 		net_stats_update_tcp_seg_conndrop(net_pkt_iface(pkt));
@@ -1618,6 +2371,26 @@ static void tcp_out_of_order_data(struct tcp *conn, struct net_pkt *pkt,
 	tcp_queue_recv_data(conn, pkt, data_len, seq);
 }
 
+/* Apply the options of the peer's SYN, we have offered all of ours */
+static void tcp_options_negotiate(struct tcp *conn)
+{
+	conn->wscale_ok = IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) &&
+		conn->recv_options.wnd_found;
+	conn->sack_ok = IS_ENABLED(CONFIG_NET_TCP_SACK) &&
+		conn->recv_options.sack_perm;
+
+	if (conn->wscale_ok) {
+		conn->snd_wscale = conn->recv_options.window;
+	} else {
+		conn->snd_wscale = 0;
+		conn->rcv_wscale = 0;
+	}
+
+	NET_DBG("conn: %p wscale %s (%hu/%hu) sack %s", conn,
+		conn->wscale_ok ? "on" : "off", conn->snd_wscale,
+		conn->rcv_wscale, conn->sack_ok ? "on" : "off");
+}
+
 /* TCP state machine, everything happens here */
 static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 {
@@ -1630,6 +2403,7 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	struct net_pkt *recv_pkt;
 	void *recv_user_data;
 	struct k_fifo *recv_data_fifo;
+	uint32_t send_win_prev = 0;
 	size_t len;
 	int ret;
 
@@ -1661,6 +2435,10 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+#if defined(CONFIG_NET_TCP_SACK)
+	conn->recv_options.sack_count = 0;
+#endif
+
 	if (tcp_options_len && !tcp_options_check(&conn->recv_options, pkt,
 						  tcp_options_len)) {
 		NET_DBG("DROP: Invalid TCP option list");
@@ -1672,8 +2450,14 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	if (th) {
 		size_t max_win;
 
+		send_win_prev = conn->send_win;
 		conn->send_win = ntohs(th_win(th));
 
+		/* The window of a SYN segment is never scaled */
+		if (conn->wscale_ok && !(th_flags(th) & SYN)) {
+			conn->send_win <<= conn->snd_wscale;
+		}
+
 #if defined(CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE)
 		if (CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE) {
 			max_win = CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE;
@@ -1687,7 +2471,7 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 				   CONFIG_NET_BUF_DATA_SIZE) / 3;
 		}
 
-		max_win = MAX(max_win, NET_IPV6_MTU);
+		max_win = MIN(MAX(max_win, NET_IPV6_MTU), TCP_WIN_MAX);
 		if ((size_t)conn->send_win > max_win) {
 			NET_DBG("Lowering send window from %zd to %zd",
 				(size_t)conn->send_win, max_win);
@@ -1703,6 +2487,7 @@ next_state:
 	case TCP_LISTEN:
 		if (FL(&fl, ==, SYN)) {
 			conn_ack(conn, th_seq(th) + 1); /* capture peer's isn */
+			tcp_options_negotiate(conn);
 			tcp_out(conn, SYN | ACK);
 			conn_seq(conn, + 1);
 			next = TCP_SYN_RECEIVED;
@@ -1723,6 +2508,7 @@ next_state:
 				th_seq(th) == conn->ack)) {
 			k_work_cancel_delayable(&conn->establish_timer);
 			tcp_send_timer_cancel(conn);
+			conn->cc->init(conn);
 			next = TCP_ESTABLISHED;
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
@@ -1756,6 +2542,8 @@ next_state:
 		if (FL(&fl, &, SYN | ACK, th && th_ack(th) == conn->seq)) {
 			tcp_send_timer_cancel(conn);
 			conn_ack(conn, th_seq(th) + 1);
+			tcp_options_negotiate(conn);
+			conn->cc->init(conn);
 			if (len) {
 				if (tcp_data_get(conn, pkt, &len) < 0) {
 					break;
@@ -1827,10 +2615,22 @@ next_state:
 			}
 
 			conn->send_data_total -= len_acked;
-			conn->unacked_len -= len_acked;
+
+			/* After a retransmission timeout we went back to the
+			 * oldest unacked byte, the peer may acknowledge more
+			 * than what has been sent since.
+			 */
+			if (len_acked > (uint32_t)conn->unacked_len) {
+				conn->unacked_len = 0;
+			} else {
+				conn->unacked_len -= len_acked;
+			}
+
 			conn_seq(conn, + len_acked);
 			net_stats_update_tcp_seg_recv(conn->iface);
 
+			tcp_new_ack(conn, len_acked);
+
 			conn_send_data_dump(conn);
 
 			if (!k_work_delayable_remaining_get(
@@ -1841,9 +2641,6 @@ next_state:
 			}
 			conn->send_data_retries = 0;
 			k_work_cancel_delayable(&conn->send_data_timer);
-			if (conn->data_mode == TCP_DATA_MODE_RESEND) {
-				conn->unacked_len = 0;
-			}
 			conn->data_mode = TCP_DATA_MODE_SEND;
 
 			/* We are closing the connection, send a FIN to peer */
@@ -1856,6 +2653,19 @@ next_state:
 				break;
 			}
 
+			ret = tcp_send_queued_data(conn);
+			if (ret < 0 && ret != -ENOBUFS) {
+				tcp_out(conn, RST);
+				conn_state(conn, TCP_CLOSED);
+				break;
+			}
+		} else if (th && !len && (th_flags(th) & ACK) &&
+			   th_ack(th) == conn->seq && conn->unacked_len > 0 &&
+			   conn->send_win == send_win_prev &&
+			   conn->data_mode == TCP_DATA_MODE_SEND) {
+			/* Duplicate ACK, RFC 5681 chapter 2 */
+			tcp_dup_ack(conn);
+
 			ret = tcp_send_queued_data(conn);
 			if (ret < 0 && ret != -ENOBUFS) {
 				tcp_out(conn, RST);
@@ -1876,6 +2686,14 @@ next_state:
 			} else if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
 				tcp_out_of_order_data(conn, pkt, len,
 						      th_seq(th));
+
+				/* Send a duplicate ACK telling the peer what
+				 * is missing so that it can retransmit it
+				 * without waiting for its timer.
+				 */
+				if (conn->sack_ok) {
+					tcp_out(conn, ACK);
+				}
 			}
 		}
 		break;
@@ -2014,7 +2832,7 @@ int net_tcp_put(struct net_context *context)
 			 */
 			k_work_reschedule_for_queue(&tcp_work_q,
 						    &conn->send_data_timer,
-						    K_MSEC(tcp_rto));
+						    tcp_rto_timeout(conn));
 		} else {
 			int ret;
 
@@ -2075,7 +2893,11 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 
 	k_mutex_lock(&conn->lock, K_FOREVER);
 
-	if (tcp_window_full(conn)) {
+	/* Do not queue more than the peer's window, the congestion window
+	 * may hold back the sending of what is already queued.
+	 */
+	if (tcp_window_full(conn) ||
+	    conn->send_data_total >= conn->send_win) {
 		/* Trigger resend if the timer is not active */
 		/* TODO: use k_work_delayable for send_data_timer so we don't
 		 * have to directly access the internals of the legacy object.
@@ -2246,6 +3068,8 @@ int net_tcp_connect(struct net_context *context,
 
 	net_context_set_state(context, NET_CONTEXT_CONNECTING);
 
+	tcp_conn_hash_add(conn);
+
 	ret = net_conn_register(net_context_get_ip_proto(context),
 				net_context_get_family(context),
 				remote_addr, local_addr,
@@ -2389,6 +3213,126 @@ int net_tcp_finalize(struct net_pkt *pkt)
 	return net_pkt_set_data(pkt, &tcp_access);
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+static void tcp_gso_copy_attributes(struct net_pkt *seg, struct net_pkt *pkt)
+{
+	net_pkt_set_family(seg, net_pkt_family(pkt));
+	net_pkt_set_context(seg, net_pkt_context(pkt));
+	net_pkt_set_priority(seg, net_pkt_priority(pkt));
+	net_pkt_set_vlan_tag(seg, net_pkt_vlan_tag(pkt));
+	net_pkt_set_ip_hdr_len(seg, net_pkt_ip_hdr_len(pkt));
+	*net_pkt_lladdr_src(seg) = *net_pkt_lladdr_src(pkt);
+	*net_pkt_lladdr_dst(seg) = *net_pkt_lladdr_dst(pkt);
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		net_pkt_set_ipv4_ttl(seg, net_pkt_ipv4_ttl(pkt));
+		net_pkt_set_ipv4_opts_len(seg, net_pkt_ipv4_opts_len(pkt));
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   net_pkt_family(pkt) == AF_INET6) {
+		net_pkt_set_ipv6_hop_limit(seg, net_pkt_ipv6_hop_limit(pkt));
+		net_pkt_set_ipv6_ext_len(seg, net_pkt_ipv6_ext_len(pkt));
+		net_pkt_set_ipv6_next_hdr(seg, net_pkt_ipv6_next_hdr(pkt));
+	}
+}
+
+/* Software fallback of the TCP segmentation offload: cut the packet into
+ * segments of net_pkt_gso_size() bytes and give them to L2. Returns the
+ * number of bytes sent like the L2 send function does, and consumes the
+ * packet unless nothing could be sent.
+ */
+int net_tcp_gso_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	size_t hdr_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt);
+	uint16_t mss = net_pkt_gso_size(pkt);
+	size_t data_len, pos;
+	struct tcphdr *th;
+	uint8_t flags;
+	uint32_t seq;
+	int segs = 0;
+	int sent = 0;
+	int ret = 0;
+
+	th = th_get(pkt);
+	if (!th) {
+		return -ENOBUFS;
+	}
+
+	hdr_len += th_off(th) * 4;
+	seq = th_seq(th);
+	flags = th_flags(th);
+	data_len = net_pkt_get_len(pkt) - hdr_len;
+
+	for (pos = 0; pos < data_len; pos += mss) {
+		size_t len = MIN(mss, data_len - pos);
+		struct net_pkt *seg;
+
+		seg = net_pkt_alloc_with_buffer(iface, hdr_len + len,
+						AF_UNSPEC, 0, K_NO_WAIT);
+		if (!seg) {
+			ret = -ENOBUFS;
+			break;
+		}
+
+		tcp_gso_copy_attributes(seg, pkt);
+
+		net_pkt_cursor_init(pkt);
+		net_pkt_set_overwrite(pkt, true);
+
+		if (net_pkt_copy(seg, pkt, hdr_len) ||
+		    net_pkt_skip(pkt, pos) || net_pkt_copy(seg, pkt, len)) {
+			net_pkt_unref(seg);
+			ret = -ENOBUFS;
+			break;
+		}
+
+		th = th_get(seg);
+		UNALIGNED_PUT(htonl(seq + pos), &th->th_seq);
+
+		/* FIN and PSH only belong to the last segment */
+		if (pos + len < data_len) {
+			UNALIGNED_PUT(flags & ~(FIN | PSH), &th->th_flags);
+		}
+
+		net_pkt_cursor_init(seg);
+
+		if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		    net_pkt_family(seg) == AF_INET) {
+			NET_IPV4_HDR(seg)->chksum = 0U;
+			ret = net_ipv4_finalize(seg, IPPROTO_TCP);
+		} else {
+			ret = net_ipv6_finalize(seg, IPPROTO_TCP);
+		}
+
+		if (ret < 0) {
+			net_pkt_unref(seg);
+			break;
+		}
+
+		net_pkt_cursor_init(seg);
+
+		ret = net_if_l2(iface)->send(iface, seg);
+		if (ret < 0) {
+			net_pkt_unref(seg);
+			break;
+		}
+
+		sent += ret;
+		segs++;
+	}
+
+	net_stats_update_tcp_seg_gso_segs(iface, segs);
+
+	if (!segs) {
+		return ret;
+	}
+
+	/* If only some segments were sent, the rest is retransmitted */
+	net_pkt_unref(pkt);
+
+	return sent;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 struct net_tcp_hdr *net_tcp_input(struct net_pkt *pkt,
 				  struct net_pkt_data_access *tcp_access)
 {
@@ -2431,15 +3375,21 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 			conn = context->tcp;
 			tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 			tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+			tcp_conn_hash_add(conn);
 			/* Make an extra reference, the sanity check suite
 			 * will delete the connection explicitly
 			 */
 			tcp_conn_ref(conn);
+			/* And one more released below, as for a connection
+			 * found by tcp_conn_search()
+			 */
+			tcp_conn_ref(conn);
 		}
 
 		if (conn) {
 			conn->iface = pkt->iface;
 			tcp_in(conn, pkt);
+			tcp_conn_release(conn);
 		}
 	}
 
@@ -2509,6 +3459,13 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 	bool responded = false;
 	static char buf[512];
 
+	/* The test protocol manages the lifetime of its connections, the
+	 * lookup reference is not needed.
+	 */
+	if (conn) {
+		tcp_conn_release(conn);
+	}
+
 	net_pkt_cursor_init(pkt);
 	net_pkt_set_overwrite(pkt, true);
 	net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
@@ -2552,6 +3509,7 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 				conn = context->tcp;
 				tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 				tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+				tcp_conn_hash_add(conn);
 				conn->iface = pkt->iface;
 				tcp_conn_ref(conn);
 			}
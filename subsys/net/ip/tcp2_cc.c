@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* TCP congestion control algorithms. The TCP state machine in tcp2.c
+ * detects the losses and calls these to adjust the congestion window.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include "net_private.h"
+#include "tcp2_priv.h"
+
+/* Initial window, RFC 5681 chapter 3.1 */
+static uint32_t tcp_cc_initial_window(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (mss > 2190) {
+		return 2 * mss;
+	} else if (mss > 1095) {
+		return 3 * mss;
+	}
+
+	return 4 * mss;
+}
+
+static void tcp_cc_slow_start(struct tcp *conn, uint32_t acked)
+{
+	/* RFC 5681 chapter 3.1, equation 2 */
+	conn->cwnd = MIN(conn->cwnd + MIN(acked, conn_mss(conn)), TCP_WIN_MAX);
+}
+
+static void newreno_init(struct tcp *conn)
+{
+	conn->cwnd = tcp_cc_initial_window(conn);
+	conn->ssthresh = UINT32_MAX;
+	conn->cwnd_cnt = 0;
+}
+
+static void newreno_ack(struct tcp *conn, uint32_t acked)
+{
+	if (conn->cwnd < conn->ssthresh) {
+		tcp_cc_slow_start(conn, acked);
+		return;
+	}
+
+	/* Congestion avoidance with appropriate byte counting, one MSS
+	 * per window of acknowledged data (RFC 3465).
+	 */
+	conn->cwnd_cnt += acked;
+	if (conn->cwnd_cnt >= conn->cwnd) {
+		conn->cwnd_cnt -= conn->cwnd;
+		conn->cwnd = MIN(conn->cwnd + conn_mss(conn), TCP_WIN_MAX);
+	}
+}
+
+static void newreno_loss(struct tcp *conn, bool timeout)
+{
+	ARG_UNUSED(timeout);
+
+	/* RFC 5681 chapter 3.1, equation 4 */
+	conn->ssthresh = MAX((uint32_t)conn->unacked_len / 2,
+			     2 * conn_mss(conn));
+	conn->cwnd_cnt = 0;
+
+	NET_DBG("conn: %p ssthresh=%u", conn, conn->ssthresh);
+}
+
+const struct tcp_cc_ops tcp_cc_newreno = {
+	.name = "newreno",
+	.init = newreno_init,
+	.ack = newreno_ack,
+	.loss = newreno_loss,
+};
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+/* Limit of t - K in ms so that the cube fits in 64 bits */
+#define CUBIC_T_MAX 100000
+
+static uint32_t cubic_root(uint64_t x)
+{
+	uint64_t y = 0, b;
+	int s;
+
+	for (s = 63; s >= 0; s -= 3) {
+		y += y;
+		b = 3 * y * (y + 1) + 1;
+		if ((x >> s) >= b) {
+			x -= b << s;
+			y++;
+		}
+	}
+
+	return (uint32_t)y;
+}
+
+static void cubic_init(struct tcp *conn)
+{
+	newreno_init(conn);
+
+	conn->cubic_w_max = 0;
+	conn->cubic_epoch = 0;
+}
+
+static void cubic_ack(struct tcp *conn, uint32_t acked)
+{
+	uint32_t mss = conn_mss(conn);
+	uint32_t now = k_uptime_get_32();
+	uint64_t target, cnt, inc;
+	int64_t t, w;
+
+	if (conn->cwnd < conn->ssthresh) {
+		tcp_cc_slow_start(conn, acked);
+		return;
+	}
+
+	if (!conn->cubic_epoch) {
+		conn->cubic_epoch = MAX(now, 1U);
+		conn->cubic_w_est = conn->cwnd;
+
+		if (conn->cwnd < conn->cubic_w_max) {
+			/* K = cbrt((W_max - cwnd) / C) with C = 0.4, the
+			 * window is in bytes and K in ms.
+			 */
+			conn->cubic_k = cubic_root(
+				(uint64_t)(conn->cubic_w_max - conn->cwnd) *
+				2500000000ULL / mss);
+			conn->cubic_origin = conn->cubic_w_max;
+		} else {
+			conn->cubic_k = 0;
+			conn->cubic_origin = conn->cwnd;
+		}
+	}
+
+	/* W_cubic(t + RTT) = C * (t + RTT - K)^3 + W_max, RFC 8312
+	 * chapter 4.1.
+	 */
+	t = (int64_t)(now - conn->cubic_epoch) + (conn->srtt >> 3) -
+		conn->cubic_k;
+	t = CLAMP(t, -CUBIC_T_MAX, CUBIC_T_MAX);
+	w = (int64_t)conn->cubic_origin + t * t * t / 1000000 * 4 * mss / 10000;
+	target = CLAMP(w, (int64_t)conn->cwnd, (int64_t)TCP_WIN_MAX);
+
+	/* Bytes to acknowledge for one MSS of growth */
+	if (target > conn->cwnd) {
+		cnt = (uint64_t)conn->cwnd * mss / (target - conn->cwnd);
+	} else {
+		cnt = 100ULL * conn->cwnd;
+	}
+
+	/* Do not grow slower than standard TCP would, RFC 8312
+	 * chapter 4.2.
+	 */
+	conn->cubic_w_est += (uint64_t)9 * mss * acked /
+		(17ULL * conn->cwnd);
+	if (conn->cubic_w_est > conn->cwnd) {
+		cnt = MIN(cnt, (uint64_t)conn->cwnd * mss /
+			  (conn->cubic_w_est - conn->cwnd));
+	}
+
+	/* At most 1.5 times the window per RTT */
+	cnt = MAX(cnt, 2ULL * mss);
+
+	conn->cwnd_cnt += acked;
+	if (conn->cwnd_cnt >= cnt) {
+		inc = conn->cwnd_cnt / cnt;
+		conn->cwnd_cnt -= inc * cnt;
+		conn->cwnd = MIN(conn->cwnd + inc * mss, TCP_WIN_MAX);
+	}
+}
+
+static void cubic_loss(struct tcp *conn, bool timeout)
+{
+	ARG_UNUSED(timeout);
+
+	/* Fast convergence, RFC 8312 chapter 4.6 */
+	if (conn->cwnd < conn->cubic_w_max) {
+		conn->cubic_w_max = (uint64_t)conn->cwnd * 17 / 20;
+	} else {
+		conn->cubic_w_max = conn->cwnd;
+	}
+
+	/* beta_cubic = 0.7, RFC 8312 chapter 4.5 */
+	conn->ssthresh = MAX((uint64_t)conn->cwnd * 7 / 10,
+			     2 * conn_mss(conn));
+	conn->cubic_epoch = 0;
+	conn->cwnd_cnt = 0;
+
+	NET_DBG("conn: %p ssthresh=%u w_max=%u", conn, conn->ssthresh,
+		conn->cubic_w_max);
+}
+
+const struct tcp_cc_ops tcp_cc_cubic = {
+	.name = "cubic",
+	.init = cubic_init,
+	.ack = cubic_ack,
+	.loss = cubic_loss,
+};
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
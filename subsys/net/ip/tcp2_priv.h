@@ -110,9 +110,17 @@
 #define conn_ack(_conn, _req) (_conn)->ack += (_req)
 #endif
 
-#define conn_mss(_conn)					\
-	((_conn)->recv_options.mss_found ?		\
-	 (_conn)->recv_options.mss : (uint16_t)NET_IPV6_MTU)
+/* Without an MSS option, a segment must fit in the smallest datagram every
+ * host accepts (RFC 1122 chapter 4.2.2.6). Anything larger cannot be
+ * allocated on an interface with that MTU, e.g. when a retransmission
+ * covers several of the original segments.
+ */
+#define conn_mss(_conn)						\
+	((_conn)->recv_options.mss_found ?			\
+	 (_conn)->recv_options.mss :				\
+	 ((_conn)->src.sa.sa_family == AF_INET ?		\
+	  (uint16_t)(NET_IPV4_MTU - NET_IPV4TCPH_LEN) :		\
+	  (uint16_t)(NET_IPV6_MTU - NET_IPV6TCPH_LEN)))
 
 #define conn_state(_conn, _s)						\
 ({									\
@@ -125,9 +133,9 @@
 #define conn_send_data_dump(_conn)                                             \
 	({                                                                     \
 		NET_DBG("conn: %p total=%zd, unacked_len=%d, "                 \
-			"send_win=%hu, mss=%hu",                               \
+			"send_win=%u, cwnd=%u, mss=%hu",                       \
 			(_conn), net_pkt_get_len((_conn)->send_data),          \
-			conn->unacked_len, conn->send_win,                     \
+			conn->unacked_len, conn->send_win, conn->cwnd,         \
 			(uint16_t)conn_mss((_conn)));                          \
 		NET_DBG("conn: %p send_data_timer=%hu, send_data_retries=%hu", \
 			(_conn),                                               \
@@ -141,6 +149,12 @@
 #define TCPOPT_NOP	1
 #define TCPOPT_MAXSEG	2
 #define TCPOPT_WINDOW	3
+#define TCPOPT_SACK_PERM	4
+#define TCPOPT_SACK	5
+
+#define TCP_WSCALE_MAX	14 /* RFC 7323 chapter 2.3 */
+#define TCP_WIN_MAX	(0xffffU << TCP_WSCALE_MAX)
+#define TCP_SACK_BLOCKS	4 /* Max SACK blocks fitting in the options */
 
 enum pkt_addr {
 	TCP_EP_SRC = 1,
@@ -202,15 +216,53 @@ union tcp_endpoint {
 	struct sockaddr_in6 sin6;
 };
 
+struct tcp_sack_block {
+	uint32_t start;
+	uint32_t end;
+};
+
 struct tcp_options {
+#if defined(CONFIG_NET_TCP_SACK)
+	struct tcp_sack_block sack[TCP_SACK_BLOCKS];
+	uint8_t sack_count;
+#endif
 	uint16_t mss;
-	uint16_t window;
+	uint16_t window; /* window scale shift */
 	bool mss_found : 1;
 	bool wnd_found : 1;
+	bool sack_perm : 1;
 };
 
+struct tcp;
+
+/* Congestion control algorithm, the window arithmetic of loss recovery.
+ * Detecting the loss and retransmitting is done by tcp2.c.
+ */
+struct tcp_cc_ops {
+	const char *name;
+	/* Set the initial cwnd and ssthresh once the MSS is known */
+	void (*init)(struct tcp *conn);
+	/* New data was cumulatively acknowledged outside of loss recovery */
+	void (*ack)(struct tcp *conn, uint32_t acked);
+	/* Loss was detected by duplicate ACKs or by the retransmission
+	 * timer, set the new ssthresh.
+	 */
+	void (*loss)(struct tcp *conn, bool timeout);
+};
+
+extern const struct tcp_cc_ops tcp_cc_newreno;
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+extern const struct tcp_cc_ops tcp_cc_cubic;
+#define TCP_CC_DEFAULT (&tcp_cc_cubic)
+#else
+#define TCP_CC_DEFAULT (&tcp_cc_newreno)
+#endif
+
 struct tcp { /* TCP connection */
 	sys_snode_t next;
+	sys_snode_t hash_node; /* node in the connection hash table */
+	uint32_t hash; /* hash of the 4-tuple, valid when hashed */
+	bool hashed; /* protected by the hash table lock */
 	struct net_context *context;
 	struct net_pkt *send_data;
 	struct net_pkt *queue_recv_data;
@@ -239,6 +291,19 @@ struct tcp { /* TCP connection */
 	};
 	union tcp_endpoint src;
 	union tcp_endpoint dst;
+	const struct tcp_cc_ops *cc;
+#if defined(CONFIG_NET_TCP_GRO)
+	/* Received segments coalesced until the RX queue is drained */
+	struct net_pkt *gro_pkt;
+	sys_snode_t gro_node;
+	k_tid_t gro_owner; /* RX thread holding gro_pkt */
+	bool gro_listed; /* protected by the GRO list lock */
+#endif
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Ranges above seq the peer has selectively acknowledged, sorted */
+	struct tcp_sack_block sacked[TCP_SACK_BLOCKS];
+	uint8_t sacked_count;
+#endif
 	size_t send_data_total;
 	size_t send_retries;
 	int unacked_len;
@@ -247,12 +312,36 @@ struct tcp { /* TCP connection */
 	enum tcp_data_mode data_mode;
 	uint32_t seq;
 	uint32_t ack;
-	uint16_t recv_win;
-	uint16_t send_win;
+	uint32_t recv_win;
+	uint32_t send_win;
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	uint32_t cwnd_cnt; /* bytes acked towards the next cwnd increase */
+	uint32_t recover; /* highest seq sent when loss recovery started */
+	uint32_t rexmit_next; /* next seq to retransmit in loss recovery */
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	uint32_t cubic_w_max;
+	uint32_t cubic_w_est;
+	uint32_t cubic_origin;
+	uint32_t cubic_k; /* ms */
+	uint32_t cubic_epoch; /* uptime in ms, 0 if not started */
+#endif
+	uint32_t rtt_seq; /* seq whose ACK completes the RTT sample */
+	uint32_t rtt_start; /* uptime in ms */
+	uint32_t srtt; /* smoothed RTT in ms, scaled by 8 */
+	uint32_t rttvar; /* RTT variation in ms, scaled by 4 */
+	uint32_t rto; /* ms */
 	uint8_t send_data_retries;
+	uint8_t dup_acks;
+	uint8_t snd_wscale;
+	uint8_t rcv_wscale;
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
+	bool in_recovery : 1;
+	bool rtt_pending : 1;
+	bool wscale_ok : 1;
+	bool sack_ok : 1;
 };
 
 #define _flags(_fl, _op, _mask, _cond)					\
@@ -487,37 +487,145 @@ int z_vrfy_net_addr_pton(sa_family_t family, const char *src,
 #include <syscalls/net_addr_pton_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
-static uint16_t calc_chksum(uint16_t sum, const uint8_t *data, size_t len)
+static inline uint16_t chksum_add(uint16_t a, uint16_t b)
 {
-	const uint8_t *end;
-	uint16_t tmp;
+	uint32_t sum = (uint32_t)a + b;
 
-	end = data + len - 1;
+	return (uint16_t)((sum & 0xffff) + (sum >> 16));
+}
 
-	while (data < end) {
-		tmp = (data[0] << 8) + data[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+static inline uint16_t chksum_fold(uint64_t sum)
+{
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t)sum;
+}
+
+/* Value of a lone byte padded with zero, as loaded from memory */
+static inline uint16_t chksum_byte(uint8_t byte)
+{
+	return sys_be16_to_cpu((uint16_t)byte << 8);
+}
+
+/* Ones' complement sum of the data taken as 16-bit words in memory
+ * (CPU) byte order. As the ones' complement sum does not depend on
+ * byte order (RFC 1071), the data can be loaded a machine word at a
+ * time into a wide accumulator, and the carries folded back once at
+ * the end instead of after every 16-bit addition.
+ */
+static uint16_t chksum_mem(const uint8_t *data, size_t len)
+{
+	uint64_t acc = 0U;
+	uint16_t sum;
+	uint8_t first = 0U;
+	bool odd = false;
+
+	if (len == 0) {
+		return 0U;
+	}
 
+	/* Loads below are aligned. Starting at an odd address shifts the
+	 * word boundaries by one byte, so the sum of the rest comes out
+	 * byte swapped.
+	 */
+	if ((uintptr_t)data & 1) {
+		first = *data++;
+		len--;
+		odd = true;
+	}
+
+	if (len >= 2 && ((uintptr_t)data & 2)) {
+		acc += *(const uint16_t *)data;
 		data += 2;
+		len -= 2;
 	}
 
-	if (data == end) {
-		tmp = data[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+#if defined(CONFIG_64BIT)
+	if (len >= 4 && ((uintptr_t)data & 4)) {
+		acc += *(const uint32_t *)data;
+		data += 4;
+		len -= 4;
+	}
+
+	while (len >= 32) {
+		const uint64_t *p = (const uint64_t *)data;
+		uint64_t w;
+
+		/* 64-bit words, carries are added back right away */
+		w = p[0]; acc += w; acc += (acc < w);
+		w = p[1]; acc += w; acc += (acc < w);
+		w = p[2]; acc += w; acc += (acc < w);
+		w = p[3]; acc += w; acc += (acc < w);
+
+		data += 32;
+		len -= 32;
+	}
+#else
+	while (len >= 32) {
+		const uint32_t *p = (const uint32_t *)data;
+
+		/* 32-bit words cannot overflow the 64-bit accumulator */
+		acc += p[0];
+		acc += p[1];
+		acc += p[2];
+		acc += p[3];
+		acc += p[4];
+		acc += p[5];
+		acc += p[6];
+		acc += p[7];
+
+		data += 32;
+		len -= 32;
+	}
+#endif
+
+	while (len >= 4) {
+		uint64_t w = *(const uint32_t *)data;
+
+		acc += w;
+		acc += (acc < w);
+		data += 4;
+		len -= 4;
+	}
+
+	if (len >= 2) {
+		uint64_t w = *(const uint16_t *)data;
+
+		acc += w;
+		acc += (acc < w);
+		data += 2;
+		len -= 2;
+	}
+
+	if (len) {
+		uint64_t w = chksum_byte(*data);
+
+		acc += w;
+		acc += (acc < w);
+	}
+
+	sum = chksum_fold(acc);
+
+	if (odd) {
+		sum = chksum_add(__bswap_16(sum), chksum_byte(first));
 	}
 
 	return sum;
 }
 
+/* Returns the sum in host order of the big endian 16-bit words */
+static uint16_t calc_chksum(uint16_t sum, const uint8_t *data, size_t len)
+{
+	return chksum_add(sum, sys_be16_to_cpu(chksum_mem(data, len)));
+}
+
 static inline uint16_t pkt_calc_chksum(struct net_pkt *pkt, uint16_t sum)
 {
 	struct net_pkt_cursor *cur = &pkt->cursor;
+	bool odd = false;
 	size_t len;
 
 	if (!cur->buf || !cur->pos) {
@@ -527,7 +635,17 @@ static inline uint16_t pkt_calc_chksum(struct net_pkt *pkt, uint16_t sum)
 	len = cur->buf->len - (cur->pos - cur->buf->data);
 
 	while (cur->buf) {
-		sum = calc_chksum(sum, cur->pos, len);
+		uint16_t frag_sum = sys_be16_to_cpu(chksum_mem(cur->pos, len));
+
+		/* A fragment starting at an odd offset of the checksummed
+		 * data has its bytes in the other half of every word.
+		 */
+		if (odd) {
+			frag_sum = __bswap_16(frag_sum);
+		}
+
+		sum = chksum_add(sum, frag_sum);
+		odd ^= len & 1;
 
 		cur->buf = cur->buf->frags;
 		if (!cur->buf || !cur->buf->len) {
@@ -535,18 +653,7 @@ static inline uint16_t pkt_calc_chksum(struct net_pkt *pkt, uint16_t sum)
 		}
 
 		cur->pos = cur->buf->data;
-
-		if (len % 2) {
-			sum += *cur->pos;
-			if (sum < *cur->pos) {
-				sum++;
-			}
-
-			cur->pos++;
-			len = cur->buf->len - 1;
-		} else {
-			len = cur->buf->len;
-		}
+		len = cur->buf->len;
 	}
 
 	return sum;
@@ -600,6 +707,22 @@ uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto)
 	return ~sum;
 }
 
+uint16_t net_chksum_update(uint16_t chksum, const void *old_data,
+			   const void *new_data, size_t len)
+{
+	uint16_t sum;
+
+	/* RFC 1624, eqn. 3: HC' = ~(~HC + ~m + m'). The sum of the
+	 * complemented old words is the complement of their sum, and
+	 * everything is in memory byte order like the stored checksum.
+	 */
+	sum = chksum_add((uint16_t)~chksum,
+			 (uint16_t)~chksum_mem(old_data, len));
+	sum = chksum_add(sum, chksum_mem(new_data, len));
+
+	return (uint16_t)~sum;
+}
+
 #if defined(CONFIG_NET_IPV4)
 uint16_t net_calc_chksum_ipv4(struct net_pkt *pkt)
 {
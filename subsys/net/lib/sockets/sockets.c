@@ -255,6 +255,7 @@ int zsock_close_ctx(struct net_context *ctx)
 		(void)net_context_recv(ctx, NULL, K_NO_WAIT, NULL);
 	}
 
+	zsock_epoll_forget(ctx);
 	zsock_flush_queue(ctx);
 
 	SET_ERRNO(net_context_put(ctx));
@@ -333,6 +334,7 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		k_condvar_init(&new_ctx->cond.recv);
 
 		k_fifo_put(&parent->accept_q, new_ctx);
+		zsock_epoll_notify(parent);
 	}
 }
 
@@ -388,6 +390,8 @@ unlock:
 
 	/* Let reader to wake if it was sleeping */
 	(void)k_condvar_signal(&ctx->cond.recv);
+
+	zsock_epoll_notify(ctx);
 }
 
 int zsock_bind_ctx(struct net_context *ctx, const struct sockaddr *addr,
@@ -726,6 +730,14 @@ ssize_t zsock_sendmsg_ctx(struct net_context *ctx, const struct msghdr *msg,
 		net_context_get_option(ctx, NET_OPT_SNDTIMEO, &timeout, NULL);
 	}
 
+	/* As in zsock_sendto_ctx(), this also binds an unbound socket */
+	status = net_context_recv(ctx, zsock_received_cb,
+				  K_NO_WAIT, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
 	status = net_context_sendmsg(ctx, msg, flags, NULL, timeout, NULL);
 	if (status < 0) {
 		errno = -status;
@@ -983,19 +995,274 @@ static int wait_data(struct net_context *ctx, k_timeout_t *timeout)
 	return 0;
 }
 
+/* Read the destination address and traffic class from the IP header */
+static int sock_get_pkt_ip_info(struct net_pkt *pkt, struct sockaddr *dst,
+				uint8_t *tclass)
+{
+	struct net_pkt_cursor backup;
+	int ret = 0;
+
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+
+	dst->sa_family = net_pkt_family(pkt);
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) &&
+	    net_pkt_family(pkt) == AF_INET) {
+		NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv4_access,
+						      struct net_ipv4_hdr);
+		struct net_ipv4_hdr *ipv4_hdr;
+
+		ipv4_hdr = (struct net_ipv4_hdr *)net_pkt_get_data(
+							pkt, &ipv4_access);
+		if (!ipv4_hdr) {
+			ret = -ENOBUFS;
+			goto out;
+		}
+
+		net_ipaddr_copy(&net_sin(dst)->sin_addr, &ipv4_hdr->dst);
+		*tclass = ipv4_hdr->tos;
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   net_pkt_family(pkt) == AF_INET6) {
+		NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv6_access,
+						      struct net_ipv6_hdr);
+		struct net_ipv6_hdr *ipv6_hdr;
+
+		ipv6_hdr = (struct net_ipv6_hdr *)net_pkt_get_data(
+							pkt, &ipv6_access);
+		if (!ipv6_hdr) {
+			ret = -ENOBUFS;
+			goto out;
+		}
+
+		net_ipaddr_copy(&net_sin6(dst)->sin6_addr, &ipv6_hdr->dst);
+		*tclass = ((ipv6_hdr->vtc & 0x0f) << 4) |
+			  (ipv6_hdr->tcflow >> 4);
+	} else {
+		ret = -ENOTSUP;
+	}
+
+out:
+	net_pkt_cursor_restore(pkt, &backup);
+
+	return ret;
+}
+
+/* Reserve room for a control message of len bytes and return a pointer
+ * to its data, or NULL (and MSG_CTRUNC) if it does not fit.
+ */
+static void *sock_cmsg_add(struct msghdr *msg, size_t *used,
+			   int level, int type, size_t len)
+{
+	struct cmsghdr *cmsg;
+
+	if (msg->msg_control == NULL ||
+	    *used + CMSG_SPACE(len) > msg->msg_controllen) {
+		msg->msg_flags |= ZSOCK_MSG_CTRUNC;
+		return NULL;
+	}
+
+	cmsg = (struct cmsghdr *)((uint8_t *)msg->msg_control + *used);
+	cmsg->cmsg_len = CMSG_LEN(len);
+	cmsg->cmsg_level = level;
+	cmsg->cmsg_type = type;
+
+	*used += CMSG_SPACE(len);
+
+	return CMSG_DATA(cmsg);
+}
+
+static void sock_put_ancillary(struct net_context *ctx, struct net_pkt *pkt,
+			       struct msghdr *msg, size_t *used)
+{
+	struct sockaddr_in6 dst;
+	uint8_t tclass = 0U;
+	void *data;
+
+	if (IS_ENABLED(CONFIG_NET_PKT_TIMESTAMP) &&
+	    (ctx->flags & NET_CONTEXT_RECV_TIMESTAMP) &&
+	    net_pkt_timestamp(pkt) != NULL) {
+		data = sock_cmsg_add(msg, used, SOL_SOCKET, SO_TIMESTAMPING,
+				     sizeof(struct net_ptp_time));
+		if (data) {
+			memcpy(data, net_pkt_timestamp(pkt),
+			       sizeof(struct net_ptp_time));
+		}
+	}
+
+	if (!(ctx->flags & (NET_CONTEXT_RECV_PKTINFO |
+			    NET_CONTEXT_RECV_TCLASS))) {
+		return;
+	}
+
+	/* Packets from an offloaded IP stack have no IP header */
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+		return;
+	}
+
+	if (sock_get_pkt_ip_info(pkt, (struct sockaddr *)&dst, &tclass) < 0) {
+		return;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && dst.sin6_family == AF_INET) {
+		if (ctx->flags & NET_CONTEXT_RECV_PKTINFO) {
+			struct in_pktinfo info = {
+				.ipi_ifindex =
+					net_if_get_by_iface(net_pkt_iface(pkt)),
+			};
+
+			net_ipaddr_copy(&info.ipi_spec_dst,
+					&net_sin((struct sockaddr *)&dst)->sin_addr);
+			net_ipaddr_copy(&info.ipi_addr,
+					&net_sin((struct sockaddr *)&dst)->sin_addr);
+
+			data = sock_cmsg_add(msg, used, IPPROTO_IP, IP_PKTINFO,
+					     sizeof(info));
+			if (data) {
+				memcpy(data, &info, sizeof(info));
+			}
+		}
+
+		if (ctx->flags & NET_CONTEXT_RECV_TCLASS) {
+			data = sock_cmsg_add(msg, used, IPPROTO_IP, IP_TOS,
+					     sizeof(tclass));
+			if (data) {
+				memcpy(data, &tclass, sizeof(tclass));
+			}
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   dst.sin6_family == AF_INET6) {
+		if (ctx->flags & NET_CONTEXT_RECV_PKTINFO) {
+			struct in6_pktinfo info = {
+				.ipi6_ifindex =
+					net_if_get_by_iface(net_pkt_iface(pkt)),
+			};
+
+			net_ipaddr_copy(&info.ipi6_addr, &dst.sin6_addr);
+
+			data = sock_cmsg_add(msg, used, IPPROTO_IPV6,
+					     IPV6_PKTINFO, sizeof(info));
+			if (data) {
+				memcpy(data, &info, sizeof(info));
+			}
+		}
+
+		if (ctx->flags & NET_CONTEXT_RECV_TCLASS) {
+			int val = tclass;
+
+			data = sock_cmsg_add(msg, used, IPPROTO_IPV6,
+					     IPV6_TCLASS, sizeof(val));
+			if (data) {
+				memcpy(data, &val, sizeof(val));
+			}
+		}
+	}
+}
+
+static size_t sock_iov_len(const struct msghdr *msg)
+{
+	size_t len = 0;
+	size_t i;
+
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		len += msg->msg_iov[i].iov_len;
+	}
+
+	return len;
+}
+
+/* Copy len bytes from the packet into the iovecs, starting offset bytes
+ * into them.
+ */
+static int sock_read_iov(struct net_pkt *pkt, const struct msghdr *msg,
+			 size_t offset, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < msg->msg_iovlen && len > 0; i++) {
+		const struct iovec *iov = &msg->msg_iov[i];
+		size_t chunk;
+
+		if (offset >= iov->iov_len) {
+			offset -= iov->iov_len;
+			continue;
+		}
+
+		chunk = MIN(len, iov->iov_len - offset);
+
+		if (net_pkt_read(pkt, (uint8_t *)iov->iov_base + offset,
+				 chunk)) {
+			return -ENOBUFS;
+		}
+
+		offset = 0;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+/* Point the iovecs at the remaining packet data. Returns the number of
+ * bytes covered, or -ENOBUFS if there were not enough iovecs for all
+ * the fragments.
+ */
+static ssize_t sock_zerocopy_iov(struct net_pkt *pkt, struct msghdr *msg)
+{
+	size_t remaining = net_pkt_remaining_data(pkt);
+	struct net_buf *buf = pkt->cursor.buf;
+	uint8_t *pos = pkt->cursor.pos;
+	size_t len = 0;
+	size_t i = 0;
+
+	while (buf && remaining > 0) {
+		size_t chunk = MIN(remaining, buf->len - (pos - buf->data));
+
+		if (chunk > 0) {
+			if (i == msg->msg_iovlen) {
+				return -ENOBUFS;
+			}
+
+			msg->msg_iov[i].iov_base = pos;
+			msg->msg_iov[i].iov_len = chunk;
+			remaining -= chunk;
+			len += chunk;
+			i++;
+		}
+
+		buf = buf->frags;
+		if (buf) {
+			pos = buf->data;
+		}
+	}
+
+	msg->msg_iovlen = i;
+
+	return len;
+}
+
 static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
-				       void *buf,
-				       size_t max_len,
-				       int flags,
-				       struct sockaddr *src_addr,
-				       socklen_t *addrlen)
+				       struct msghdr *msg,
+				       int flags)
 {
 	k_timeout_t timeout = K_FOREVER;
+	struct sockaddr *src_addr = msg->msg_name;
+	bool zerocopy = flags & ZSOCK_MSG_ZEROCOPY;
+	struct net_buf **zc_buf = NULL;
+	size_t control_used = 0;
 	size_t recv_len = 0;
 	size_t read_len;
 	struct net_pkt_cursor backup;
 	struct net_pkt *pkt;
 
+	if (zerocopy && ((flags & ZSOCK_MSG_PEEK) ||
+			 msg->msg_control == NULL ||
+			 msg->msg_controllen <
+			 CMSG_SPACE(sizeof(struct net_buf *)))) {
+		errno = EINVAL;
+		return -1;
+	}
+
 	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
 		timeout = K_NO_WAIT;
 	} else {
@@ -1032,7 +1299,7 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 
 	net_pkt_cursor_backup(pkt, &backup);
 
-	if (src_addr && addrlen) {
+	if (src_addr) {
 		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
 		    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
 			/*
@@ -1043,7 +1310,8 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 			 */
 			if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
 				memcpy(src_addr, &ctx->remote,
-				       MIN(*addrlen, sizeof(ctx->remote)));
+				       MIN(msg->msg_namelen,
+					   sizeof(ctx->remote)));
 			} else {
 				errno = ENOTSUP;
 				goto fail;
@@ -1052,7 +1320,7 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 			int rv;
 
 			rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
-						   src_addr, *addrlen);
+						   src_addr, msg->msg_namelen);
 			if (rv < 0) {
 				errno = -rv;
 				LOG_ERR("sock_get_pkt_src_addr %d", rv);
@@ -1060,25 +1328,59 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 			}
 		}
 
-		/* addrlen is a value-result argument, set to actual
+		/* msg_namelen is a value-result argument, set to actual
 		 * size of source address
 		 */
 		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
+			msg->msg_namelen = sizeof(struct sockaddr_in);
 		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
+			msg->msg_namelen = sizeof(struct sockaddr_in6);
 		} else {
 			errno = ENOTSUP;
 			goto fail;
 		}
 	}
 
+	if (zerocopy) {
+		/* Always first, so the room checked above is enough */
+		zc_buf = sock_cmsg_add(msg, &control_used, SOL_SOCKET,
+				       SCM_NET_BUF, sizeof(*zc_buf));
+	}
+
+	if (msg->msg_controllen > 0) {
+		sock_put_ancillary(ctx, pkt, msg, &control_used);
+	}
+
 	recv_len = net_pkt_remaining_data(pkt);
-	read_len = MIN(recv_len, max_len);
 
-	if (net_pkt_read(pkt, buf, read_len)) {
-		errno = ENOBUFS;
-		goto fail;
+	if (zerocopy) {
+		ssize_t len;
+
+		len = sock_zerocopy_iov(pkt, msg);
+		if (len < 0) {
+			errno = -len;
+			goto fail;
+		}
+
+		read_len = len;
+
+		/* Once the packet is released below, the caller holds the
+		 * only reference to the buffers.
+		 */
+		*zc_buf = net_buf_ref(pkt->buffer);
+	} else {
+		read_len = MIN(recv_len, sock_iov_len(msg));
+
+		if (sock_read_iov(pkt, msg, 0, read_len)) {
+			errno = ENOBUFS;
+			goto fail;
+		}
+	}
+
+	msg->msg_controllen = control_used;
+
+	if (read_len < recv_len) {
+		msg->msg_flags |= ZSOCK_MSG_TRUNC;
 	}
 
 	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) &&
@@ -1103,11 +1405,11 @@ fail:
 }
 
 static inline ssize_t zsock_recv_stream(struct net_context *ctx,
-					void *buf,
-					size_t max_len,
+					struct msghdr *msg,
 					int flags)
 {
 	k_timeout_t timeout = K_FOREVER;
+	size_t max_len = sock_iov_len(msg);
 	size_t recv_len = 0;
 	struct net_pkt_cursor backup;
 	int res;
@@ -1176,7 +1478,7 @@ static inline ssize_t zsock_recv_stream(struct net_context *ctx,
 		}
 
 		/* Actually copy data to application buffer */
-		if (net_pkt_read(pkt, (uint8_t *)buf + recv_len, read_len)) {
+		if (sock_read_iov(pkt, msg, recv_len, read_len)) {
 			errno = ENOBUFS;
 			return -1;
 		}
@@ -1229,15 +1531,31 @@ ssize_t zsock_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 			   struct sockaddr *src_addr, socklen_t *addrlen)
 {
 	enum net_sock_type sock_type = net_context_get_type(ctx);
+	struct iovec iov = {
+		.iov_base = buf,
+		.iov_len = max_len,
+	};
+	struct msghdr msg = {
+		.msg_name = addrlen ? src_addr : NULL,
+		.msg_namelen = addrlen ? *addrlen : 0,
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+	};
+	ssize_t ret;
 
 	if (max_len == 0) {
 		return 0;
 	}
 
 	if (sock_type == SOCK_DGRAM) {
-		return zsock_recv_dgram(ctx, buf, max_len, flags, src_addr, addrlen);
+		ret = zsock_recv_dgram(ctx, &msg, flags & ~ZSOCK_MSG_ZEROCOPY);
+		if (ret >= 0 && msg.msg_name) {
+			*addrlen = msg.msg_namelen;
+		}
+
+		return ret;
 	} else if (sock_type == SOCK_STREAM) {
-		return zsock_recv_stream(ctx, buf, max_len, flags);
+		return zsock_recv_stream(ctx, &msg, flags);
 	} else {
 		__ASSERT(0, "Unknown socket type");
 	}
@@ -1283,6 +1601,406 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+ssize_t zsock_recvmsg_ctx(struct net_context *ctx, struct msghdr *msg,
+			  int flags)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+
+	if (msg == NULL || (msg->msg_iov == NULL && msg->msg_iovlen > 0)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	msg->msg_flags = 0;
+
+	if (sock_type == SOCK_DGRAM) {
+		return zsock_recv_dgram(ctx, msg, flags);
+	} else if (sock_type == SOCK_STREAM) {
+		if (flags & ZSOCK_MSG_ZEROCOPY) {
+			errno = EOPNOTSUPP;
+			return -1;
+		}
+
+		msg->msg_namelen = 0;
+		msg->msg_controllen = 0;
+
+		if (sock_iov_len(msg) == 0) {
+			return 0;
+		}
+
+		return zsock_recv_stream(ctx, msg, flags);
+	} else {
+		__ASSERT(0, "Unknown socket type");
+	}
+
+	return 0;
+}
+
+ssize_t z_impl_zsock_recvmsg(int sock, struct msghdr *msg, int flags)
+{
+	VTABLE_CALL(recvmsg, sock, msg, flags);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline ssize_t z_vrfy_zsock_recvmsg(int sock, struct msghdr *msg,
+					   int flags)
+{
+	struct msghdr msg_copy;
+	size_t iov_size;
+	size_t i;
+	ssize_t ret;
+
+	/* Handing out network buffers only makes sense in supervisor mode */
+	if (flags & ZSOCK_MSG_ZEROCOPY) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	Z_OOPS(z_user_from_copy(&msg_copy, (void *)msg, sizeof(msg_copy)));
+
+	Z_OOPS(Z_SYSCALL_VERIFY(!size_mul_overflow(msg_copy.msg_iovlen,
+						   sizeof(struct iovec),
+						   &iov_size)));
+
+	if (msg_copy.msg_iovlen > 0) {
+		msg_copy.msg_iov = z_user_alloc_from_copy(msg_copy.msg_iov,
+							  iov_size);
+		if (!msg_copy.msg_iov) {
+			errno = ENOMEM;
+			return -1;
+		}
+	} else {
+		msg_copy.msg_iov = NULL;
+	}
+
+	for (i = 0; i < msg_copy.msg_iovlen; i++) {
+		if (Z_SYSCALL_MEMORY_WRITE(msg_copy.msg_iov[i].iov_base,
+					   msg_copy.msg_iov[i].iov_len)) {
+			k_free(msg_copy.msg_iov);
+			Z_OOPS(1);
+		}
+	}
+
+	if (msg_copy.msg_name &&
+	    Z_SYSCALL_MEMORY_WRITE(msg_copy.msg_name, msg_copy.msg_namelen)) {
+		k_free(msg_copy.msg_iov);
+		Z_OOPS(1);
+	}
+
+	if (msg_copy.msg_control &&
+	    Z_SYSCALL_MEMORY_WRITE(msg_copy.msg_control,
+				   msg_copy.msg_controllen)) {
+		k_free(msg_copy.msg_iov);
+		Z_OOPS(1);
+	}
+
+	ret = z_impl_zsock_recvmsg(sock, &msg_copy, flags);
+
+	k_free(msg_copy.msg_iov);
+
+	Z_OOPS(z_user_to_copy(&msg->msg_namelen, &msg_copy.msg_namelen,
+			      sizeof(msg->msg_namelen)));
+	Z_OOPS(z_user_to_copy(&msg->msg_controllen, &msg_copy.msg_controllen,
+			      sizeof(msg->msg_controllen)));
+	Z_OOPS(z_user_to_copy(&msg->msg_flags, &msg_copy.msg_flags,
+			      sizeof(msg->msg_flags)));
+
+	return ret;
+}
+#include <syscalls/zsock_recvmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+/* The batched calls look up and lock the socket once, and then go through
+ * the per message operations of whatever socket type it is.
+ */
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	unsigned int i;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL || vtable->sendmsg == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (i = 0; i < vlen; i++) {
+		ssize_t len;
+
+		len = vtable->sendmsg(obj, &msgvec[i].msg_hdr, flags);
+		if (len < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = len;
+	}
+
+	k_mutex_unlock(lock);
+
+	if (i == 0 && vlen > 0) {
+		/* errno was set by the failed send */
+		return -1;
+	}
+
+	return i;
+}
+
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	unsigned int i;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL || vtable->recvmsg == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (i = 0; i < vlen; i++) {
+		ssize_t len;
+
+		len = vtable->recvmsg(obj, &msgvec[i].msg_hdr,
+				      flags & ~ZSOCK_MSG_WAITFORONE);
+		if (len < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = len;
+
+		if (flags & ZSOCK_MSG_WAITFORONE) {
+			flags |= ZSOCK_MSG_DONTWAIT;
+		}
+	}
+
+	k_mutex_unlock(lock);
+
+	if (i == 0 && vlen > 0) {
+		return -1;
+	}
+
+	return i;
+}
+
+#ifdef CONFIG_USERSPACE
+static void mmsg_free_copy(struct mmsghdr *vec, unsigned int count,
+			   bool recv)
+{
+	unsigned int i;
+
+	for (i = 0; i < count; i++) {
+		k_free(vec[i].msg_hdr.msg_iov);
+
+		if (!recv) {
+			k_free(vec[i].msg_hdr.msg_name);
+			k_free(vec[i].msg_hdr.msg_control);
+		}
+	}
+
+	k_free(vec);
+}
+
+/* Copy the message vector and the iovec arrays of a user thread. The data
+ * buffers are only checked, as for zsock_sendto() and zsock_recvmsg().
+ * Addresses and control data to be sent are copied too, the ones to be
+ * received are written in place.
+ */
+static int mmsg_copy_from_user(struct mmsghdr **vec_out,
+			       struct mmsghdr *msgvec, unsigned int vlen,
+			       bool recv)
+{
+	struct mmsghdr *vec;
+	unsigned int copied = 0U;
+	size_t size;
+	unsigned int i;
+	size_t j;
+	int ret;
+
+	if (size_mul_overflow(vlen, sizeof(struct mmsghdr), &size)) {
+		return -EFAULT;
+	}
+
+	vec = z_user_alloc_from_copy(msgvec, size);
+	if (!vec) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < vlen; i++) {
+		struct msghdr *msg = &vec[i].msg_hdr;
+		struct iovec *iov = msg->msg_iov;
+		void *name = msg->msg_name;
+		void *control = msg->msg_control;
+
+		msg->msg_iov = NULL;
+		copied = i + 1;
+
+		if (!recv) {
+			msg->msg_name = NULL;
+			msg->msg_control = NULL;
+		}
+
+		if (size_mul_overflow(msg->msg_iovlen, sizeof(struct iovec),
+				      &size)) {
+			ret = -EFAULT;
+			goto fail;
+		}
+
+		if (msg->msg_iovlen > 0) {
+			msg->msg_iov = z_user_alloc_from_copy(iov, size);
+			if (!msg->msg_iov) {
+				ret = -ENOMEM;
+				goto fail;
+			}
+		}
+
+		for (j = 0; j < msg->msg_iovlen; j++) {
+			void *base = msg->msg_iov[j].iov_base;
+			size_t len = msg->msg_iov[j].iov_len;
+
+			if (recv ? Z_SYSCALL_MEMORY_WRITE(base, len) :
+				   Z_SYSCALL_MEMORY_READ(base, len)) {
+				ret = -EFAULT;
+				goto fail;
+			}
+		}
+
+		if (recv) {
+			size_t namelen = msg->msg_namelen;
+			size_t controllen = msg->msg_controllen;
+
+			if ((name && Z_SYSCALL_MEMORY_WRITE(name, namelen)) ||
+			    (control &&
+			     Z_SYSCALL_MEMORY_WRITE(control, controllen))) {
+				ret = -EFAULT;
+				goto fail;
+			}
+
+			continue;
+		}
+
+		if (msg->msg_namelen > 0) {
+			msg->msg_name = z_user_alloc_from_copy(
+				name, msg->msg_namelen);
+			if (!msg->msg_name) {
+				ret = -ENOMEM;
+				goto fail;
+			}
+		}
+
+		if (msg->msg_controllen > 0) {
+			msg->msg_control = z_user_alloc_from_copy(
+				control, msg->msg_controllen);
+			if (!msg->msg_control) {
+				ret = -ENOMEM;
+				goto fail;
+			}
+		}
+	}
+
+	*vec_out = vec;
+
+	return 0;
+
+fail:
+	mmsg_free_copy(vec, copied, recv);
+
+	return ret;
+}
+
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *vec;
+	int ret;
+	int i;
+
+	if (vlen == 0U) {
+		return z_impl_zsock_sendmmsg(sock, NULL, 0U, flags);
+	}
+
+	ret = mmsg_copy_from_user(&vec, msgvec, vlen, false);
+	Z_OOPS(ret == -EFAULT);
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	ret = z_impl_zsock_sendmmsg(sock, vec, vlen, flags);
+
+	for (i = 0; i < ret; i++) {
+		if (z_user_to_copy(&msgvec[i].msg_len, &vec[i].msg_len,
+				   sizeof(msgvec[i].msg_len))) {
+			mmsg_free_copy(vec, vlen, false);
+			Z_OOPS(1);
+		}
+	}
+
+	mmsg_free_copy(vec, vlen, false);
+
+	return ret;
+}
+#include <syscalls/zsock_sendmmsg_mrsh.c>
+
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *vec;
+	int ret;
+	int i;
+
+	/* Handing out network buffers only makes sense in supervisor mode */
+	if (flags & ZSOCK_MSG_ZEROCOPY) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (vlen == 0U) {
+		return z_impl_zsock_recvmmsg(sock, NULL, 0U, flags);
+	}
+
+	ret = mmsg_copy_from_user(&vec, msgvec, vlen, true);
+	Z_OOPS(ret == -EFAULT);
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	ret = z_impl_zsock_recvmmsg(sock, vec, vlen, flags);
+
+	for (i = 0; i < ret; i++) {
+		struct msghdr *msg = &msgvec[i].msg_hdr;
+
+		if (z_user_to_copy(&msgvec[i].msg_len, &vec[i].msg_len,
+				   sizeof(msgvec[i].msg_len)) ||
+		    z_user_to_copy(&msg->msg_namelen,
+				   &vec[i].msg_hdr.msg_namelen,
+				   sizeof(msg->msg_namelen)) ||
+		    z_user_to_copy(&msg->msg_controllen,
+				   &vec[i].msg_hdr.msg_controllen,
+				   sizeof(msg->msg_controllen)) ||
+		    z_user_to_copy(&msg->msg_flags, &vec[i].msg_hdr.msg_flags,
+				   sizeof(msg->msg_flags))) {
+			mmsg_free_copy(vec, vlen, true);
+			Z_OOPS(1);
+		}
+	}
+
+	mmsg_free_copy(vec, vlen, true);
+
+	return ret;
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -1715,6 +2433,23 @@ int z_vrfy_zsock_getsockopt(int sock, int level, int optname,
 #include <syscalls/zsock_getsockopt_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+static int sock_set_recv_flag(struct net_context *ctx, uint16_t flag,
+			      const void *optval, socklen_t optlen)
+{
+	if (optval == NULL || optlen != sizeof(int)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (*(const int *)optval) {
+		ctx->flags |= flag;
+	} else {
+		ctx->flags &= ~flag;
+	}
+
+	return 0;
+}
+
 int zsock_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 			 const void *optval, socklen_t optlen)
 {
@@ -1882,10 +2617,30 @@ int zsock_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 			return 0;
 		}
 
+		case SO_TIMESTAMPING:
+			if (IS_ENABLED(CONFIG_NET_PKT_TIMESTAMP)) {
+				return sock_set_recv_flag(
+					ctx, NET_CONTEXT_RECV_TIMESTAMP,
+					optval, optlen);
+			}
+
+			break;
 		}
 
 		break;
 
+	case IPPROTO_IP:
+		switch (optname) {
+		case IP_PKTINFO:
+			return sock_set_recv_flag(ctx, NET_CONTEXT_RECV_PKTINFO,
+						  optval, optlen);
+
+		case IP_RECVTOS:
+			return sock_set_recv_flag(ctx, NET_CONTEXT_RECV_TCLASS,
+						  optval, optlen);
+		}
+		break;
+
 	case IPPROTO_TCP:
 		switch (optname) {
 		case TCP_NODELAY:
@@ -1903,6 +2658,14 @@ int zsock_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 			 * existing apps.
 			 */
 			return 0;
+
+		case IPV6_RECVPKTINFO:
+			return sock_set_recv_flag(ctx, NET_CONTEXT_RECV_PKTINFO,
+						  optval, optlen);
+
+		case IPV6_RECVTCLASS:
+			return sock_set_recv_flag(ctx, NET_CONTEXT_RECV_TCLASS,
+						  optval, optlen);
 		}
 		break;
 	}
@@ -2154,6 +2917,11 @@ static ssize_t sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				  src_addr, addrlen);
 }
 
+static ssize_t sock_recvmsg_vmeth(void *obj, struct msghdr *msg, int flags)
+{
+	return zsock_recvmsg_ctx(obj, msg, flags);
+}
+
 static int sock_getsockopt_vmeth(void *obj, int level, int optname,
 				 void *optval, socklen_t *optlen)
 {
@@ -2191,6 +2959,7 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.sendto = sock_sendto_vmeth,
 	.sendmsg = sock_sendmsg_vmeth,
 	.recvfrom = sock_recvfrom_vmeth,
+	.recvmsg = sock_recvmsg_vmeth,
 	.getsockopt = sock_getsockopt_vmeth,
 	.setsockopt = sock_setsockopt_vmeth,
 	.getsockname = sock_getsockname_vmeth,
@@ -0,0 +1,563 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_sock_epoll, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <kernel.h>
+#include <net/net_context.h>
+#include <net/socket.h>
+#include <syscall_handler.h>
+#include <sys/dlist.h>
+#include <sys/fdtable.h>
+
+#include "sockets_internal.h"
+
+/* Unlike poll(), which has to arm every socket on each call, an epoll
+ * instance keeps its interest set between calls. The receive and accept
+ * callbacks of a registered socket queue its item on the ready list of
+ * the instance, so epoll_wait() only visits sockets that actually have
+ * something to report.
+ *
+ * All epoll state is protected by a single spinlock, as it is touched
+ * both from the RX path and from application threads.
+ */
+
+extern const struct socket_op_vtable sock_fd_op_vtable;
+
+static const struct socket_op_vtable epoll_fd_op_vtable;
+
+struct epoll_item {
+	sys_dnode_t node;
+	struct epoll_instance *ep;
+	struct net_context *ctx;
+	struct zsock_epoll_event event;
+	bool in_use;
+	bool queued;
+};
+
+struct epoll_instance {
+	struct k_sem wait;
+	sys_dlist_t ready;
+	bool in_use;
+	struct epoll_item items[CONFIG_NET_SOCKETS_EPOLL_MAX_FDS];
+};
+
+static struct epoll_instance epolls[CONFIG_NET_SOCKETS_EPOLL_MAX];
+static struct k_spinlock epoll_lock;
+
+static uint32_t epoll_ctx_events(struct net_context *ctx, uint32_t interest)
+{
+	uint32_t events = 0U;
+
+	/* recv_q and accept_q are in union, so this covers listening
+	 * sockets as well.
+	 */
+	if ((interest & ZSOCK_EPOLLIN) &&
+	    (!k_fifo_is_empty(&ctx->recv_q) || sock_is_eof(ctx))) {
+		events |= ZSOCK_EPOLLIN;
+	}
+
+	/* For now, assume that socket is always writable, as poll() does */
+	if (interest & ZSOCK_EPOLLOUT) {
+		events |= ZSOCK_EPOLLOUT;
+	}
+
+	/* Disabled (one-shot) items are not reported even on hang up */
+	if ((interest & (ZSOCK_EPOLLIN | ZSOCK_EPOLLOUT)) && sock_is_eof(ctx)) {
+		events |= ZSOCK_EPOLLHUP;
+	}
+
+	return events;
+}
+
+/* Must be called with epoll_lock held. Returns true if a waiter should
+ * be woken up.
+ */
+static bool epoll_item_queue(struct epoll_item *item)
+{
+	if (item->queued) {
+		return false;
+	}
+
+	if (!epoll_ctx_events(item->ctx, item->event.events)) {
+		return false;
+	}
+
+	item->queued = true;
+	sys_dlist_append(&item->ep->ready, &item->node);
+
+	return true;
+}
+
+/* Must be called with epoll_lock held. */
+static void epoll_item_detach(struct epoll_item *item)
+{
+	if (item->queued) {
+		sys_dlist_remove(&item->node);
+		item->queued = false;
+	}
+
+	item->ctx->epoll_item = NULL;
+	item->ctx = NULL;
+	item->in_use = false;
+}
+
+void zsock_epoll_notify(struct net_context *ctx)
+{
+	struct epoll_item *item;
+	struct epoll_instance *ep = NULL;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&epoll_lock);
+
+	item = ctx->epoll_item;
+	if (item != NULL && epoll_item_queue(item)) {
+		ep = item->ep;
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	if (ep != NULL) {
+		k_sem_give(&ep->wait);
+	}
+}
+
+void zsock_epoll_forget(struct net_context *ctx)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&epoll_lock);
+
+	if (ctx->epoll_item != NULL) {
+		epoll_item_detach(ctx->epoll_item);
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+}
+
+int z_impl_zsock_epoll_create(int size)
+{
+	struct epoll_instance *ep = NULL;
+	k_spinlock_key_t key;
+	int fd;
+
+	if (size <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+
+	for (int i = 0; i < ARRAY_SIZE(epolls); i++) {
+		if (!epolls[i].in_use) {
+			ep = &epolls[i];
+			ep->in_use = true;
+			break;
+		}
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	if (ep == NULL) {
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	k_sem_init(&ep->wait, 0, 1);
+	sys_dlist_init(&ep->ready);
+
+	z_finalize_fd(fd, ep,
+		      (const struct fd_op_vtable *)&epoll_fd_op_vtable);
+
+	NET_DBG("epoll=%p, fd=%d", ep, fd);
+
+	return fd;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_create(int size)
+{
+	return z_impl_zsock_epoll_create(size);
+}
+#include <syscalls/zsock_epoll_create_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+static int epoll_ctl_add(struct epoll_instance *ep, struct net_context *ctx,
+			 const struct zsock_epoll_event *event)
+{
+	struct epoll_item *item = NULL;
+
+	if (ctx->epoll_item != NULL) {
+		/* Either already registered here, or with another
+		 * instance, which is not supported.
+		 */
+		return -EEXIST;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(ep->items); i++) {
+		if (!ep->items[i].in_use) {
+			item = &ep->items[i];
+			break;
+		}
+	}
+
+	if (item == NULL) {
+		return -ENOSPC;
+	}
+
+	item->in_use = true;
+	item->queued = false;
+	item->ep = ep;
+	item->ctx = ctx;
+	item->event = *event;
+	ctx->epoll_item = item;
+
+	return epoll_item_queue(item) ? 1 : 0;
+}
+
+int z_impl_zsock_epoll_ctl(int epfd, int op, int fd,
+			   struct zsock_epoll_event *event)
+{
+	struct epoll_instance *ep;
+	struct net_context *ctx;
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	ep = z_get_fd_obj(epfd,
+			  (const struct fd_op_vtable *)&epoll_fd_op_vtable,
+			  EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	/* Only native sockets report readiness through the receive
+	 * callbacks.
+	 */
+	ctx = z_get_fd_obj(fd,
+			   (const struct fd_op_vtable *)&sock_fd_op_vtable,
+			   EPERM);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (op != ZSOCK_EPOLL_CTL_DEL && event == NULL) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+
+	item = ctx->epoll_item;
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		ret = epoll_ctl_add(ep, ctx, event);
+		break;
+
+	case ZSOCK_EPOLL_CTL_MOD:
+		if (item == NULL || item->ep != ep) {
+			ret = -ENOENT;
+			break;
+		}
+
+		item->event = *event;
+		if (item->queued &&
+		    !epoll_ctx_events(ctx, item->event.events)) {
+			sys_dlist_remove(&item->node);
+			item->queued = false;
+		}
+
+		ret = epoll_item_queue(item) ? 1 : 0;
+		break;
+
+	case ZSOCK_EPOLL_CTL_DEL:
+		if (item == NULL || item->ep != ep) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_item_detach(item);
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	if (ret > 0) {
+		k_sem_give(&ep->wait);
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_ctl(int epfd, int op, int fd,
+					 struct zsock_epoll_event *event)
+{
+	struct zsock_epoll_event event_copy;
+	struct z_object *zo;
+	void *ctx;
+	int ret;
+
+	/* Registering a socket gives access to its events, so the caller
+	 * must have been granted the socket object.
+	 */
+	ctx = z_get_fd_obj(fd,
+			   (const struct fd_op_vtable *)&sock_fd_op_vtable,
+			   EPERM);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	zo = z_object_find(ctx);
+	ret = z_object_validate(zo, K_OBJ_NET_SOCKET, _OBJ_INIT_TRUE);
+	if (ret != 0) {
+		z_dump_object_error(ret, ctx, zo, K_OBJ_NET_SOCKET);
+		errno = EBADF;
+		return -1;
+	}
+
+	if (event != NULL) {
+		Z_OOPS(z_user_from_copy(&event_copy, event,
+					sizeof(event_copy)));
+	}
+
+	return z_impl_zsock_epoll_ctl(epfd, op, fd,
+				      event != NULL ? &event_copy : NULL);
+}
+#include <syscalls/zsock_epoll_ctl_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+/* Must be called with epoll_lock held. Each queued item is visited at
+ * most once: level triggered items which are still ready are put back
+ * at the tail of the ready list, so a busy socket can't starve the
+ * others.
+ */
+static int epoll_collect(struct epoll_instance *ep,
+			 struct zsock_epoll_event *events, int maxevents)
+{
+	sys_dlist_t requeue;
+	sys_dnode_t *node;
+	int count = 0;
+
+	sys_dlist_init(&requeue);
+
+	while (count < maxevents &&
+	       (node = sys_dlist_get(&ep->ready)) != NULL) {
+		struct epoll_item *item =
+			CONTAINER_OF(node, struct epoll_item, node);
+		uint32_t ready;
+
+		ready = epoll_ctx_events(item->ctx, item->event.events);
+		if (!ready) {
+			item->queued = false;
+			continue;
+		}
+
+		events[count].events = ready;
+		events[count].data = item->event.data;
+		count++;
+
+		if (item->event.events & ZSOCK_EPOLLONESHOT) {
+			/* Disabled until re-armed with EPOLL_CTL_MOD */
+			item->event.events = 0U;
+			item->queued = false;
+		} else if (item->event.events & ZSOCK_EPOLLET) {
+			/* Reported again on the next notification only */
+			item->queued = false;
+		} else {
+			sys_dlist_append(&requeue, node);
+		}
+	}
+
+	while ((node = sys_dlist_get(&requeue)) != NULL) {
+		sys_dlist_append(&ep->ready, node);
+	}
+
+	return count;
+}
+
+int z_impl_zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			    int maxevents, int timeout)
+{
+	struct epoll_instance *ep;
+	k_spinlock_key_t key;
+	k_timeout_t tout;
+	uint64_t end;
+	int ret;
+
+	ep = z_get_fd_obj(epfd,
+			  (const struct fd_op_vtable *)&epoll_fd_op_vtable,
+			  EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (timeout < 0) {
+		tout = K_FOREVER;
+	} else {
+		tout = K_MSEC(timeout);
+	}
+
+	end = sys_clock_timeout_end_calc(tout);
+
+	while (true) {
+		key = k_spin_lock(&epoll_lock);
+
+		if (!ep->in_use) {
+			/* Closed while we were waiting */
+			k_spin_unlock(&epoll_lock, key);
+			errno = EBADF;
+			return -1;
+		}
+
+		ret = epoll_collect(ep, events, maxevents);
+
+		k_spin_unlock(&epoll_lock, key);
+
+		if (ret > 0 || K_TIMEOUT_EQ(tout, K_NO_WAIT)) {
+			break;
+		}
+
+		if (!K_TIMEOUT_EQ(tout, K_FOREVER)) {
+			int64_t remaining = end - sys_clock_tick_get();
+
+			if (remaining <= 0) {
+				break;
+			}
+
+			tout = Z_TIMEOUT_TICKS(remaining);
+		}
+
+		/* The semaphore may hold a stale wakeup from an item which
+		 * has already been reported, so always collect again.
+		 */
+		(void)k_sem_take(&ep->wait, tout);
+	}
+
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_wait(int epfd,
+					  struct zsock_epoll_event *events,
+					  int maxevents, int timeout)
+{
+	struct zsock_epoll_event *events_copy;
+	size_t events_size;
+	int ret;
+
+	/* No more than the number of registered sockets can be ready */
+	maxevents = MIN(maxevents, CONFIG_NET_SOCKETS_EPOLL_MAX_FDS);
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	events_size = maxevents * sizeof(struct zsock_epoll_event);
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(events, events_size));
+
+	events_copy = z_user_alloc_from_copy((void *)events, events_size);
+	if (!events_copy) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	ret = z_impl_zsock_epoll_wait(epfd, events_copy, maxevents, timeout);
+	if (ret > 0) {
+		Z_OOPS(z_user_to_copy(events, events_copy,
+				      ret * sizeof(struct zsock_epoll_event)));
+	}
+
+	k_free(events_copy);
+
+	return ret;
+}
+#include <syscalls/zsock_epoll_wait_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+static ssize_t epoll_read_vmeth(void *obj, void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_vmeth(void *obj, const void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(request);
+	ARG_UNUSED(args);
+
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+static int epoll_close_vmeth(void *obj)
+{
+	struct epoll_instance *ep = obj;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&epoll_lock);
+
+	for (int i = 0; i < ARRAY_SIZE(ep->items); i++) {
+		if (ep->items[i].in_use) {
+			epoll_item_detach(&ep->items[i]);
+		}
+	}
+
+	ep->in_use = false;
+
+	k_spin_unlock(&epoll_lock, key);
+
+	/* Wake up a thread still blocked in epoll_wait() */
+	k_sem_give(&ep->wait);
+
+	return 0;
+}
+
+static const struct socket_op_vtable epoll_fd_op_vtable = {
+	.fd_vtable = {
+		.read = epoll_read_vmeth,
+		.write = epoll_write_vmeth,
+		.close = epoll_close_vmeth,
+		.ioctl = epoll_ioctl_vmeth,
+	},
+};
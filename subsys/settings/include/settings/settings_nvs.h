@@ -38,6 +38,17 @@ struct settings_nvs {
 	struct nvs_fs cf_nvs;
 	uint16_t last_name_id;
 	const char *flash_dev_name;
+	/* a batch of saves is in progress, last_name_id is written at the
+	 * end of it
+	 */
+	bool batch;
+	/* largest name ID stored at NVS_NAMECNT_ID */
+	uint16_t last_name_id_stored;
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	/* hash of the name stored at every name ID, 0 if there is none */
+	uint16_t name_hash[CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE];
+	bool index_valid;
+#endif
 };
 
 /* register nvs to be a source of settings */
@@ -12,10 +12,16 @@
 #include "settings/settings_nvs.h"
 #include "settings_priv.h"
 #include <storage/flash_map.h>
+#include <sys/crc.h>
 
 #include <logging/log.h>
 LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
 
+/* Number of name IDs the name counter is raised ahead of the names in use
+ * within a batch of saves.
+ */
+#define NVS_NAMECNT_RESERVE 8
+
 struct settings_nvs_read_fn_arg {
 	struct nvs_fs *fs;
 	uint16_t id;
@@ -23,12 +29,16 @@ struct settings_nvs_read_fn_arg {
 
 static int settings_nvs_load(struct settings_store *cs,
 			     const struct settings_load_arg *arg);
+static int settings_nvs_save_start(struct settings_store *cs);
 static int settings_nvs_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len);
+static int settings_nvs_save_end(struct settings_store *cs);
 
 static struct settings_store_itf settings_nvs_itf = {
 	.csi_load = settings_nvs_load,
+	.csi_save_start = settings_nvs_save_start,
 	.csi_save = settings_nvs_save,
+	.csi_save_end = settings_nvs_save_end,
 };
 
 static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
@@ -48,6 +58,148 @@ static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
 	return rc;
 }
 
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+#define NAME_INDEX_POS(name_id) ((uint16_t)((name_id) - NVS_NAMECNT_ID - 1))
+
+static uint16_t settings_nvs_name_hash(const char *name)
+{
+	uint16_t hash;
+
+	hash = crc16_ccitt(0xffff, (const uint8_t *)name, strlen(name));
+
+	/* 0 marks a name ID without a name */
+	return hash ? hash : 1;
+}
+
+static void settings_nvs_index_set(struct settings_nvs *cf, uint16_t name_id,
+				   uint16_t hash)
+{
+	if (NAME_INDEX_POS(name_id) < CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE) {
+		cf->name_hash[NAME_INDEX_POS(name_id)] = hash;
+	} else if (hash) {
+		/* the name ID is out of the index */
+		cf->index_valid = false;
+	}
+}
+
+static bool settings_nvs_index_fits(struct settings_nvs *cf)
+{
+	return (cf->last_name_id - NVS_NAMECNT_ID) <=
+	       CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE;
+}
+
+/* Read back every stored name once to fill the index */
+static int settings_nvs_index_build(struct settings_nvs *cf)
+{
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	uint16_t name_id;
+	ssize_t rc;
+
+	(void)memset(cf->name_hash, 0, sizeof(cf->name_hash));
+	cf->index_valid = false;
+
+	if (!settings_nvs_index_fits(cf)) {
+		return 0;
+	}
+
+	for (name_id = NVS_NAMECNT_ID + 1; name_id <= cf->last_name_id;
+	     name_id++) {
+		rc = nvs_read(&cf->cf_nvs, name_id, &name, sizeof(name));
+		if (rc == -ENOENT) {
+			continue;
+		}
+		if (rc < 0) {
+			return rc;
+		}
+
+		name[rc] = '\0';
+		settings_nvs_index_set(cf, name_id,
+				       settings_nvs_name_hash(name));
+	}
+
+	cf->index_valid = true;
+	return 0;
+}
+#endif /* CONFIG_SETTINGS_NVS_NAME_INDEX */
+
+/* Find the name ID of a stored name, or NVS_NAMECNT_ID if it is not stored.
+ * free_id is set to the lowest name ID without a name.
+ */
+static uint16_t settings_nvs_name_find(struct settings_nvs *cf,
+				       const char *name, uint16_t *free_id)
+{
+	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	uint16_t name_id;
+	ssize_t rc;
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	uint16_t hash = settings_nvs_name_hash(name);
+#endif
+
+	*free_id = cf->last_name_id + 1;
+
+	for (name_id = cf->last_name_id; name_id > NVS_NAMECNT_ID; name_id--) {
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+		/* only read back the names with the same hash */
+		if (cf->index_valid) {
+			if (cf->name_hash[NAME_INDEX_POS(name_id)] == 0U) {
+				*free_id = name_id;
+				continue;
+			}
+			if (cf->name_hash[NAME_INDEX_POS(name_id)] != hash) {
+				continue;
+			}
+		}
+#endif
+		rc = nvs_read(&cf->cf_nvs, name_id, &rdname, sizeof(rdname));
+
+		if (rc < 0) {
+			/* Error or entry not found */
+			if (rc == -ENOENT) {
+				*free_id = name_id;
+			}
+			continue;
+		}
+
+		rdname[rc] = '\0';
+
+		if (!strcmp(name, rdname)) {
+			return name_id;
+		}
+	}
+
+	return NVS_NAMECNT_ID;
+}
+
+/* Store the largest name ID in use. Within a batch of saves, the stored
+ * value only has to cover every name ID in use, so that a batch cut short
+ * loses no names: it is raised NVS_NAMECNT_RESERVE IDs ahead when needed,
+ * and set to the exact value by settings_nvs_save_end().
+ */
+static int settings_nvs_last_name_id_set(struct settings_nvs *cf,
+					 uint16_t last_name_id)
+{
+	ssize_t rc;
+
+	cf->last_name_id = last_name_id;
+
+	if (cf->batch) {
+		if (last_name_id <= cf->last_name_id_stored) {
+			return 0;
+		}
+		last_name_id = MIN(last_name_id + NVS_NAMECNT_RESERVE,
+				   NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET - 1);
+	}
+
+	rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID, &last_name_id,
+		       sizeof(uint16_t));
+	if (rc < 0) {
+		return rc;
+	}
+
+	cf->last_name_id_stored = last_name_id;
+	return 0;
+}
+
 int settings_nvs_src(struct settings_nvs *cf)
 {
 	cf->cf_store.cs_itf = &settings_nvs_itf;
@@ -75,6 +227,11 @@ static int settings_nvs_load(struct settings_store *cs,
 	ssize_t rc1, rc2;
 	uint16_t name_id = NVS_NAMECNT_ID;
 
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	(void)memset(cf->name_hash, 0, sizeof(cf->name_hash));
+	cf->index_valid = false;
+#endif
+
 	name_id = cf->last_name_id + 1;
 
 	while (1) {
@@ -103,9 +260,8 @@ static int settings_nvs_load(struct settings_store *cs,
 			 * future settings item.
 			 */
 			if (name_id == cf->last_name_id) {
-				cf->last_name_id--;
-				nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID,
-					  &cf->last_name_id, sizeof(uint16_t));
+				(void)settings_nvs_last_name_id_set(
+					cf, cf->last_name_id - 1);
 			}
 			nvs_delete(&cf->cf_nvs, name_id);
 			nvs_delete(&cf->cf_nvs, name_id + NVS_NAME_ID_OFFSET);
@@ -114,6 +270,10 @@ static int settings_nvs_load(struct settings_store *cs,
 
 		/* Found a name, this might not include a trailing \0 */
 		name[rc1] = '\0';
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+		settings_nvs_index_set(cf, name_id,
+				       settings_nvs_name_hash(name));
+#endif
 		read_fn_arg.fs = &cf->cf_nvs;
 		read_fn_arg.id = name_id + NVS_NAME_ID_OFFSET;
 
@@ -125,16 +285,29 @@ static int settings_nvs_load(struct settings_store *cs,
 			break;
 		}
 	}
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	/* a complete pass over the names leaves a complete index */
+	cf->index_valid = (ret == 0) && settings_nvs_index_fits(cf);
+#endif
+
 	return ret;
 }
 
+static int settings_nvs_save_start(struct settings_store *cs)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+
+	cf->batch = true;
+	return 0;
+}
+
 static int settings_nvs_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len)
 {
 	struct settings_nvs *cf = (struct settings_nvs *)cs;
-	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
 	uint16_t name_id, write_name_id;
-	bool delete, write_name;
+	bool delete;
 	int rc = 0;
 
 	if (!name) {
@@ -144,36 +317,24 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 	/* Find out if we are doing a delete */
 	delete = ((value == NULL) || (val_len == 0));
 
-	name_id = cf->last_name_id + 1;
-	write_name_id = cf->last_name_id + 1;
-	write_name = true;
-
-	while (1) {
-		name_id--;
-		if (name_id == NVS_NAMECNT_ID) {
-			break;
-		}
-
-		rc = nvs_read(&cf->cf_nvs, name_id, &rdname, sizeof(rdname));
-
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	if (!cf->index_valid) {
+		rc = settings_nvs_index_build(cf);
 		if (rc < 0) {
-			/* Error or entry not found */
-			if (rc == -ENOENT) {
-				write_name_id = name_id;
-			}
-			continue;
+			return rc;
 		}
+	}
+#endif
 
-		rdname[rc] = '\0';
+	name_id = settings_nvs_name_find(cf, name, &write_name_id);
 
-		if (strcmp(name, rdname)) {
-			continue;
+	if (delete) {
+		if (name_id == NVS_NAMECNT_ID) {
+			return 0;
 		}
 
-		if ((delete) && (name_id == cf->last_name_id)) {
-			cf->last_name_id--;
-			rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID,
-				       &cf->last_name_id, sizeof(uint16_t));
+		if (name_id == cf->last_name_id) {
+			rc = settings_nvs_last_name_id_set(cf, name_id - 1);
 			if (rc < 0) {
 				/* Error: can't to store
 				 * the largest name ID in use.
@@ -182,34 +343,42 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 			}
 		}
 
-		if (delete) {
-			rc = nvs_delete(&cf->cf_nvs, name_id);
+		rc = nvs_delete(&cf->cf_nvs, name_id);
 
-			if (rc >= 0) {
-				rc = nvs_delete(&cf->cf_nvs, name_id +
-					NVS_NAME_ID_OFFSET);
-			}
-
-			if (rc < 0) {
-				return rc;
-			}
+		if (rc >= 0) {
+			rc = nvs_delete(&cf->cf_nvs, name_id +
+				NVS_NAME_ID_OFFSET);
+		}
 
-			return 0;
+		if (rc < 0) {
+			return rc;
 		}
-		write_name_id = name_id;
-		write_name = false;
-		break;
-	}
 
-	if (delete) {
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+		settings_nvs_index_set(cf, name_id, 0U);
+#endif
 		return 0;
 	}
 
+	if (name_id != NVS_NAMECNT_ID) {
+		write_name_id = name_id;
+	}
+
 	/* No free IDs left. */
 	if (write_name_id == NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET) {
 		return -ENOMEM;
 	}
 
+	/* update the last_name_id and write to flash if required, before
+	 * the entries it has to cover
+	 */
+	if (write_name_id > cf->last_name_id) {
+		rc = settings_nvs_last_name_id_set(cf, write_name_id);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
 	/* write the value */
 	rc = nvs_write(&cf->cf_nvs, write_name_id + NVS_NAME_ID_OFFSET,
 		       value, val_len);
@@ -218,25 +387,31 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 	}
 
 	/* write the name if required */
-	if (write_name) {
+	if (name_id == NVS_NAMECNT_ID) {
 		rc = nvs_write(&cf->cf_nvs, write_name_id, name, strlen(name));
 		if (rc < 0) {
 			return rc;
 		}
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+		settings_nvs_index_set(cf, write_name_id,
+				       settings_nvs_name_hash(name));
+#endif
 	}
 
-	/* update the last_name_id and write to flash if required*/
-	if (write_name_id > cf->last_name_id) {
-		cf->last_name_id = write_name_id;
-		rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID, &cf->last_name_id,
-			       sizeof(uint16_t));
-	}
+	return 0;
+}
 
-	if (rc < 0) {
-		return rc;
+static int settings_nvs_save_end(struct settings_store *cs)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+
+	cf->batch = false;
+
+	if (cf->last_name_id == cf->last_name_id_stored) {
+		return 0;
 	}
 
-	return 0;
+	return settings_nvs_last_name_id_set(cf, cf->last_name_id);
 }
 
 /* Initialize the nvs backend. */
@@ -257,6 +432,12 @@ int settings_nvs_backend_init(struct settings_nvs *cf)
 	} else {
 		cf->last_name_id = last_name_id;
 	}
+	cf->last_name_id_stored = cf->last_name_id;
+	cf->batch = false;
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	cf->index_valid = false;
+#endif
 
 	LOG_DBG("Initialized");
 	return 0;
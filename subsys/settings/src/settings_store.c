@@ -34,6 +34,201 @@ void settings_dst_register(struct settings_store *cs)
 	settings_save_dst = cs;
 }
 
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+/* A value saved by settings_save_one() but not written to the backend yet,
+ * val_len 0 is a delete.
+ */
+struct settings_wb_entry {
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	uint8_t value[CONFIG_SETTINGS_WRITE_BACK_VAL_LEN];
+	uint16_t val_len;
+	bool used;
+};
+
+static struct settings_wb_entry settings_wb[CONFIG_SETTINGS_WRITE_BACK_ENTRIES];
+static uint8_t settings_wb_count;
+static struct settings_write_back_stats settings_wb_stats;
+static struct k_work_delayable settings_wb_work;
+
+static struct settings_wb_entry *settings_wb_find(const char *name)
+{
+	for (int i = 0; i < ARRAY_SIZE(settings_wb); i++) {
+		if (settings_wb[i].used && !strcmp(settings_wb[i].name, name)) {
+			return &settings_wb[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Write all pending values in one batch, settings_lock must be held. Values
+ * that could not be written stay pending for the next batch.
+ */
+static int settings_wb_flush(struct settings_store *cs)
+{
+	struct settings_wb_entry *entry;
+	int rc;
+	int rc2;
+
+	(void)k_work_cancel_delayable(&settings_wb_work);
+
+	if (cs->cs_itf->csi_save_start) {
+		cs->cs_itf->csi_save_start(cs);
+	}
+	rc = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(settings_wb); i++) {
+		entry = &settings_wb[i];
+		if (!entry->used) {
+			continue;
+		}
+
+		rc2 = cs->cs_itf->csi_save(cs, entry->name,
+					   entry->val_len ?
+					   (char *)entry->value : NULL,
+					   entry->val_len);
+		if (rc2) {
+			settings_wb_stats.errors++;
+			if (!rc) {
+				rc = rc2;
+			}
+			continue;
+		}
+
+		settings_wb_stats.written++;
+		entry->used = false;
+		settings_wb_count--;
+	}
+
+	if (cs->cs_itf->csi_save_end) {
+		rc2 = cs->cs_itf->csi_save_end(cs);
+		if (!rc) {
+			rc = rc2;
+		}
+	}
+
+	settings_wb_stats.batches++;
+
+	/* retry the values left pending */
+	if (settings_wb_count) {
+		(void)k_work_schedule(
+			&settings_wb_work,
+			K_MSEC(CONFIG_SETTINGS_WRITE_BACK_DELAY_MS));
+	}
+
+	return rc;
+}
+
+/* Hold back a value, settings_lock must be held. Returns -EFBIG if the
+ * value must be written to the backend directly.
+ */
+static int settings_wb_save(struct settings_store *cs, const char *name,
+			    const void *value, size_t val_len)
+{
+	struct settings_wb_entry *entry;
+	int rc;
+
+	if (value == NULL) {
+		val_len = 0;
+	}
+
+	entry = settings_wb_find(name);
+
+	if ((val_len > sizeof(entry->value)) ||
+	    (strlen(name) >= sizeof(entry->name))) {
+		/* the direct write supersedes the pending value */
+		if (entry) {
+			entry->used = false;
+			settings_wb_count--;
+		}
+		return -EFBIG;
+	}
+
+	if (entry) {
+		settings_wb_stats.coalesced++;
+	} else {
+		if (settings_wb_count == ARRAY_SIZE(settings_wb)) {
+			rc = settings_wb_flush(cs);
+			if (rc) {
+				return rc;
+			}
+		}
+
+		entry = settings_wb;
+		while (entry->used) {
+			entry++;
+		}
+
+		strcpy(entry->name, name);
+		entry->used = true;
+		settings_wb_count++;
+	}
+
+	if (val_len) {
+		memcpy(entry->value, value, val_len);
+	}
+	entry->val_len = val_len;
+	settings_wb_stats.saves++;
+
+	/* the delay runs from the oldest pending value */
+	(void)k_work_schedule(&settings_wb_work,
+			      K_MSEC(CONFIG_SETTINGS_WRITE_BACK_DELAY_MS));
+
+	return 0;
+}
+
+static void settings_wb_work_handler(struct k_work *work)
+{
+	int rc;
+
+	ARG_UNUSED(work);
+
+	rc = settings_flush();
+	if (rc) {
+		LOG_ERR("write-back failed (err %d)", rc);
+	}
+}
+
+int settings_write_back_stats_get(struct settings_write_back_stats *stats)
+{
+	k_mutex_lock(&settings_lock, K_FOREVER);
+	*stats = settings_wb_stats;
+	k_mutex_unlock(&settings_lock);
+
+	return 0;
+}
+#else
+int settings_write_back_stats_get(struct settings_write_back_stats *stats)
+{
+	ARG_UNUSED(stats);
+
+	return -ENOTSUP;
+}
+#endif /* CONFIG_SETTINGS_WRITE_BACK */
+
+int settings_flush(void)
+{
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+	struct settings_store *cs;
+	int rc = 0;
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	cs = settings_save_dst;
+	if (settings_wb_count && !cs) {
+		rc = -ENOENT;
+	} else if (settings_wb_count) {
+		rc = settings_wb_flush(cs);
+	}
+
+	k_mutex_unlock(&settings_lock);
+
+	return rc;
+#else
+	return 0;
+#endif
+}
+
 int settings_load(void)
 {
 	return settings_load_subtree(NULL);
@@ -54,6 +249,8 @@ int settings_load_subtree(const char *subtree)
 	 *    commit all
 	 */
 	k_mutex_lock(&settings_lock, K_FOREVER);
+	/* the sources only know the values written to storage */
+	(void)settings_flush();
 	SYS_SLIST_FOR_EACH_CONTAINER(&settings_load_srcs, cs, cs_next) {
 		cs->cs_itf->csi_load(cs, &arg);
 	}
@@ -81,6 +278,7 @@ int settings_load_subtree_direct(
 	 *    commit all
 	 */
 	k_mutex_lock(&settings_lock, K_FOREVER);
+	(void)settings_flush();
 	SYS_SLIST_FOR_EACH_CONTAINER(&settings_load_srcs, cs, cs_next) {
 		cs->cs_itf->csi_load(cs, &arg);
 	}
@@ -103,7 +301,14 @@ int settings_save_one(const char *name, const void *value, size_t val_len)
 
 	k_mutex_lock(&settings_lock, K_FOREVER);
 
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+	rc = settings_wb_save(cs, name, value, val_len);
+	if (rc == -EFBIG) {
+		rc = cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
+	}
+#else
 	rc = cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
+#endif
 
 	k_mutex_unlock(&settings_lock);
 
@@ -115,6 +320,48 @@ int settings_delete(const char *name)
 	return settings_save_one(name, NULL, 0);
 }
 
+int settings_save_batch(const struct settings_batch_item *items,
+			size_t count)
+{
+	struct settings_store *cs;
+	int rc;
+	int rc2;
+
+	cs = settings_save_dst;
+	if (!cs) {
+		return -ENOENT;
+	}
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	/* pending values must not overwrite the batch later */
+	rc = settings_flush();
+
+	if (cs->cs_itf->csi_save_start) {
+		cs->cs_itf->csi_save_start(cs);
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		rc2 = cs->cs_itf->csi_save(cs, items[i].name,
+					   (char *)items[i].value,
+					   items[i].val_len);
+		if (!rc) {
+			rc = rc2;
+		}
+	}
+
+	if (cs->cs_itf->csi_save_end) {
+		rc2 = cs->cs_itf->csi_save_end(cs);
+		if (!rc) {
+			rc = rc2;
+		}
+	}
+
+	k_mutex_unlock(&settings_lock);
+
+	return rc;
+}
+
 int settings_save(void)
 {
 	struct settings_store *cs;
@@ -155,10 +402,20 @@ int settings_save(void)
 	if (cs->cs_itf->csi_save_end) {
 		cs->cs_itf->csi_save_end(cs);
 	}
+
+	/* the exported values may have been held back */
+	rc2 = settings_flush();
+	if (!rc) {
+		rc = rc2;
+	}
+
 	return rc;
 }
 
 void settings_store_init(void)
 {
 	sys_slist_init(&settings_load_srcs);
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+	k_work_init_delayable(&settings_wb_work, settings_wb_work_handler);
+#endif
 }
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_TESTS_BENCHMARKS_COMMON_BENCH_TIME_H_
+#define ZEPHYR_TESTS_BENCHMARKS_COMMON_BENCH_TIME_H_
+
+#include <zephyr.h>
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+/* The simulated clock of native_posix only moves while the CPU idles, so
+ * busy loops are timed with the host clock instead.
+ */
+extern uint64_t get_host_us_time(void);
+#endif
+
+/**
+ * @brief Read a monotonic time stamp for benchmark measurements.
+ *
+ * @return Time stamp in nanoseconds.
+ */
+static inline uint64_t bench_time_ns(void)
+{
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	return get_host_us_time() * NSEC_PER_USEC;
+#else
+	return k_ticks_to_ns_floor64(k_uptime_ticks());
+#endif
+}
+
+/**
+ * @brief Read a monotonic time stamp for benchmark measurements.
+ *
+ * @return Time stamp in microseconds.
+ */
+static inline uint64_t bench_time_us(void)
+{
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	return get_host_us_time();
+#else
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+#endif
+}
+
+#endif /* ZEPHYR_TESTS_BENCHMARKS_COMMON_BENCH_TIME_H_ */
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+
+#include "../../common/bench_time.h"
+
+/* This is a k_heap contention microbenchmark:
+ *
+ * 1. N_THREADS threads at the same priority each hold WORKING_SET
+ *    live blocks of a shared heap
+ * 2. Each iteration frees one block and allocates a replacement of
+ *    pseudo-random size up to MAX_ALLOC bytes
+ * 3. The main thread reports the average cost of an alloc/free pair
+ *    over all threads
+ *
+ * Switch CONFIG_K_HEAP_CACHE and CONFIG_SMP to compare.
+ */
+
+#define N_THREADS 4
+#define ITERATIONS 20000
+#define WORKING_SET 8
+#define MAX_ALLOC 120
+#define HEAP_SIZE (N_THREADS * WORKING_SET * 512)
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+K_HEAP_DEFINE(bench_heap, HEAP_SIZE);
+
+K_THREAD_STACK_ARRAY_DEFINE(stacks, N_THREADS, STACK_SIZE);
+static struct k_thread threads[N_THREADS];
+
+static uint32_t failed[N_THREADS];
+static K_SEM_DEFINE(start_sem, 0, N_THREADS);
+static K_SEM_DEFINE(done_sem, 0, N_THREADS);
+
+static void bench_thread(void *p1, void *p2, void *p3)
+{
+	int id = POINTER_TO_INT(p1);
+	uint32_t rand_state = 12345U + id;
+	void *blocks[WORKING_SET] = { 0 };
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sem_take(&start_sem, K_FOREVER);
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		int slot = i % WORKING_SET;
+		size_t sz;
+
+		/* Deterministic LCG so every configuration sees the
+		 * same sequence
+		 */
+		rand_state = rand_state * 1103515245U + 12345U;
+		sz = 1 + ((rand_state >> 8) % MAX_ALLOC);
+
+		k_heap_free(&bench_heap, blocks[slot]);
+		blocks[slot] = k_heap_alloc(&bench_heap, sz, K_NO_WAIT);
+		if (blocks[slot] == NULL) {
+			failed[id]++;
+			continue;
+		}
+		memset(blocks[slot], id, sz);
+	}
+
+	for (int i = 0; i < WORKING_SET; i++) {
+		k_heap_free(&bench_heap, blocks[i]);
+	}
+
+	k_sem_give(&done_sem);
+}
+
+void main(void)
+{
+	uint64_t start, ns;
+	uint32_t fail = 0U;
+	uint32_t ops = N_THREADS * ITERATIONS;
+
+	printk("k_heap benchmark: %d CPUs, cache %s\n", CONFIG_MP_NUM_CPUS,
+	       IS_ENABLED(CONFIG_K_HEAP_CACHE) ? "on" : "off");
+
+	for (int i = 0; i < N_THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				bench_thread, INT_TO_POINTER(i), NULL, NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	/* Let them all reach the start line first */
+	k_msleep(10);
+
+	start = bench_time_ns();
+	for (int i = 0; i < N_THREADS; i++) {
+		k_sem_give(&start_sem);
+	}
+	for (int i = 0; i < N_THREADS; i++) {
+		k_sem_take(&done_sem, K_FOREVER);
+	}
+	ns = bench_time_ns() - start;
+
+	for (int i = 0; i < N_THREADS; i++) {
+		fail += failed[i];
+	}
+
+	printk("threads %d ops %u failed %u ns/op %u\n",
+	       N_THREADS, ops, fail, (uint32_t)(ns / ops));
+
+#ifdef CONFIG_K_HEAP_CACHE
+	struct k_heap_cache_stats stats;
+
+	k_heap_cache_stats_get(&bench_heap, &stats);
+	printk("cache hits %u misses %u frees %u refills %u drains %u cached %zu\n",
+	       stats.alloc_hits, stats.alloc_misses, stats.free_hits,
+	       stats.refills, stats.drains, stats.cached_bytes);
+#endif
+
+	printk("fin\n");
+}
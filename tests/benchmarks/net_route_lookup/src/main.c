@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <random/rand32.h>
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+
+#include "ipv6.h"
+#include "route.h"
+#include "../../common/bench_time.h"
+
+/* This is a routing table lookup benchmark:
+ *
+ * 1. NBR_COUNT static neighbors are added to the loopback interface
+ * 2. For every table size, that many non-overlapping prefixes are routed
+ *    through the neighbors in turn
+ * 3. LOOKUPS random destinations inside the routed prefixes are looked up
+ *    ROUNDS times, and the average time of one route lookup and of one
+ *    neighbor lookup is reported
+ */
+
+#define ROUNDS 16
+#define LOOKUPS 1024
+#define NBR_COUNT 32
+
+static const int table_sizes[] = { 16, 64, CONFIG_NET_MAX_ROUTES };
+
+static struct in6_addr nbr_addr[NBR_COUNT];
+static struct in6_addr dst_addr[LOOKUPS];
+static struct net_if *iface;
+static uint32_t errors;
+
+/* Spread the prefixes over the address space: the multiplier is odd so
+ * distinct indexes still give distinct 16-bit values.
+ */
+static void route_prefix(int idx, struct in6_addr *addr, uint8_t *len)
+{
+	uint16_t tag = (uint16_t)(idx * 40503U);
+
+	memset(addr, 0, sizeof(*addr));
+	addr->s6_addr16[0] = htons(0x2001);
+	addr->s6_addr16[1] = htons(0x0db8);
+	addr->s6_addr16[2] = htons(tag);
+
+	*len = 48U + (idx % 3) * 8U;
+}
+
+static int add_neighbors(void)
+{
+	for (int i = 0; i < NBR_COUNT; i++) {
+		uint8_t mac[] = { 0x02, 0x00, 0x5e, 0x00, 0x53, i };
+		struct net_linkaddr lladdr = {
+			.addr = mac,
+			.len = sizeof(mac),
+			.type = NET_LINK_ETHERNET,
+		};
+
+		net_ipv6_addr_create(&nbr_addr[i], 0xfe80, 0, 0, 0,
+				     0, 0, 0, i + 1);
+
+		if (!net_ipv6_nbr_add(iface, &nbr_addr[i], &lladdr, false,
+				      NET_IPV6_NBR_STATE_STATIC)) {
+			return -ENOMEM;
+		}
+	}
+
+	return 0;
+}
+
+static int fill(int count)
+{
+	for (int i = 0; i < count; i++) {
+		struct in6_addr prefix;
+		uint8_t len;
+
+		route_prefix(i, &prefix, &len);
+
+		if (!net_route_add(iface, &prefix, len,
+				   &nbr_addr[i % NBR_COUNT])) {
+			return -ENOMEM;
+		}
+	}
+
+	for (int i = 0; i < LOOKUPS; i++) {
+		uint8_t len;
+
+		route_prefix(sys_rand32_get() % count, &dst_addr[i], &len);
+		dst_addr[i].s6_addr32[3] = sys_rand32_get();
+	}
+
+	return 0;
+}
+
+static void flush(void)
+{
+	for (int i = 0; i < NBR_COUNT; i++) {
+		net_route_del_by_nexthop(iface, &nbr_addr[i]);
+	}
+}
+
+static uint32_t run_route(void)
+{
+	uint64_t ns = 0U;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t start = bench_time_ns();
+
+		for (int i = 0; i < LOOKUPS; i++) {
+			if (!net_route_lookup(iface, &dst_addr[i])) {
+				errors++;
+			}
+		}
+
+		ns += bench_time_ns() - start;
+	}
+
+	return (uint32_t)(ns / ((uint64_t)ROUNDS * LOOKUPS));
+}
+
+static uint32_t run_nbr(void)
+{
+	uint64_t ns = 0U;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t start = bench_time_ns();
+
+		for (int i = 0; i < LOOKUPS; i++) {
+			if (!net_ipv6_nbr_lookup(iface,
+						 &nbr_addr[i % NBR_COUNT])) {
+				errors++;
+			}
+		}
+
+		ns += bench_time_ns() - start;
+	}
+
+	return (uint32_t)(ns / ((uint64_t)ROUNDS * LOOKUPS));
+}
+
+void main(void)
+{
+	printk("Network route lookup benchmark: %d rounds, %d neighbors, "
+	       "trie %d\n", ROUNDS, NBR_COUNT,
+	       IS_ENABLED(CONFIG_NET_ROUTE_TRIE));
+
+	iface = net_if_get_default();
+
+	if (add_neighbors() < 0) {
+		printk("cannot add neighbors\n");
+		return;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(table_sizes); i++) {
+		uint32_t route, nbr;
+
+		if (fill(table_sizes[i]) < 0) {
+			printk("cannot add %d routes\n", table_sizes[i]);
+			errors++;
+			flush();
+			continue;
+		}
+
+		route = run_route();
+		nbr = run_nbr();
+
+		printk("routes %4d lookup %u nbr %u ns\n",
+		       table_sizes[i], route, nbr);
+
+		flush();
+	}
+
+	if (errors) {
+		printk("%u errors\n", errors);
+		return;
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <net/socket.h>
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+
+#include "ipv4.h"
+#include "udp_internal.h"
+#include "../../common/bench_time.h"
+
+/* This is a network RX path benchmark:
+ *
+ * 1. A UDP socket is bound to SERVER_PORT on the loopback interface
+ * 2. For every burst size, the main thread builds a burst of datagrams and
+ *    passes it to the stack either packet by packet with net_recv_data()
+ *    or at once with net_recv_data_batch(), like a driver would
+ * 3. The burst is read back from the socket, and the average time from
+ *    injection to reception of one packet is reported for both methods
+ */
+
+#define ROUNDS 200
+#define PAYLOAD_LEN 64
+#define SERVER_PORT 4242
+#define CLIENT_PORT 4243
+#define MAX_BURST 16
+
+static const int burst_sizes[] = { 1, 4, MAX_BURST };
+
+static struct net_pkt *pkts[MAX_BURST];
+static uint8_t payload[PAYLOAD_LEN];
+static struct in_addr src_addr = { { { 192, 0, 2, 2 } } };
+static struct in_addr dst_addr;
+static struct net_if *iface;
+static uint32_t errors;
+static int sock;
+
+static struct net_pkt *build_pkt(void)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, sizeof(payload), AF_INET,
+					   IPPROTO_UDP, K_FOREVER);
+	if (!pkt) {
+		return NULL;
+	}
+
+	if (net_ipv4_create(pkt, &src_addr, &dst_addr) ||
+	    net_udp_create(pkt, htons(CLIENT_PORT), htons(SERVER_PORT)) ||
+	    net_pkt_write(pkt, payload, sizeof(payload))) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_ipv4_finalize(pkt, IPPROTO_UDP) < 0) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	return pkt;
+}
+
+static void inject(int count, bool batch)
+{
+	if (batch) {
+		if (net_recv_data_batch(iface, pkts, count) != count) {
+			errors++;
+		}
+
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		if (net_recv_data(iface, pkts[i]) < 0) {
+			net_pkt_unref(pkts[i]);
+			errors++;
+		}
+	}
+}
+
+static uint32_t run(int count, bool batch)
+{
+	static uint8_t rx[PAYLOAD_LEN];
+	uint64_t ns = 0U;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t start;
+		int i;
+
+		/* Building the packets is the same for both methods */
+		for (i = 0; i < count; i++) {
+			pkts[i] = build_pkt();
+			if (!pkts[i]) {
+				break;
+			}
+		}
+
+		if (i < count) {
+			while (i-- > 0) {
+				net_pkt_unref(pkts[i]);
+			}
+
+			errors++;
+			continue;
+		}
+
+		start = bench_time_ns();
+
+		inject(count, batch);
+
+		for (i = 0; i < count; i++) {
+			if (recv(sock, rx, sizeof(rx), 0) != sizeof(rx)) {
+				errors++;
+			}
+		}
+
+		ns += bench_time_ns() - start;
+	}
+
+	return (uint32_t)(ns / ((uint64_t)ROUNDS * count));
+}
+
+void main(void)
+{
+	struct sockaddr_in addr;
+
+	printk("Network RX batching benchmark: %d rounds, RX threads %d\n",
+	       ROUNDS, CONFIG_NET_TC_RX_COUNT);
+
+	memset(payload, 'a', sizeof(payload));
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &dst_addr);
+
+	iface = net_if_get_default();
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0) {
+		printk("cannot create socket: %d\n", errno);
+		return;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+	addr.sin_addr = dst_addr;
+
+	if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printk("cannot bind socket: %d\n", errno);
+		return;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(burst_sizes); i++) {
+		uint32_t single, batch;
+
+		single = run(burst_sizes[i], false);
+		batch = run(burst_sizes[i], true);
+
+		printk("burst %2d single %u batch %u ns/pkt\n",
+		       burst_sizes[i], single, batch);
+	}
+
+	if (errors) {
+		printk("%u errors\n", errors);
+		return;
+	}
+
+	printk("fin\n");
+}
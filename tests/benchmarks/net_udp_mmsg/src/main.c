@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <net/socket.h>
+
+#include "../../common/bench_time.h"
+
+/* This is a UDP socket API benchmark:
+ *
+ * 1. A client and a server UDP socket are opened on the loopback interface
+ * 2. The client sends bursts of BATCH datagrams to the server, either with
+ *    one sendto() call per datagram or with a single sendmmsg() call
+ * 3. The server reads every burst back with recv() or recvmmsg(), and the
+ *    send and receive rates are reported in packets per second
+ */
+
+#define ROUNDS 256
+#define BATCH 16
+#define PAYLOAD_LEN 32
+#define SERVER_PORT 4242
+
+static uint8_t payload[PAYLOAD_LEN];
+static uint8_t rx_bufs[BATCH][PAYLOAD_LEN];
+static struct iovec tx_iov;
+static struct iovec rx_iov[BATCH];
+static struct mmsghdr tx_msgs[BATCH];
+static struct mmsghdr rx_msgs[BATCH];
+static struct sockaddr_in server_addr;
+static uint32_t errors;
+static int client;
+static int server;
+
+static void send_single(void)
+{
+	for (int i = 0; i < BATCH; i++) {
+		if (sendto(client, payload, sizeof(payload), 0,
+			   (struct sockaddr *)&server_addr,
+			   sizeof(server_addr)) != sizeof(payload)) {
+			errors++;
+		}
+	}
+}
+
+static void send_batch(void)
+{
+	if (sendmmsg(client, tx_msgs, BATCH, 0) != BATCH) {
+		errors++;
+	}
+}
+
+static void recv_single(void)
+{
+	for (int i = 0; i < BATCH; i++) {
+		if (recv(server, rx_bufs[i], sizeof(rx_bufs[i]), 0) !=
+		    sizeof(rx_bufs[i])) {
+			errors++;
+		}
+	}
+}
+
+static void recv_batch(void)
+{
+	int count = 0;
+
+	/* Only wait for the first datagram, the rest of the burst may still
+	 * be on its way through the stack.
+	 */
+	while (count < BATCH) {
+		int ret;
+
+		ret = recvmmsg(server, &rx_msgs[count], BATCH - count,
+			       MSG_WAITFORONE);
+		if (ret <= 0) {
+			errors++;
+			break;
+		}
+
+		count += ret;
+	}
+}
+
+static uint32_t pkts_per_sec(uint64_t us)
+{
+	if (us == 0U) {
+		return 0U;
+	}
+
+	return (uint32_t)((uint64_t)ROUNDS * BATCH * USEC_PER_SEC / us);
+}
+
+static void run(bool batch, uint32_t *tx_rate, uint32_t *rx_rate)
+{
+	uint64_t tx_us = 0U;
+	uint64_t rx_us = 0U;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t start, sent;
+
+		start = bench_time_us();
+
+		if (batch) {
+			send_batch();
+		} else {
+			send_single();
+		}
+
+		sent = bench_time_us();
+
+		if (batch) {
+			recv_batch();
+		} else {
+			recv_single();
+		}
+
+		tx_us += sent - start;
+		rx_us += bench_time_us() - sent;
+	}
+
+	*tx_rate = pkts_per_sec(tx_us);
+	*rx_rate = pkts_per_sec(rx_us);
+}
+
+static int setup(void)
+{
+	server_addr.sin_family = AF_INET;
+	server_addr.sin_port = htons(SERVER_PORT);
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+		  &server_addr.sin_addr);
+
+	server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (server < 0 || client < 0) {
+		printk("cannot create sockets: %d\n", errno);
+		return -1;
+	}
+
+	if (bind(server, (struct sockaddr *)&server_addr,
+		 sizeof(server_addr)) < 0) {
+		printk("cannot bind socket: %d\n", errno);
+		return -1;
+	}
+
+	memset(payload, 'a', sizeof(payload));
+
+	tx_iov.iov_base = payload;
+	tx_iov.iov_len = sizeof(payload);
+
+	for (int i = 0; i < BATCH; i++) {
+		tx_msgs[i].msg_hdr.msg_iov = &tx_iov;
+		tx_msgs[i].msg_hdr.msg_iovlen = 1;
+		tx_msgs[i].msg_hdr.msg_name = &server_addr;
+		tx_msgs[i].msg_hdr.msg_namelen = sizeof(server_addr);
+
+		rx_iov[i].iov_base = rx_bufs[i];
+		rx_iov[i].iov_len = sizeof(rx_bufs[i]);
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	return 0;
+}
+
+void main(void)
+{
+	uint32_t tx_rate, rx_rate;
+
+	printk("UDP batched socket calls benchmark: %d rounds of %d "
+	       "datagrams, %d bytes each\n", ROUNDS, BATCH, PAYLOAD_LEN);
+
+	if (setup() < 0) {
+		return;
+	}
+
+	run(false, &tx_rate, &rx_rate);
+	printk("single send %u recv %u pkts/s\n", tx_rate, rx_rate);
+
+	run(true, &tx_rate, &rx_rate);
+	printk("batch send %u recv %u pkts/s\n", tx_rate, rx_rate);
+
+	if (errors) {
+		printk("%u errors\n", errors);
+		return;
+	}
+
+	printk("fin\n");
+}
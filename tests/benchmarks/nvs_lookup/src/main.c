@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
+#include <fs/nvs.h>
+
+/* This is an NVS entry lookup benchmark:
+ *
+ * 1. For every entry count, the storage partition is cleared and the ids
+ *    0 to count - 1 are written once, in order
+ * 2. The file system is initialized again, and the cost of nvs_init() is
+ *    reported
+ * 3. All ids are read back ROUNDS times, and the average cost of one read
+ *    is reported together with the cost of reading the newest and the
+ *    oldest id
+ */
+
+#define ROUNDS 4
+#define SECTOR_COUNT 32U
+
+static const uint16_t entry_counts[] = { 16, 128, 1024 };
+
+static struct nvs_fs fs;
+static uint32_t errors;
+
+static int fs_mount(void)
+{
+	int err;
+	const struct flash_area *fa;
+	struct flash_pages_info info;
+
+	err = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	if (err) {
+		return err;
+	}
+
+	fs.offset = FLASH_AREA_OFFSET(storage);
+	err = flash_get_page_info_by_offs(flash_area_get_device(fa), fs.offset,
+					  &info);
+	flash_area_close(fa);
+	if (err) {
+		return err;
+	}
+
+	fs.sector_size = info.size;
+	fs.sector_count = SECTOR_COUNT;
+
+	return nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+}
+
+static int fill(uint16_t count)
+{
+	for (uint32_t id = 0U; id < count; id++) {
+		if (nvs_write(&fs, id, &id, sizeof(id)) != sizeof(id)) {
+			return -EIO;
+		}
+	}
+
+	return 0;
+}
+
+static uint32_t time_read(uint16_t id)
+{
+	uint32_t data = 0U;
+	uint32_t start;
+	ssize_t len;
+
+	start = k_cycle_get_32();
+	len = nvs_read(&fs, id, &data, sizeof(data));
+	start = k_cycle_get_32() - start;
+
+	if ((len != sizeof(data)) || (data != id)) {
+		errors++;
+	}
+
+	return start;
+}
+
+void main(void)
+{
+	uint32_t start, init, read, newest, oldest;
+	uint16_t count;
+	int err;
+
+	printk("NVS lookup benchmark: %d rounds, %u sectors, cache %s\n",
+	       ROUNDS, SECTOR_COUNT,
+	       IS_ENABLED(CONFIG_NVS_LOOKUP_CACHE) ? "on" : "off");
+
+	for (int i = 0; i < ARRAY_SIZE(entry_counts); i++) {
+		count = entry_counts[i];
+
+		err = fs_mount();
+		if (!err) {
+			err = nvs_clear(&fs);
+		}
+		if (!err) {
+			err = fs_mount();
+		}
+		if (!err) {
+			err = fill(count);
+		}
+		if (err) {
+			printk("cannot store %u entries: %d\n", count, err);
+			break;
+		}
+
+		start = k_cycle_get_32();
+		err = fs_mount();
+		init = k_cycle_get_32() - start;
+		if (err) {
+			printk("cannot mount: %d\n", err);
+			break;
+		}
+
+		read = 0U;
+		for (int round = 0; round < ROUNDS; round++) {
+			for (uint16_t id = 0U; id < count; id++) {
+				read += time_read(id);
+			}
+		}
+
+		newest = time_read(count - 1);
+		oldest = time_read(0);
+
+		printk("entries %4u init %u read %u newest %u oldest %u "
+		       "cycles\n", count, init, read / (ROUNDS * count),
+		       newest, oldest);
+	}
+
+	if (errors) {
+		printk("%u errors\n", errors);
+		return;
+	}
+
+	printk("fin\n");
+}
@@ -27,11 +27,29 @@
  * It then iterates this many times, reporting timestamp latencies
  * between each numbered step and for the whole cycle, and a running
  * average for all cycles run.
+ *
+ * To compare ready queue backends under load rather than with a
+ * near-empty queue, N_FILLER runnable threads are spread over the
+ * priorities below the main thread.  They never get to run once the
+ * measurement starts, they just sit in the run queue.
  */
 
 #define N_RUNS 1000
 #define N_SETTLE 10
+#define N_FILLER 32
+
+#if defined(CONFIG_SCHED_DUMB)
+#define BACKEND "dumb"
+#elif defined(CONFIG_SCHED_SCALABLE)
+#define BACKEND "scalable"
+#elif defined(CONFIG_SCHED_MULTIQ)
+#define BACKEND "multiq"
+#elif defined(CONFIG_SCHED_BITMAP)
+#define BACKEND "bitmap"
+#endif
 
+static K_THREAD_STACK_ARRAY_DEFINE(filler_stacks, N_FILLER, 512);
+static struct k_thread filler_threads[N_FILLER];
 
 static K_THREAD_STACK_DEFINE(partner_stack, 1024);
 static struct k_thread partner_thread;
@@ -86,12 +104,34 @@ static void partner_fn(void *arg1, void *arg2, void *arg3)
 	}
 }
 
+static void filler_fn(void *arg1, void *arg2, void *arg3)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		k_busy_wait(1000);
+	}
+}
+
 void main(void)
 {
 	z_waitq_init(&waitq);
 
 	int main_prio = k_thread_priority_get(k_current_get());
 	int partner_prio = main_prio - 1;
+	int n_lower = K_LOWEST_APPLICATION_THREAD_PRIO - main_prio;
+
+	printk("Ready queue backend: %s, %d filler threads\n", BACKEND,
+	       n_lower > 0 ? N_FILLER : 0);
+
+	for (int i = 0; n_lower > 0 && i < N_FILLER; i++) {
+		k_thread_create(&filler_threads[i], filler_stacks[i],
+				K_THREAD_STACK_SIZEOF(filler_stacks[i]),
+				filler_fn, NULL, NULL, NULL,
+				main_prio + 1 + (i % n_lower), 0, K_NO_WAIT);
+	}
 
 	k_tid_t th = k_thread_create(&partner_thread, partner_stack,
 				     K_THREAD_STACK_SIZEOF(partner_stack),
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <net/socket.h>
+
+#include "../../common/bench_time.h"
+
+/* This is a socket readiness microbenchmark:
+ *
+ * 1. NUM_SOCKETS UDP sockets are bound to consecutive ports on the
+ *    loopback interface
+ * 2. For each watched set size, ROUNDS datagrams are sent one at a time
+ *    to pseudo-randomly chosen sockets of the set
+ * 3. The datagram is waited for with poll() over the whole set, then
+ *    with epoll_wait() on an instance holding the same set, and read
+ *
+ * The average cost of one delivered datagram is reported for both.
+ */
+
+#define NUM_SOCKETS 256
+#define ROUNDS 200
+#define BASE_PORT 10000
+#define WAIT_MS 1000
+
+static const int set_sizes[] = { 16, 64, 256 };
+
+static int socks[NUM_SOCKETS];
+static struct pollfd pollfds[NUM_SOCKETS];
+static int sender;
+static uint32_t errors;
+
+static uint32_t rand_state = 12345;
+
+/* Deterministic LCG so both methods see the same sequence */
+static uint32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+	return rand_state >> 8;
+}
+
+static void fill_addr(struct sockaddr_in6 *addr, uint16_t port)
+{
+	memset(addr, 0, sizeof(*addr));
+	addr->sin6_family = AF_INET6;
+	addr->sin6_port = htons(port);
+	inet_pton(AF_INET6, CONFIG_NET_CONFIG_MY_IPV6_ADDR, &addr->sin6_addr);
+}
+
+static void send_to(int idx)
+{
+	struct sockaddr_in6 addr;
+	char byte = (char)idx;
+
+	fill_addr(&addr, BASE_PORT + idx);
+	if (sendto(sender, &byte, sizeof(byte), 0, (struct sockaddr *)&addr,
+		   sizeof(addr)) != sizeof(byte)) {
+		errors++;
+	}
+}
+
+static void drain(int sock)
+{
+	char byte;
+
+	if (recv(sock, &byte, sizeof(byte), MSG_DONTWAIT) != sizeof(byte)) {
+		errors++;
+	}
+}
+
+static uint32_t run_poll(int nsocks)
+{
+	uint64_t ns = 0U;
+
+	for (int i = 0; i < nsocks; i++) {
+		pollfds[i].fd = socks[i];
+		pollfds[i].events = POLLIN;
+	}
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t start;
+		int ready = -1;
+
+		send_to(next_rand() % nsocks);
+
+		start = bench_time_ns();
+		if (poll(pollfds, nsocks, WAIT_MS) == 1) {
+			for (int i = 0; i < nsocks; i++) {
+				if (pollfds[i].revents & POLLIN) {
+					ready = i;
+					break;
+				}
+			}
+		}
+		ns += bench_time_ns() - start;
+
+		if (ready < 0) {
+			errors++;
+			continue;
+		}
+
+		drain(socks[ready]);
+	}
+
+	return (uint32_t)(ns / ROUNDS);
+}
+
+static uint32_t run_epoll(int nsocks)
+{
+	struct epoll_event ev;
+	uint64_t ns = 0U;
+	int epfd;
+
+	epfd = epoll_create(nsocks);
+	if (epfd < 0) {
+		errors++;
+		return 0U;
+	}
+
+	for (int i = 0; i < nsocks; i++) {
+		ev.events = EPOLLIN;
+		ev.data.fd = socks[i];
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, socks[i], &ev) < 0) {
+			errors++;
+		}
+	}
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t start;
+		int ret;
+
+		send_to(next_rand() % nsocks);
+
+		start = bench_time_ns();
+		ret = epoll_wait(epfd, &ev, 1, WAIT_MS);
+		ns += bench_time_ns() - start;
+
+		if (ret != 1) {
+			errors++;
+			continue;
+		}
+
+		drain(ev.data.fd);
+	}
+
+	close(epfd);
+
+	return (uint32_t)(ns / ROUNDS);
+}
+
+void main(void)
+{
+	struct sockaddr_in6 addr;
+
+	printk("Socket readiness benchmark: %d sockets, %d rounds\n",
+	       NUM_SOCKETS, ROUNDS);
+
+	sender = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+	if (sender < 0) {
+		printk("cannot create sender: %d\n", errno);
+		return;
+	}
+
+	for (int i = 0; i < NUM_SOCKETS; i++) {
+		socks[i] = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+		if (socks[i] < 0) {
+			printk("cannot create socket %d: %d\n", i, errno);
+			return;
+		}
+
+		fill_addr(&addr, BASE_PORT + i);
+		if (bind(socks[i], (struct sockaddr *)&addr,
+			 sizeof(addr)) < 0) {
+			printk("cannot bind socket %d: %d\n", i, errno);
+			return;
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(set_sizes); i++) {
+		uint32_t poll_ns, epoll_ns;
+
+		/* Same sequence of destinations for both methods */
+		rand_state = 12345U + i;
+		poll_ns = run_poll(set_sizes[i]);
+		rand_state = 12345U + i;
+		epoll_ns = run_epoll(set_sizes[i]);
+
+		printk("sockets %d poll %u epoll %u ns/event\n",
+		       set_sizes[i], poll_ns, epoll_ns);
+	}
+
+	if (errors) {
+		printk("%u errors\n", errors);
+		return;
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <net/socket.h>
+
+#include "../../common/bench_time.h"
+
+/* This is a TCP multi-connection throughput benchmark:
+ *
+ * 1. MAX_CONNS server threads listen on consecutive ports of the loopback
+ *    interface, each accepts one connection and reads BYTES_PER_CONN
+ * 2. For every connection count, as many client threads connect to their
+ *    server and send BYTES_PER_CONN in CHUNK_SIZE writes at the same time
+ * 3. The time until all servers have received everything is reported
+ *    together with the aggregate throughput
+ */
+
+#define MAX_CONNS 16
+#define BYTES_PER_CONN (32 * 1024)
+#define CHUNK_SIZE 512
+#define BASE_PORT 4243
+#define STACK_SIZE 2048
+
+static const int conn_counts[] = { 1, 4, 16 };
+
+static int listeners[MAX_CONNS];
+static uint8_t tx_buf[CHUNK_SIZE];
+static uint8_t rx_bufs[MAX_CONNS][CHUNK_SIZE];
+static atomic_t errors;
+
+K_THREAD_STACK_ARRAY_DEFINE(server_stacks, MAX_CONNS, STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(client_stacks, MAX_CONNS, STACK_SIZE);
+static struct k_thread server_threads[MAX_CONNS];
+static struct k_thread client_threads[MAX_CONNS];
+
+static void fill_addr(struct sockaddr_in *addr, uint16_t port)
+{
+	memset(addr, 0, sizeof(*addr));
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &addr->sin_addr);
+}
+
+static void server(void *p1, void *p2, void *p3)
+{
+	int idx = POINTER_TO_INT(p1);
+	size_t total = 0;
+	ssize_t len;
+	int sock;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	sock = accept(listeners[idx], NULL, NULL);
+	if (sock < 0) {
+		atomic_inc(&errors);
+		return;
+	}
+
+	while (total < BYTES_PER_CONN) {
+		len = recv(sock, rx_bufs[idx], CHUNK_SIZE, 0);
+		if (len <= 0) {
+			atomic_inc(&errors);
+			break;
+		}
+
+		total += len;
+	}
+
+	close(sock);
+}
+
+static void client(void *p1, void *p2, void *p3)
+{
+	int idx = POINTER_TO_INT(p1);
+	struct sockaddr_in addr;
+	size_t sent = 0;
+	char byte;
+	int sock;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	fill_addr(&addr, BASE_PORT + idx);
+
+	if (sock < 0 || connect(sock, (struct sockaddr *)&addr,
+				sizeof(addr)) < 0) {
+		atomic_inc(&errors);
+		goto out;
+	}
+
+	while (sent < BYTES_PER_CONN) {
+		ssize_t len = send(sock, tx_buf, CHUNK_SIZE, 0);
+
+		if (len < 0) {
+			atomic_inc(&errors);
+			goto out;
+		}
+
+		sent += len;
+	}
+
+	/* Wait for the server to close so that no data is left queued */
+	(void)recv(sock, &byte, sizeof(byte), 0);
+
+out:
+	if (sock >= 0) {
+		close(sock);
+	}
+}
+
+static void run(int nconns)
+{
+	uint64_t start, us;
+	int i;
+
+	start = bench_time_us();
+
+	for (i = 0; i < nconns; i++) {
+		k_thread_create(&server_threads[i], server_stacks[i],
+				STACK_SIZE, server, INT_TO_POINTER(i), NULL,
+				NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+		k_thread_create(&client_threads[i], client_stacks[i],
+				STACK_SIZE, client, INT_TO_POINTER(i), NULL,
+				NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	for (i = 0; i < nconns; i++) {
+		k_thread_join(&server_threads[i], K_FOREVER);
+	}
+
+	us = MAX(bench_time_us() - start, 1U);
+
+	for (i = 0; i < nconns; i++) {
+		k_thread_join(&client_threads[i], K_FOREVER);
+	}
+
+	printk("conns %2d bytes %d time %u us throughput %u kB/s\n",
+	       nconns, nconns * BYTES_PER_CONN, (uint32_t)us,
+	       (uint32_t)((uint64_t)nconns * BYTES_PER_CONN * 1000U / us));
+}
+
+void main(void)
+{
+	struct sockaddr_in addr;
+
+	printk("TCP multi-connection benchmark: %d bytes per connection, "
+	       "%d hash buckets\n", BYTES_PER_CONN,
+	       CONFIG_NET_TCP_CONN_HASH_BUCKETS);
+
+	memset(tx_buf, 'a', sizeof(tx_buf));
+
+	for (int i = 0; i < MAX_CONNS; i++) {
+		listeners[i] = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		fill_addr(&addr, BASE_PORT + i);
+
+		if (listeners[i] < 0 ||
+		    bind(listeners[i], (struct sockaddr *)&addr,
+			 sizeof(addr)) < 0 ||
+		    listen(listeners[i], 1) < 0) {
+			printk("cannot set up listener %d: %d\n", i, errno);
+			return;
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(conn_counts); i++) {
+		run(conn_counts[i]);
+
+		/* Let the closed connections go away */
+		k_msleep(1000);
+	}
+
+	if (atomic_get(&errors)) {
+		printk("%d errors\n", (int)atomic_get(&errors));
+		return;
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <net/socket.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_mgmt.h>
+#include <net/net_stats.h>
+
+/* This is a TCP throughput under loss benchmark:
+ *
+ * 1. A server thread accepts connections on the loopback interface and
+ *    reads TOTAL_BYTES from each
+ * 2. For every loss rate, the main thread connects and sends TOTAL_BYTES
+ *    in CHUNK_SIZE writes while data segments are dropped with the given
+ *    probability
+ * 3. The time until the server has received everything is reported,
+ *    together with the dropped and retransmitted segments. A transfer
+ *    that does not complete ends the run without the final "fin"
+ */
+
+#define TOTAL_BYTES (128 * 1024)
+#define CHUNK_SIZE 1024
+#define SERVER_PORT 4242
+#define TIMEOUT_MS 60000
+#define STACK_SIZE 2048
+
+/* Larger than any segment without data, even with all TCP options */
+#define MIN_DATA_PKT_LEN 100
+
+static const int loss_rates[] = { 0, 2, 5, 10 };
+
+/* Hook of the TCP stack called with every outgoing segment */
+extern int (*tcp_send_cb)(struct net_pkt *pkt);
+
+static int loss_pct;
+static uint32_t dropped;
+static size_t received;
+static uint32_t rand_state = 12345;
+static uint8_t buf[CHUNK_SIZE];
+
+static K_SEM_DEFINE(server_ready, 0, 1);
+static K_SEM_DEFINE(server_done, 0, 1);
+K_THREAD_STACK_DEFINE(server_stack, STACK_SIZE);
+static struct k_thread server_thread;
+
+/* Deterministic LCG so every configuration sees the same losses */
+static uint32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+	return rand_state >> 8;
+}
+
+static int lossy_send(struct net_pkt *pkt)
+{
+	if (net_pkt_get_len(pkt) > MIN_DATA_PKT_LEN &&
+	    next_rand() % 100 < loss_pct) {
+		dropped++;
+		net_pkt_unref(pkt);
+		return 0;
+	}
+
+	if (net_send_data(pkt) < 0) {
+		net_pkt_unref(pkt);
+	}
+
+	return 0;
+}
+
+static void fill_addr(struct sockaddr_in *addr)
+{
+	memset(addr, 0, sizeof(*addr));
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(SERVER_PORT);
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &addr->sin_addr);
+}
+
+static void server(void *p1, void *p2, void *p3)
+{
+	static uint8_t rx[CHUNK_SIZE];
+	struct sockaddr_in addr;
+	int sock;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	fill_addr(&addr);
+
+	if (sock < 0 || bind(sock, (struct sockaddr *)&addr,
+			     sizeof(addr)) < 0 || listen(sock, 1) < 0) {
+		printk("cannot set up server: %d\n", errno);
+		return;
+	}
+
+	k_sem_give(&server_ready);
+
+	while (true) {
+		size_t total = 0;
+		ssize_t len;
+		int client;
+
+		client = accept(sock, NULL, NULL);
+		if (client < 0) {
+			continue;
+		}
+
+		while (total < TOTAL_BYTES) {
+			len = recv(client, rx, sizeof(rx), 0);
+			if (len <= 0) {
+				break;
+			}
+
+			total += len;
+		}
+
+		received = total;
+		k_sem_give(&server_done);
+		close(client);
+	}
+}
+
+static void get_stats(struct net_stats_tcp *stats)
+{
+	if (net_mgmt(NET_REQUEST_STATS_GET_TCP, NULL, stats,
+		     sizeof(*stats)) < 0) {
+		memset(stats, 0, sizeof(*stats));
+	}
+}
+
+static int run(int pct)
+{
+	struct net_stats_tcp before, after;
+	struct sockaddr_in addr;
+	uint32_t start, ms;
+	size_t sent = 0;
+	int sock;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	fill_addr(&addr);
+
+	if (sock < 0 || connect(sock, (struct sockaddr *)&addr,
+				sizeof(addr)) < 0) {
+		printk("cannot connect: %d\n", errno);
+		return -1;
+	}
+
+	get_stats(&before);
+	loss_pct = pct;
+	dropped = 0U;
+	received = 0;
+
+	start = k_uptime_get_32();
+
+	while (sent < TOTAL_BYTES) {
+		ssize_t len = send(sock, buf,
+				   MIN(sizeof(buf), TOTAL_BYTES - sent), 0);
+
+		if (len < 0) {
+			printk("loss %d%% send failed: %d\n", pct, errno);
+			close(sock);
+			return -1;
+		}
+
+		sent += len;
+	}
+
+	if (k_sem_take(&server_done, K_MSEC(TIMEOUT_MS)) < 0) {
+		printk("loss %d%% transfer timed out\n", pct);
+		loss_pct = 0;
+		close(sock);
+		return -1;
+	}
+
+	ms = MAX(k_uptime_get_32() - start, 1U);
+	loss_pct = 0;
+
+	if (received != TOTAL_BYTES) {
+		printk("loss %d%% server got %zu of %d bytes\n", pct,
+		       received, TOTAL_BYTES);
+		close(sock);
+		return -1;
+	}
+
+	get_stats(&after);
+
+	printk("loss %2d%% bytes %d time %u ms dropped %u rexmit %u "
+	       "throughput %u kB/s\n", pct, TOTAL_BYTES, ms, dropped,
+	       after.rexmit - before.rexmit, TOTAL_BYTES / ms);
+
+	close(sock);
+
+	return 0;
+}
+
+void main(void)
+{
+	printk("TCP loss benchmark: %d bytes, congestion control %s, "
+	       "SACK %s\n", TOTAL_BYTES,
+	       IS_ENABLED(CONFIG_NET_TCP_CC_CUBIC) ? "cubic" : "newreno",
+	       IS_ENABLED(CONFIG_NET_TCP_SACK) ? "on" : "off");
+
+	memset(buf, 'a', sizeof(buf));
+	tcp_send_cb = lossy_send;
+
+	k_thread_create(&server_thread, server_stack, STACK_SIZE, server,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	k_sem_take(&server_ready, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(loss_rates); i++) {
+		if (run(loss_rates[i]) < 0) {
+			return;
+		}
+
+		/* Let the closed connections go away */
+		k_msleep(500);
+	}
+
+	printk("fin\n");
+}
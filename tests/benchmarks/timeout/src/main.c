@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timeout_q.h>
+
+/* This is a timeout queue microbenchmark, designed to measure the
+ * scaling of the kernel timeout backend with many concurrently
+ * pending timeouts, independent of the k_timer or k_sleep APIs:
+ *
+ * 1. N_TIMEOUTS timeouts are added with pseudo-random durations
+ *    between BASE_TICKS and BASE_TICKS + MAX_TICKS
+ * 2. Every other timeout is aborted
+ * 3. The others are left to expire, each callback checking that it
+ *    did not run before its expiry tick
+ *
+ * Switch CONFIG_TIMEOUT_DLIST / CONFIG_TIMEOUT_WHEEL to compare the
+ * backends.
+ */
+
+#define N_TIMEOUTS 10000
+#define BASE_TICKS 2000
+#define MAX_TICKS 8000
+
+struct bench_timeout {
+	struct _timeout to;
+	int64_t expiry;
+};
+
+static struct bench_timeout timeouts[N_TIMEOUTS];
+
+static volatile uint32_t fired;
+static volatile uint32_t early;
+static volatile int64_t max_late;
+
+static uint32_t rand_state = 12345;
+
+/* Deterministic LCG so every backend sees the same sequence */
+static uint32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+	return rand_state >> 8;
+}
+
+static void timeout_fn(struct _timeout *t)
+{
+	struct bench_timeout *bt = CONTAINER_OF(t, struct bench_timeout, to);
+	int64_t late = sys_clock_tick_get() - bt->expiry;
+
+	if (late < 0) {
+		early++;
+	} else if (late > max_late) {
+		max_late = late;
+	}
+	fired++;
+}
+
+void main(void)
+{
+	uint32_t added = 0U, aborted = 0U;
+	uint64_t add_cycles = 0U, abort_cycles = 0U;
+
+	printk("Timeout queue backend: %s, %d timeouts\n",
+	       IS_ENABLED(CONFIG_TIMEOUT_WHEEL) ? "wheel" : "dlist",
+	       N_TIMEOUTS);
+
+	for (int i = 0; i < N_TIMEOUTS; i++) {
+		k_ticks_t ticks = BASE_TICKS + (next_rand() % MAX_TICKS);
+		uint32_t start;
+
+		z_init_timeout(&timeouts[i].to);
+		timeouts[i].expiry = sys_clock_tick_get() + ticks;
+
+		start = k_cycle_get_32();
+		z_add_timeout(&timeouts[i].to, timeout_fn, K_TICKS(ticks));
+		add_cycles += k_cycle_get_32() - start;
+		added++;
+	}
+
+	for (int i = 0; i < N_TIMEOUTS; i += 2) {
+		uint32_t start = k_cycle_get_32();
+		int ret = z_abort_timeout(&timeouts[i].to);
+
+		abort_cycles += k_cycle_get_32() - start;
+		if (ret == 0) {
+			aborted++;
+		}
+	}
+
+	printk("add %u avg %u abort %u avg %u\n",
+	       added, (uint32_t)(add_cycles / added),
+	       aborted, aborted ? (uint32_t)(abort_cycles / aborted) : 0U);
+
+	k_sleep(K_TICKS(BASE_TICKS + MAX_TICKS + 1));
+
+	printk("fired %u early %u max late %u\n",
+	       fired, early, (uint32_t)max_late);
+
+	if (fired + aborted != added) {
+		printk("lost %u timeouts\n", added - fired - aborted);
+	}
+	printk("fin\n");
+}
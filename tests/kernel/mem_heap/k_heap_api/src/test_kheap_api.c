@@ -190,3 +190,79 @@ void test_k_heap_alloc_pending(void)
 
 	k_thread_join(tid, K_FOREVER);
 }
+
+K_HEAP_DEFINE(cache_heap, HEAP_SIZE);
+#ifdef CONFIG_K_HEAP_CACHE
+static struct k_heap reinit_heap;
+static char reinit_mem[HEAP_SIZE] __aligned(8);
+#endif
+
+/**
+ * @brief Validate the per-CPU size-class cache of k_heap
+ *
+ * @details Free a small block and check that an allocation of the
+ * same size class gets it back from the cache, that blocks larger
+ * than the largest class bypass it, and that k_heap_cache_flush()
+ * returns the cached memory to the heap.
+ *
+ * @ingroup kernel_heap_tests
+ *
+ * @see k_heap_cache_flush(), k_heap_cache_stats_get()
+ */
+void test_k_heap_cache(void)
+{
+#ifdef CONFIG_K_HEAP_CACHE
+	struct k_heap_cache_stats before, after;
+	char *p, *q;
+
+	/* Stay on one CPU, the cache is per-CPU */
+	k_sched_lock();
+
+	p = k_heap_alloc(&cache_heap, 24, K_NO_WAIT);
+	zassert_not_null(p, "k_heap_alloc operation failed");
+	k_heap_free(&cache_heap, p);
+
+	k_heap_cache_stats_get(&cache_heap, &before);
+	zassert_true(before.cached_bytes > 0, "free was not cached");
+
+	q = k_heap_alloc(&cache_heap, 20, K_NO_WAIT);
+	zassert_equal(p, q, "same class allocation not served from cache");
+	k_heap_cache_stats_get(&cache_heap, &after);
+	zassert_equal(after.alloc_hits, before.alloc_hits + 1, NULL);
+	k_heap_free(&cache_heap, q);
+
+	/* Larger than any class goes straight to the heap */
+	k_heap_cache_stats_get(&cache_heap, &before);
+	p = k_heap_alloc(&cache_heap, ALLOC_SIZE_1 / 2, K_NO_WAIT);
+	zassert_not_null(p, "k_heap_alloc operation failed");
+	k_heap_free(&cache_heap, p);
+	k_heap_cache_stats_get(&cache_heap, &after);
+	zassert_equal(after.free_hits, before.free_hits, NULL);
+
+	k_heap_cache_flush(&cache_heap);
+	k_heap_cache_stats_get(&cache_heap, &after);
+	zassert_equal(after.cached_bytes, 0, "flush left blocks cached");
+
+	/* All memory is back, so a large block must fit again */
+	p = k_heap_alloc(&cache_heap, ALLOC_SIZE_2, K_NO_WAIT);
+	zassert_not_null(p, "k_heap_alloc operation failed");
+	k_heap_free(&cache_heap, p);
+
+	/* Re-initializing the heap forgets its cached blocks */
+	k_heap_init(&reinit_heap, reinit_mem, sizeof(reinit_mem));
+	p = k_heap_alloc(&reinit_heap, 24, K_NO_WAIT);
+	zassert_not_null(p, "k_heap_alloc operation failed");
+	k_heap_free(&reinit_heap, p);
+	k_heap_cache_stats_get(&reinit_heap, &before);
+	zassert_true(before.cached_bytes > 0, "free was not cached");
+
+	k_heap_init(&reinit_heap, reinit_mem, sizeof(reinit_mem));
+	k_heap_cache_stats_get(&reinit_heap, &after);
+	zassert_equal(after.cached_bytes, 0, "blocks cached across init");
+	zassert_equal(after.alloc_hits, 0, "statistics kept across init");
+
+	k_sched_unlock();
+#else
+	ztest_test_skip();
+#endif
+}
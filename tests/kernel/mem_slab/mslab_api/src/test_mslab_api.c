@@ -233,3 +233,48 @@ void test_mslab_used_get(void)
 	tmslab_used_get(&mslab);
 	tmslab_used_get(&kmslab);
 }
+
+/**
+ * @brief Verify the high watermark and allocation failure counters
+ *
+ * @details Allocate all blocks of a freshly initialized slab, fail one
+ * allocation without waiting and one with a timeout, then free
+ * everything.  The maximum number of used blocks must stay at the
+ * peak and both failures must be counted.
+ *
+ * @ingroup kernel_memory_slab_tests
+ *
+ * @see k_mem_slab_max_used_get(), k_mem_slab_num_failed_get()
+ */
+void test_mslab_stats(void)
+{
+	void *block[BLK_NUM], *block_fail;
+
+	if (!IS_ENABLED(CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION)) {
+		ztest_test_skip();
+		return;
+	}
+
+	k_mem_slab_init(&mslab, tslab, BLK_SIZE, BLK_NUM);
+	zassert_equal(k_mem_slab_max_used_get(&mslab), 0, NULL);
+	zassert_equal(k_mem_slab_num_failed_get(&mslab), 0, NULL);
+
+	for (int i = 0; i < BLK_NUM; i++) {
+		zassert_equal(k_mem_slab_alloc(&mslab, &block[i], K_NO_WAIT),
+			      0, NULL);
+		zassert_equal(k_mem_slab_max_used_get(&mslab), i + 1, NULL);
+	}
+
+	zassert_equal(k_mem_slab_alloc(&mslab, &block_fail, K_NO_WAIT),
+		      -ENOMEM, NULL);
+	zassert_equal(k_mem_slab_num_failed_get(&mslab), 1, NULL);
+	zassert_not_equal(k_mem_slab_alloc(&mslab, &block_fail, K_MSEC(10)),
+			  0, NULL);
+	zassert_equal(k_mem_slab_num_failed_get(&mslab), 2, NULL);
+
+	for (int i = 0; i < BLK_NUM; i++) {
+		k_mem_slab_free(&mslab, &block[i]);
+	}
+	zassert_equal(k_mem_slab_num_used_get(&mslab), 0, NULL);
+	zassert_equal(k_mem_slab_max_used_get(&mslab), BLK_NUM, NULL);
+}
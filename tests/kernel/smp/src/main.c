@@ -948,6 +948,111 @@ void test_inc_concurrency(void)
 			"total count %d is wrong(M)", global_cnt);
 }
 
+#define SCHED_THREADS_NUM (2 * CONFIG_MP_NUM_CPUS)
+#define SCHED_WINDOW_MS 500
+#define WAKEUP_RUNS 100
+
+static struct k_thread sched_thread[SCHED_THREADS_NUM];
+static K_THREAD_STACK_ARRAY_DEFINE(sched_stack, SCHED_THREADS_NUM, STACK_SIZE);
+static volatile uint32_t sched_yields[SCHED_THREADS_NUM];
+static volatile bool sched_stop;
+
+static void sched_yield_entry(void *p1, void *p2, void *p3)
+{
+	int idx = POINTER_TO_INT(p1);
+
+	while (!sched_stop) {
+		sched_yields[idx]++;
+		k_yield();
+	}
+}
+
+/**
+ * @brief Measure scheduler throughput across CPUs
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details Spawn twice as many equal priority preemptible threads
+ * as there are CPUs, each yielding in a loop for a fixed time window,
+ * and report the total number of context switches per second.  Run
+ * with and without CONFIG_SCHED_CPU_RUNQ to compare the per-CPU run
+ * queues with the global one.
+ */
+void test_sched_throughput(void)
+{
+	uint64_t total = 0U;
+
+	sched_stop = false;
+	for (int i = 0; i < SCHED_THREADS_NUM; i++) {
+		sched_yields[i] = 0U;
+		k_thread_create(&sched_thread[i], sched_stack[i], STACK_SIZE,
+				sched_yield_entry, INT_TO_POINTER(i), NULL, NULL,
+				K_PRIO_PREEMPT(2), 0, K_NO_WAIT);
+	}
+
+	k_sleep(K_MSEC(SCHED_WINDOW_MS));
+	sched_stop = true;
+
+	for (int i = 0; i < SCHED_THREADS_NUM; i++) {
+		k_thread_join(&sched_thread[i], K_FOREVER);
+		zassert_true(sched_yields[i] > 0, "thread %d never ran", i);
+		total += sched_yields[i];
+	}
+
+	printk("%s run queue: %llu yields/s over %d threads\n",
+	       IS_ENABLED(CONFIG_SCHED_CPU_RUNQ) ? "per-CPU" : "global",
+	       total * 1000U / SCHED_WINDOW_MS, SCHED_THREADS_NUM);
+}
+
+static K_SEM_DEFINE(wakeup_sem, 0, 1);
+static K_SEM_DEFINE(wakeup_done_sem, 0, 1);
+static volatile uint32_t wakeup_stamp;
+static volatile uint32_t wakeup_cycles;
+
+static void wakeup_latency_entry(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < WAKEUP_RUNS; i++) {
+		k_sem_take(&wakeup_sem, K_FOREVER);
+		wakeup_cycles += k_cycle_get_32() - wakeup_stamp;
+		k_sem_give(&wakeup_done_sem);
+	}
+}
+
+/**
+ * @brief Measure cross-CPU wakeup latency
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details A thread pends on a semaphore while the main thread keeps
+ * its CPU busy, then the main thread gives the semaphore and the
+ * waiter records the cycles elapsed until it runs.  The average is
+ * reported so the per-CPU and global run queues can be compared.
+ */
+void test_sched_wakeup_latency(void)
+{
+	k_tid_t tid;
+
+	wakeup_cycles = 0U;
+	tid = k_thread_create(&t2, t2_stack, T2_STACK_SIZE,
+			      wakeup_latency_entry, NULL, NULL, NULL,
+			      K_PRIO_COOP(2), 0, K_NO_WAIT);
+
+	for (int i = 0; i < WAKEUP_RUNS; i++) {
+		/* Let the waiter pend before stamping */
+		k_busy_wait(100);
+		wakeup_stamp = k_cycle_get_32();
+		k_sem_give(&wakeup_sem);
+		zassert_equal(k_sem_take(&wakeup_done_sem, K_MSEC(TIMEOUT)), 0,
+			      "waiter did not wake up");
+	}
+
+	k_thread_join(tid, K_FOREVER);
+
+	printk("%s run queue: average wakeup latency %u cycles\n",
+	       IS_ENABLED(CONFIG_SCHED_CPU_RUNQ) ? "per-CPU" : "global",
+	       wakeup_cycles / WAKEUP_RUNS);
+}
+
 void test_main(void)
 {
 	/* Sleep a bit to guarantee that both CPUs enter an idle
@@ -969,7 +1074,9 @@ void test_main(void)
 			 ztest_unit_test(test_fatal_on_smp),
 			 ztest_unit_test(test_workq_on_smp),
 			 ztest_unit_test(test_smp_release_global_lock),
-			 ztest_unit_test(test_inc_concurrency)
+			 ztest_unit_test(test_inc_concurrency),
+			 ztest_unit_test(test_sched_throughput),
+			 ztest_unit_test(test_sched_wakeup_latency)
 			 );
 	ztest_run_test_suite(smp);
 }
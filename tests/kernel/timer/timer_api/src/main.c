@@ -811,6 +811,71 @@ void test_sleep_abs(void)
 		     start + sleep_ticks, end, late);
 }
 
+#ifdef CONFIG_TIMEOUT_SLACK
+#define SLACK_TIMERS 4
+#define SLACK_TICKS 10
+
+static struct k_timer slack_timer[SLACK_TIMERS];
+static int64_t slack_fired[SLACK_TIMERS];
+
+static void slack_expire(struct k_timer *timer)
+{
+	slack_fired[timer - slack_timer] = k_uptime_ticks();
+}
+#endif
+
+/**
+ * @brief Test timer expiry coalescing with slack
+ *
+ * @details Start several timers a tick apart, each allowing
+ * SLACK_TICKS of slack.  Check that none expires early or later than
+ * its slack allows, and that the kernel handled several expiry ticks
+ * in one announce.
+ *
+ * @ingroup kernel_timer_tests
+ *
+ * @see k_timer_slack_set(), sys_clock_slack_stats_get()
+ */
+void test_timer_slack(void)
+{
+#ifdef CONFIG_TIMEOUT_SLACK
+	struct sys_clock_slack_stats before, after;
+	int64_t start;
+
+	sys_clock_slack_stats_get(&before);
+
+	k_usleep(1); /* tick align */
+	start = k_uptime_ticks();
+
+	for (int i = 0; i < SLACK_TIMERS; i++) {
+		slack_fired[i] = 0;
+		k_timer_init(&slack_timer[i], slack_expire, NULL);
+		k_timer_slack_set(&slack_timer[i], K_TICKS(SLACK_TICKS));
+		k_timer_start(&slack_timer[i], K_TICKS(SLACK_TICKS + i),
+			      K_NO_WAIT);
+	}
+
+	k_sleep(K_TICKS(3 * SLACK_TICKS + SLACK_TIMERS));
+
+	for (int i = 0; i < SLACK_TIMERS; i++) {
+		int64_t expiry = start + SLACK_TICKS + i;
+
+		zassert_true(slack_fired[i] >= expiry,
+			     "timer %d early: %lld < %lld", i,
+			     slack_fired[i], expiry);
+		zassert_true(slack_fired[i] <= expiry + SLACK_TICKS + 1,
+			     "timer %d beyond slack: %lld > %lld", i,
+			     slack_fired[i], expiry + SLACK_TICKS + 1);
+	}
+
+	sys_clock_slack_stats_get(&after);
+	zassert_true(after.coalesced > before.coalesced,
+		     "no expiry was coalesced");
+#else
+	ztest_test_skip();
+#endif
+}
+
 static void timer_init(struct k_timer *timer, k_timer_expiry_t expiry_fn,
 		       k_timer_stop_t stop_fn)
 {
@@ -853,6 +918,7 @@ void test_main(void)
 			 ztest_user_unit_test(test_timer_user_data),
 			 ztest_user_unit_test(test_timer_remaining),
 			 ztest_user_unit_test(test_timeout_abs),
-			 ztest_user_unit_test(test_sleep_abs));
+			 ztest_user_unit_test(test_sleep_abs),
+			 ztest_unit_test(test_timer_slack));
 	ztest_run_test_suite(timer_api);
 }
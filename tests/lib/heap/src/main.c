@@ -204,6 +204,120 @@ static void test_big_heap(void)
 	log_result(BIG_HEAP_SZ, &result);
 }
 
+/* Long-running randomized workload modeled on a device heap after
+ * days of uptime: mostly small short-lived blocks, with occasional
+ * large ones that tend to stay allocated.  The runtime stats are
+ * checked against what the test itself tracks, and the resulting
+ * fragmentation is logged so the allocation policies can be compared.
+ */
+#define LONG_RUN_HEAP_SZ MIN(BIG_HEAP_SZ, 16 * 1024)
+#define LONG_RUN_OPS (64 * SMALL_HEAP_SZ)
+#define LONG_RUN_BLOCKS 256
+
+static struct {
+	void *p;
+	size_t sz;
+} long_run_blocks[LONG_RUN_BLOCKS];
+
+static uint32_t long_run_rand(void)
+{
+	static uint32_t state = 0x2545f491;
+
+	state = state * 1103515245U + 12345U;
+	return state >> 8;
+}
+
+static void check_stats(struct sys_heap *heap, size_t requested)
+{
+	struct sys_heap_runtime_stats stats;
+
+	zassert_equal(sys_heap_runtime_stats_get(heap, &stats), 0, NULL);
+	zassert_true(stats.allocated_bytes >= requested,
+		     "allocated %zu < requested %zu",
+		     stats.allocated_bytes, requested);
+	zassert_true(stats.free_bytes + stats.allocated_bytes <=
+		     LONG_RUN_HEAP_SZ, "stats exceed heap size");
+	zassert_true(stats.largest_free_bytes <= stats.free_bytes, NULL);
+	zassert_true(stats.fragmentation_pct <= 100, NULL);
+	zassert_true((stats.free_chunks == 0) == (stats.free_bytes == 0),
+		     NULL);
+}
+
+static void test_fragmentation_long_run(void)
+{
+	struct sys_heap heap;
+	struct sys_heap_runtime_stats initial, stats;
+	uint32_t fails = 0, max_frag = 0;
+	size_t requested = 0;
+	int n = 0;
+
+	TC_PRINT("Long run on %d byte heap, %d ops\n",
+		 (int) LONG_RUN_HEAP_SZ, (int) LONG_RUN_OPS);
+
+	sys_heap_init(&heap, heapmem, LONG_RUN_HEAP_SZ);
+	zassert_equal(sys_heap_runtime_stats_get(&heap, &initial), 0, NULL);
+	zassert_equal(initial.fragmentation_pct, 0, NULL);
+	zassert_equal(initial.free_chunks, 1, NULL);
+	zassert_equal(initial.largest_free_bytes, initial.free_bytes, NULL);
+
+	for (int i = 0; i < LONG_RUN_OPS; i++) {
+		uint32_t r = long_run_rand();
+		bool large = (r % 16) == 0;
+
+		/* Free small blocks eagerly, large ones rarely */
+		if (n == LONG_RUN_BLOCKS || (n > 0 && (r & 0x100))) {
+			int b = long_run_rand() % n;
+
+			if (long_run_blocks[b].sz < 256 || (r & 0x3000) == 0) {
+				check_fill(long_run_blocks[b].p);
+				sys_heap_free(&heap, long_run_blocks[b].p);
+				requested -= long_run_blocks[b].sz;
+				long_run_blocks[b] = long_run_blocks[--n];
+			}
+		} else {
+			size_t sz = large ? 256 + long_run_rand() % 768
+					  : 8 + long_run_rand() % 120;
+			void *p = sys_heap_alloc(&heap, sz);
+
+			if (p == NULL) {
+				fails++;
+			} else {
+				fill_block(p, sz);
+				long_run_blocks[n].p = p;
+				long_run_blocks[n].sz = sz;
+				requested += sz;
+				n++;
+			}
+		}
+
+		if ((i % 1024) == 0) {
+			zassert_true(sys_heap_validate(&heap), "");
+			check_stats(&heap, requested);
+			sys_heap_runtime_stats_get(&heap, &stats);
+			max_frag = MAX(max_frag, stats.fragmentation_pct);
+		}
+	}
+
+	sys_heap_runtime_stats_get(&heap, &stats);
+	TC_PRINT("failed allocs: %u, final: %zu free in %u chunks, "
+		 "largest %zu, fragmentation %u%% (max %u%%)\n",
+		 fails, stats.free_bytes, stats.free_chunks,
+		 stats.largest_free_bytes, stats.fragmentation_pct, max_frag);
+
+	/* Everything freed must coalesce back into one chunk */
+	while (n > 0) {
+		n--;
+		check_fill(long_run_blocks[n].p);
+		sys_heap_free(&heap, long_run_blocks[n].p);
+	}
+	zassert_true(sys_heap_validate(&heap), "");
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.free_bytes, initial.free_bytes, NULL);
+	zassert_equal(stats.allocated_bytes, 0, NULL);
+	zassert_equal(stats.free_chunks, 1, NULL);
+	zassert_equal(stats.fragmentation_pct, 0, NULL);
+}
+
 /* Simple clobber detection */
 void realloc_fill_block(uint8_t *p, size_t sz)
 {
@@ -329,7 +443,8 @@ void test_main(void)
 			 ztest_unit_test(test_realloc),
 			 ztest_unit_test(test_small_heap),
 			 ztest_unit_test(test_fragmentation),
-			 ztest_unit_test(test_big_heap)
+			 ztest_unit_test(test_big_heap),
+			 ztest_unit_test(test_fragmentation_long_run)
 			 );
 
 	ztest_run_test_suite(lib_heap_test);
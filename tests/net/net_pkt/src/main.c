@@ -4,6 +4,9 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_PKT_LOG_LEVEL);
+
 #include <zephyr/types.h>
 #include <stddef.h>
 #include <string.h>
@@ -11,15 +14,23 @@
 #include <net/net_pkt.h>
 #include <net/net_if.h>
 #include <net/net_ip.h>
+#include <net/net_context.h>
 #include <net/ethernet.h>
 #include <random/rand32.h>
 
 #include <ztest.h>
 
+#include "net_private.h"
+
 static uint8_t mac_addr[sizeof(struct net_eth_addr)];
 static struct net_if *eth_if;
 static uint8_t small_buffer[512];
 
+/* While set, the fake device keeps the packets it is given */
+static bool hold_tx;
+static struct net_pkt *held_pkts[CONFIG_NET_PKT_TX_COUNT];
+static int held_count;
+
 /************************\
  * FAKE ETHERNET DEVICE *
 \************************/
@@ -43,6 +54,10 @@ static void fake_dev_iface_init(struct net_if *iface)
 
 static int fake_dev_send(const struct device *dev, struct net_pkt *pkt)
 {
+	if (hold_tx && held_count < ARRAY_SIZE(held_pkts)) {
+		held_pkts[held_count++] = net_pkt_ref(pkt);
+	}
+
 	return 0;
 }
 
@@ -974,6 +989,235 @@ static void test_net_pkt_get_contiguous_len(void)
 	net_pkt_unref(pkt);
 }
 
+static void test_net_pkt_size_classes(void)
+{
+#if defined(CONFIG_NET_BUF_SIZE_CLASSES)
+	struct net_buf_pool *rx_small;
+	struct net_pkt *pkt;
+
+	net_pkt_get_small_info(&rx_small, NULL);
+
+	/* A short packet fits in one small fragment */
+	pkt = net_pkt_rx_alloc_with_buffer(NULL,
+					   CONFIG_NET_BUF_SMALL_DATA_SIZE,
+					   AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "Pkt not allocated");
+
+	zassert_equal(net_buf_pool_get(pkt->buffer->pool_id), rx_small,
+		      "Small fragment not used");
+	zassert_is_null(pkt->buffer->frags, "Too many fragments");
+
+	net_pkt_unref(pkt);
+
+	/* Only the tail of a bigger packet comes from the small pool */
+	pkt = net_pkt_rx_alloc_with_buffer(NULL, CONFIG_NET_BUF_DATA_SIZE + 1,
+					   AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "Pkt not allocated");
+
+	zassert_not_equal(net_buf_pool_get(pkt->buffer->pool_id), rx_small,
+			  "Small fragment used for the head");
+	zassert_not_null(pkt->buffer->frags, "Tail fragment missing");
+	zassert_equal(net_buf_pool_get(pkt->buffer->frags->pool_id), rx_small,
+		      "Small fragment not used for the tail");
+	zassert_true(pkt_is_of_size(pkt, CONFIG_NET_BUF_DATA_SIZE + 1),
+		     "Pkt size is not right");
+
+	net_pkt_unref(pkt);
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_net_pkt_quota(void)
+{
+#if defined(CONFIG_NET_PKT_QUOTA)
+	int quota = MAX(CONFIG_NET_PKT_RX_COUNT *
+			CONFIG_NET_PKT_RX_IFACE_QUOTA / 100, 1);
+	struct net_pkt *pkts[CONFIG_NET_PKT_RX_COUNT];
+	struct net_pkt *pkt;
+	int i;
+
+	for (i = 0; i < quota; i++) {
+		pkts[i] = net_pkt_rx_alloc_on_iface(eth_if, K_NO_WAIT);
+		zassert_not_null(pkts[i], "Pkt %d not allocated", i);
+	}
+
+	/* The interface has used its share of the RX packets */
+	pkt = net_pkt_rx_alloc_on_iface(eth_if, K_NO_WAIT);
+	zassert_is_null(pkt, "Pkt allocated over the quota");
+
+	/* The rest is still there for the others */
+	if (quota < CONFIG_NET_PKT_RX_COUNT) {
+		pkt = net_pkt_rx_alloc(K_NO_WAIT);
+		zassert_not_null(pkt, "Pkt not allocated");
+		net_pkt_unref(pkt);
+	}
+
+	/* Releasing a packet gives its share back */
+	net_pkt_unref(pkts[0]);
+
+	pkts[0] = net_pkt_rx_alloc_on_iface(eth_if, K_NO_WAIT);
+	zassert_not_null(pkts[0], "Pkt not allocated after release");
+
+	for (i = 0; i < quota; i++) {
+		net_pkt_unref(pkts[i]);
+	}
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_net_pkt_context_rx_quota(void)
+{
+#if defined(CONFIG_NET_PKT_QUOTA)
+	int quota = NET_PKT_QUOTA(CONFIG_NET_PKT_RX_COUNT,
+				  CONFIG_NET_PKT_RX_CONTEXT_QUOTA);
+	struct net_pkt *pkts[CONFIG_NET_PKT_RX_COUNT];
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	int ret;
+	int i;
+
+	if (quota >= CONFIG_NET_PKT_RX_COUNT) {
+		ztest_test_skip();
+	}
+
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &ctx);
+	zassert_equal(ret, 0, "Cannot get context (%d)", ret);
+
+	for (i = 0; i < quota; i++) {
+		pkts[i] = net_pkt_rx_alloc_on_iface(eth_if, K_NO_WAIT);
+		zassert_not_null(pkts[i], "Pkt %d not allocated", i);
+
+		ret = net_pkt_quota_move(pkts[i], &ctx->rx_quota);
+		zassert_equal(ret, 0, "Pkt %d not queued to the context", i);
+	}
+
+	/* Moving a packet to the quota it is charged to is a no-op */
+	ret = net_pkt_quota_move(pkts[0], &ctx->rx_quota);
+	zassert_equal(ret, 0, "Pkt not kept on the context");
+
+	/* The context has used its share, the packet stays charged to
+	 * the interface
+	 */
+	pkt = net_pkt_rx_alloc_on_iface(eth_if, K_NO_WAIT);
+	zassert_not_null(pkt, "Interface quota not released by the move");
+
+	ret = net_pkt_quota_move(pkt, &ctx->rx_quota);
+	zassert_true(ret < 0, "Pkt queued over the context quota");
+	zassert_equal_ptr(pkt->quota, &eth_if->rx_quota,
+			  "Pkt lost its interface charge");
+
+	/* Reading a queued packet gives its share back */
+	net_pkt_unref(pkts[0]);
+
+	ret = net_pkt_quota_move(pkt, &ctx->rx_quota);
+	zassert_equal(ret, 0, "Pkt not queued after release");
+	pkts[0] = pkt;
+
+	for (i = 0; i < quota; i++) {
+		net_pkt_unref(pkts[i]);
+	}
+
+	net_context_put(ctx);
+#else
+	ztest_test_skip();
+#endif
+}
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+static void release_held_pkt(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (held_count > 0) {
+		net_pkt_unref(held_pkts[--held_count]);
+	}
+}
+
+static K_WORK_DELAYABLE_DEFINE(release_work, release_held_pkt);
+#endif
+
+static void test_net_pkt_context_tx_quota(void)
+{
+#if defined(CONFIG_NET_PKT_QUOTA)
+	int quota = NET_PKT_QUOTA(CONFIG_NET_PKT_TX_COUNT,
+				  CONFIG_NET_PKT_TX_CONTEXT_QUOTA);
+	struct sockaddr_in dst = {
+		.sin_family = AF_INET,
+		.sin_port = htons(4242),
+		.sin_addr = { { { 224, 0, 0, 1 } } },
+	};
+	struct sockaddr_in src = {
+		.sin_family = AF_INET,
+		.sin_port = htons(4242),
+		.sin_addr = { { { 192, 0, 2, 1 } } },
+	};
+	struct net_context *ctx;
+	uint8_t data[8] = { 0 };
+	int64_t start;
+	int ret;
+	int i;
+
+	zassert_not_null(net_if_ipv4_addr_add(eth_if, &src.sin_addr,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add address");
+
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &ctx);
+	zassert_equal(ret, 0, "Cannot get context (%d)", ret);
+
+	/* Bound and connected, the context stays on the fake interface */
+	ret = net_context_bind(ctx, (struct sockaddr *)&src, sizeof(src));
+	zassert_equal(ret, 0, "Cannot bind context (%d)", ret);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&dst, sizeof(dst),
+				  NULL, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Cannot connect context (%d)", ret);
+
+	hold_tx = true;
+
+	for (i = 0; i < quota; i++) {
+		ret = net_context_send(ctx, data, sizeof(data), NULL,
+				       K_NO_WAIT, NULL);
+		zassert_equal(ret, sizeof(data), "Send %d failed (%d)", i, ret);
+	}
+
+	/* Wait for the TX path to hand everything over to the device */
+	k_msleep(10);
+	zassert_equal(held_count, quota, "Device got %d pkts", held_count);
+
+	/* Over the quota, the sender waits for one of its own packets to
+	 * be released...
+	 */
+	k_work_schedule(&release_work, K_MSEC(100));
+
+	start = k_uptime_get();
+	ret = net_context_send(ctx, data, sizeof(data), NULL, K_NO_WAIT,
+			       NULL);
+	zassert_equal(ret, sizeof(data), "Send after release failed (%d)",
+		      ret);
+	zassert_true(k_uptime_get() - start >= 100, "Send did not wait");
+
+	k_msleep(10);
+
+	/* ...and gives up when none is */
+	ret = net_context_send(ctx, data, sizeof(data), NULL, K_NO_WAIT,
+			       NULL);
+	zassert_true(ret < 0, "Send over the quota succeeded");
+
+	hold_tx = false;
+
+	while (held_count > 0) {
+		net_pkt_unref(held_pkts[--held_count]);
+	}
+
+	net_context_put(ctx);
+	net_if_ipv4_addr_rm(eth_if, &src.sin_addr);
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	eth_if = net_if_get_default();
@@ -989,7 +1233,11 @@ void test_main(void)
 			 ztest_unit_test(test_net_pkt_clone),
 			 ztest_unit_test(test_net_pkt_headroom),
 			 ztest_unit_test(test_net_pkt_headroom_copy),
-			 ztest_unit_test(test_net_pkt_get_contiguous_len)
+			 ztest_unit_test(test_net_pkt_get_contiguous_len),
+			 ztest_unit_test(test_net_pkt_size_classes),
+			 ztest_unit_test(test_net_pkt_quota),
+			 ztest_unit_test(test_net_pkt_context_rx_quota),
+			 ztest_unit_test(test_net_pkt_context_tx_quota)
 		);
 
 	ztest_run_test_suite(net_pkt_tests);
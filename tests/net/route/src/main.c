@@ -34,6 +34,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include "ipv6.h"
 #include "nbr.h"
 #include "route.h"
+#include "udp_internal.h"
 
 #if defined(CONFIG_NET_ROUTE_LOG_LEVEL_DBG)
 #define DBG(fmt, ...) printk(fmt, ##__VA_ARGS__)
@@ -84,6 +85,11 @@ static bool feed_data; /* feed data back to IP stack */
 
 static int msg_sending;
 
+/* What tester_send() last saw */
+static struct net_if *sent_iface;
+static uint8_t sent_lladdr_src[sizeof(struct net_eth_addr)];
+static uint8_t sent_lladdr_dst[sizeof(struct net_eth_addr)];
+
 K_SEM_DEFINE(wait_data, 0, UINT_MAX);
 
 #define WAIT_TIME K_MSEC(250)
@@ -126,6 +132,25 @@ static void net_route_iface_init(struct net_if *iface)
 			     NET_LINK_ETHERNET);
 }
 
+static void record_sent(struct net_pkt *pkt)
+{
+	sent_iface = net_pkt_iface(pkt);
+
+	(void)memset(sent_lladdr_src, 0, sizeof(sent_lladdr_src));
+	if (net_pkt_lladdr_src(pkt)->addr) {
+		memcpy(sent_lladdr_src, net_pkt_lladdr_src(pkt)->addr,
+		       MIN(net_pkt_lladdr_src(pkt)->len,
+			   sizeof(sent_lladdr_src)));
+	}
+
+	(void)memset(sent_lladdr_dst, 0, sizeof(sent_lladdr_dst));
+	if (net_pkt_lladdr_dst(pkt)->addr) {
+		memcpy(sent_lladdr_dst, net_pkt_lladdr_dst(pkt)->addr,
+		       MIN(net_pkt_lladdr_dst(pkt)->len,
+			   sizeof(sent_lladdr_dst)));
+	}
+}
+
 static int tester_send(const struct device *dev, struct net_pkt *pkt)
 {
 	if (!pkt->frags) {
@@ -133,6 +158,8 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 		return -ENODATA;
 	}
 
+	record_sent(pkt);
+
 	/* By default we assume that the test is ok */
 	data_failure = false;
 
@@ -473,6 +500,145 @@ static void test_route_del_many(void)
 	}
 }
 
+static void test_route_lookup_longest(void)
+{
+	struct net_route_entry *wide, *narrow, *found;
+	struct in6_addr prefix = dest_addr;
+	struct in6_addr addr;
+
+	/* 2001:db8:0:1::/64 inside 2001:db8::/32, the more specific one
+	 * is added first as adding a covered route replaces the wider one.
+	 */
+	prefix.s6_addr[7] = 1U;
+
+	narrow = net_route_add(my_iface, &prefix, 64, &peer_addr);
+	zassert_not_null(narrow, "Route add failed");
+
+	net_ipv6_addr_create(&addr, 0x2001, 0x0db8, 0, 0, 0, 0, 0, 0);
+
+	wide = net_route_add(my_iface, &addr, 32, &peer_addr);
+	zassert_not_null(wide, "Route add failed");
+	zassert_not_equal(wide, narrow, "Wide route not added");
+
+	addr = prefix;
+	addr.s6_addr[15] = 0x42;
+
+	found = net_route_lookup(my_iface, &addr);
+	zassert_equal_ptr(found, narrow, "Longest prefix not found");
+
+	found = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(found, wide, "Wide prefix not found");
+
+	zassert_false(net_route_del(narrow), "Route del failed");
+
+	found = net_route_lookup(my_iface, &addr);
+	zassert_equal_ptr(found, wide, "Wide prefix not found after del");
+
+	zassert_false(net_route_del(wide), "Route del failed");
+
+	found = net_route_lookup(my_iface, &addr);
+	zassert_is_null(found, "Route found after del");
+}
+
+#if defined(CONFIG_NET_ROUTE_FLOW_CACHE)
+/* A UDP packet from generic_addr to dest_addr received on peer_iface */
+static struct net_pkt *flow_pkt_get(void)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(peer_iface, 0, AF_INET6, IPPROTO_UDP,
+					K_FOREVER);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	zassert_ok(net_ipv6_create(pkt, &generic_addr, &dest_addr),
+		   "Cannot create IPv6 header");
+	zassert_ok(net_udp_create(pkt, htons(4242), htons(4242)),
+		   "Cannot create UDP header");
+
+	net_pkt_cursor_init(pkt);
+	zassert_ok(net_ipv6_finalize(pkt, IPPROTO_UDP),
+		   "Cannot finalize pkt");
+
+	/* As if received from the peer */
+	net_pkt_lladdr_src(pkt)->addr = net_route_data_peer.mac_addr;
+	net_pkt_lladdr_src(pkt)->len = sizeof(struct net_eth_addr);
+	net_pkt_lladdr_src(pkt)->type = NET_LINK_ETHERNET;
+
+	return pkt;
+}
+#endif
+
+static void test_route_flow_cache(void)
+{
+#if defined(CONFIG_NET_ROUTE_FLOW_CACHE)
+	struct net_nbr *nbr, *found;
+	struct net_pkt *pkt;
+
+	nbr = net_ipv6_nbr_lookup(my_iface, &peer_addr);
+	zassert_not_null(nbr, "Peer neighbor not found");
+
+	/* A packet of an unknown flow is left to the slow path */
+	pkt = flow_pkt_get();
+	zassert_equal(net_route_flow_forward(pkt, NET_IPV6_HDR(pkt)),
+		      NET_CONTINUE, "Unknown flow forwarded");
+	net_pkt_unref(pkt);
+
+	net_route_flow_add(peer_iface, &generic_addr, &dest_addr, nbr);
+
+	found = net_route_flow_lookup(peer_iface, &generic_addr, &dest_addr);
+	zassert_equal_ptr(found, nbr, "Flow not found");
+
+	found = net_route_flow_lookup(my_iface, &generic_addr, &dest_addr);
+	zassert_is_null(found, "Flow found on other interface");
+
+	found = net_route_flow_lookup(peer_iface, &dest_addr, &generic_addr);
+	zassert_is_null(found, "Reverse flow found");
+
+	/* Any route change drops the cached flows */
+	entry = net_route_add(my_iface, &dest_addr, 128, &peer_addr);
+	zassert_not_null(entry, "Route add failed");
+
+	found = net_route_flow_lookup(peer_iface, &generic_addr, &dest_addr);
+	zassert_is_null(found, "Flow found after route add");
+
+	net_route_flow_add(peer_iface, &generic_addr, &dest_addr, nbr);
+
+	/* With the route in place, a packet of the cached flow goes out
+	 * of the next hop interface, from that interface's link address
+	 * to the next hop.
+	 */
+	k_sem_reset(&wait_data);
+	sent_iface = NULL;
+
+	pkt = flow_pkt_get();
+	zassert_equal(net_route_flow_forward(pkt, NET_IPV6_HDR(pkt)), NET_OK,
+		      "Cached flow not forwarded");
+	zassert_ok(k_sem_take(&wait_data, WAIT_TIME), "Packet not sent");
+
+	zassert_equal_ptr(sent_iface, my_iface, "Sent on wrong interface");
+	zassert_mem_equal(sent_lladdr_src, net_route_data.mac_addr,
+			  sizeof(struct net_eth_addr), "Wrong source lladdr");
+	zassert_mem_equal(sent_lladdr_dst, net_route_data_peer.mac_addr,
+			  sizeof(struct net_eth_addr), "Wrong dest lladdr");
+
+	zassert_false(net_route_del(entry), "Route del failed");
+
+	found = net_route_flow_lookup(peer_iface, &generic_addr, &dest_addr);
+	zassert_is_null(found, "Flow found after route del");
+
+	/* So does removing the next hop neighbor */
+	net_route_flow_add(peer_iface, &generic_addr, &dest_addr, nbr);
+
+	zassert_true(net_ipv6_nbr_rm(my_iface, &peer_addr),
+		     "Neighbor remove failed");
+
+	found = net_route_flow_lookup(peer_iface, &generic_addr, &dest_addr);
+	zassert_is_null(found, "Flow found after neighbor remove");
+#else
+	ztest_test_skip();
+#endif
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -492,6 +658,8 @@ void test_main(void)
 			ztest_unit_test(test_route_del_nexthop_again),
 			ztest_unit_test(test_populate_nbr_cache),
 			ztest_unit_test(test_route_add_many),
-			ztest_unit_test(test_route_del_many));
+			ztest_unit_test(test_route_del_many),
+			ztest_unit_test(test_route_lookup_longest),
+			ztest_unit_test(test_route_flow_cache));
 	ztest_run_test_suite(test_route);
 }
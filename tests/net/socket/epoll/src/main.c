@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+#include <sys/fdtable.h>
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+#define STRLEN(buf) (sizeof(buf) - 1)
+
+#define TEST_STR_SMALL "test"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* On QEMU, a wait takes +10ms from the requested time. */
+#define FUZZ 10
+
+static int c_sock;
+static int s_sock;
+static struct sockaddr_in6 s_addr;
+
+static void prepare_socks(void)
+{
+	struct sockaddr_in6 c_addr;
+	int res;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+}
+
+static void send_small(void)
+{
+	ssize_t len;
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+}
+
+static void recv_small(void)
+{
+	char buf[10];
+	ssize_t len;
+
+	len = recv(s_sock, buf, sizeof(buf), MSG_DONTWAIT);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+}
+
+static void register_sock(int epfd, int sock, uint32_t events)
+{
+	struct epoll_event ev = {
+		.events = events,
+		.data.fd = sock,
+	};
+
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev), 0,
+		      "add failed");
+}
+
+void test_epoll_level(void)
+{
+	struct epoll_event events[2];
+	uint32_t tstamp;
+	int epfd;
+	int res;
+
+	prepare_socks();
+
+	epfd = epoll_create(1);
+	zassert_true(epfd >= 0, "epoll_create failed");
+
+	register_sock(epfd, s_sock, EPOLLIN);
+
+	/* Nothing ready, timeout of 0 */
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 0, "");
+
+	/* Nothing ready, timeout of 30 */
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 30);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ * 2, "");
+	zassert_equal(res, 0, "");
+
+	send_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	/* Level triggered: still reported until the data is read */
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	recv_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	res = close(epfd);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+}
+
+void test_epoll_edge(void)
+{
+	struct epoll_event ev;
+	struct epoll_event events[2];
+	int epfd;
+	int res;
+
+	prepare_socks();
+
+	epfd = epoll_create(1);
+	zassert_true(epfd >= 0, "epoll_create failed");
+
+	register_sock(epfd, s_sock, EPOLLIN | EPOLLET);
+
+	send_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+
+	/* Edge triggered: not reported again without new data */
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	send_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 100);
+	zassert_equal(res, 1, "");
+
+	recv_small();
+	recv_small();
+
+	/* One-shot: disabled after the first report until re-armed */
+	ev.events = EPOLLIN | EPOLLONESHOT;
+	ev.data.fd = s_sock;
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "mod failed");
+
+	send_small();
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 100);
+	zassert_equal(res, 1, "");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	ev.events = EPOLLIN;
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "mod failed");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+
+	recv_small();
+
+	res = close(epfd);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+}
+
+void test_epoll_ctl(void)
+{
+	struct epoll_event ev = { .events = EPOLLIN };
+	struct epoll_event events[2];
+	int epfd;
+	int res;
+
+	prepare_socks();
+
+	epfd = epoll_create(1);
+	zassert_true(epfd >= 0, "epoll_create failed");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	/* An epoll instance is not a socket */
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, epfd, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EPERM, "");
+
+	res = fcntl(epfd, F_GETFL, 0);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EOPNOTSUPP, "");
+
+	register_sock(epfd, s_sock, EPOLLIN);
+	register_sock(epfd, c_sock, EPOLLOUT);
+
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EEXIST, "");
+
+	/* Sockets are always writable */
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLOUT, "");
+	zassert_equal(events[0].data.fd, c_sock, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, c_sock, NULL);
+	zassert_equal(res, 0, "del failed");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, 0, "del failed");
+
+	send_small();
+	k_msleep(10);
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	/* Closing a registered socket removes it from the instance */
+	register_sock(epfd, s_sock, EPOLLIN);
+
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	res = close(epfd);
+	zassert_equal(res, 0, "close failed");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EBADF, "");
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+}
+
+#ifdef CONFIG_USERSPACE
+#define CHILD_STACK_SZ		(2048 + CONFIG_TEST_EXTRA_STACKSIZE)
+struct k_thread child_thread;
+K_THREAD_STACK_DEFINE(child_stack, CHILD_STACK_SZ);
+ZTEST_BMEM volatile int result;
+ZTEST_BMEM volatile int result_errno;
+
+static void child_entry(void *p1, void *p2, void *p3)
+{
+	struct epoll_event ev = { .events = EPOLLIN };
+	int epfd = POINTER_TO_INT(p1);
+	int sock = POINTER_TO_INT(p2);
+
+	result = epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev);
+	result_errno = errno;
+}
+
+static void spawn_child(int epfd, int sock)
+{
+	k_thread_create(&child_thread, child_stack,
+			K_THREAD_STACK_SIZEOF(child_stack), child_entry,
+			INT_TO_POINTER(epfd), INT_TO_POINTER(sock), NULL,
+			0, K_USER, K_FOREVER);
+}
+#endif
+
+void test_epoll_permission(void)
+{
+#ifdef CONFIG_USERSPACE
+	struct net_context *ctx;
+	int epfd;
+	int res;
+
+	prepare_socks();
+
+	epfd = epoll_create(1);
+	zassert_true(epfd >= 0, "epoll_create failed");
+
+	ctx = zsock_get_context_object(s_sock);
+	zassert_not_null(ctx, "zsock_get_context_object() failed");
+
+	/* A user thread which has not been granted the socket must not
+	 * be able to watch it.
+	 */
+	spawn_child(epfd, s_sock);
+	k_thread_start(&child_thread);
+	k_thread_join(&child_thread, K_FOREVER);
+
+	zassert_equal(result, -1, "child succeeded with no permission");
+	zassert_equal(result_errno, EBADF, "");
+
+	spawn_child(epfd, s_sock);
+	k_object_access_grant(ctx, &child_thread);
+	k_thread_start(&child_thread);
+	k_thread_join(&child_thread, K_FOREVER);
+
+	zassert_equal(result, 0, "child failed with permissions");
+
+	res = close(epfd);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+#else
+	ztest_test_skip();
+#endif /* CONFIG_USERSPACE */
+}
+
+void test_main(void)
+{
+#ifdef CONFIG_USERSPACE
+	/* ztest thread inherit permissions from main */
+	k_thread_access_grant(k_current_get(), &child_thread, child_stack);
+#endif
+
+	ztest_test_suite(socket_epoll,
+			 ztest_unit_test(test_epoll_level),
+			 ztest_unit_test(test_epoll_edge),
+			 ztest_unit_test(test_epoll_ctl),
+			 ztest_unit_test(test_epoll_permission));
+
+	ztest_run_test_suite(socket_epoll);
+}
@@ -14,6 +14,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include <net/socket.h>
 #include <net/ethernet.h>
+#include <net/buf.h>
 
 #include "ipv6.h"
 #include "../../socket_helpers.h"
@@ -1212,6 +1213,255 @@ void test_v6_msg_trunc(void)
 		       (struct sockaddr *)&server_addr, sizeof(server_addr));
 }
 
+static void comm_sendto_recvmsg(int client_sock, int server_sock,
+				struct sockaddr *server_addr,
+				socklen_t server_addrlen)
+{
+	union {
+		struct cmsghdr hdr;
+		uint8_t buf[CMSG_SPACE(sizeof(struct in6_pktinfo)) +
+			    CMSG_SPACE(sizeof(struct net_buf *))];
+	} control;
+	struct sockaddr_in6 addr;
+	struct iovec iov[4];
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	struct net_buf *zc_buf = NULL;
+	bool pktinfo_found = false;
+	size_t i, offset;
+	ssize_t sent, recved;
+	int rv, opt = 1;
+
+	if (server_addr->sa_family == AF_INET) {
+		rv = setsockopt(server_sock, IPPROTO_IP, IP_PKTINFO,
+				&opt, sizeof(opt));
+	} else {
+		rv = setsockopt(server_sock, IPPROTO_IPV6, IPV6_RECVPKTINFO,
+				&opt, sizeof(opt));
+	}
+	zassert_equal(rv, 0, "setsockopt failed (%d)", errno);
+
+	/* Scatter a datagram over two buffers */
+	sent = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		      server_addr, server_addrlen);
+	zassert_equal(sent, STRLEN(TEST_STR2), "sendto failed");
+
+	clear_buf(rx_buf);
+	iov[0].iov_base = rx_buf;
+	iov[0].iov_len = 10;
+	iov[1].iov_base = rx_buf + 100;
+	iov[1].iov_len = sizeof(rx_buf) - 100;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_name = &addr;
+	msg.msg_namelen = sizeof(addr);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = 2;
+	msg.msg_control = &control;
+	msg.msg_controllen = sizeof(control);
+
+	recved = recvmsg(server_sock, &msg, 0);
+	zassert_equal(recved, STRLEN(TEST_STR2), "recvmsg failed (%d)", errno);
+	zassert_mem_equal(rx_buf, TEST_STR2, 10, "wrong data");
+	zassert_mem_equal(rx_buf + 100, TEST_STR2 + 10, STRLEN(TEST_STR2) - 10,
+			  "wrong data");
+	zassert_equal(msg.msg_flags, 0, "unexpected msg_flags");
+	zassert_equal(msg.msg_namelen, server_addrlen, "unexpected namelen");
+
+	for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+		if (cmsg->cmsg_level == IPPROTO_IP &&
+		    cmsg->cmsg_type == IP_PKTINFO) {
+			struct in_pktinfo *info = (void *)CMSG_DATA(cmsg);
+
+			zassert_true(net_ipv4_addr_cmp(&info->ipi_addr,
+					&net_sin(server_addr)->sin_addr),
+				     "wrong pktinfo address");
+			pktinfo_found = true;
+		} else if (cmsg->cmsg_level == IPPROTO_IPV6 &&
+			   cmsg->cmsg_type == IPV6_PKTINFO) {
+			struct in6_pktinfo *info = (void *)CMSG_DATA(cmsg);
+
+			zassert_true(net_ipv6_addr_cmp(&info->ipi6_addr,
+					&net_sin6(server_addr)->sin6_addr),
+				     "wrong pktinfo address");
+			pktinfo_found = true;
+		}
+	}
+	zassert_true(pktinfo_found, "no pktinfo control message");
+
+	/* Same datagram without copying */
+	sent = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		      server_addr, server_addrlen);
+	zassert_equal(sent, STRLEN(TEST_STR2), "sendto failed");
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = iov;
+	msg.msg_iovlen = ARRAY_SIZE(iov);
+	msg.msg_control = &control;
+	msg.msg_controllen = sizeof(control);
+
+	recved = recvmsg(server_sock, &msg, MSG_ZEROCOPY);
+	zassert_equal(recved, STRLEN(TEST_STR2), "recvmsg failed (%d)", errno);
+
+	for (offset = 0, i = 0; i < msg.msg_iovlen; i++) {
+		zassert_mem_equal(iov[i].iov_base, TEST_STR2 + offset,
+				  iov[i].iov_len, "wrong data");
+		offset += iov[i].iov_len;
+	}
+	zassert_equal(offset, STRLEN(TEST_STR2), "wrong iov length");
+
+	for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+		if (cmsg->cmsg_level == SOL_SOCKET &&
+		    cmsg->cmsg_type == SCM_NET_BUF) {
+			memcpy(&zc_buf, CMSG_DATA(cmsg), sizeof(zc_buf));
+		}
+	}
+	zassert_not_null(zc_buf, "no net_buf control message");
+	net_buf_unref(zc_buf);
+}
+
+void test_v4_sendto_recvmsg(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	comm_sendto_recvmsg(client_sock, server_sock,
+			    (struct sockaddr *)&server_addr,
+			    sizeof(server_addr));
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+void test_v6_sendto_recvmsg(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 client_addr;
+	struct sockaddr_in6 server_addr;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	comm_sendto_recvmsg(client_sock, server_sock,
+			    (struct sockaddr *)&server_addr,
+			    sizeof(server_addr));
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+void test_v4_sendmmsg_recvmmsg(void)
+{
+	static const char * const strs[] = { "test", "batch", "datagram" };
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr_in src_addr[ARRAY_SIZE(strs)];
+	struct mmsghdr msgs[ARRAY_SIZE(strs)];
+	struct iovec iov[ARRAY_SIZE(strs)];
+	char bufs[ARRAY_SIZE(strs)][16];
+	int recved = 0;
+	int i;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	memset(msgs, 0, sizeof(msgs));
+
+	for (i = 0; i < ARRAY_SIZE(strs); i++) {
+		iov[i].iov_base = (void *)strs[i];
+		iov[i].iov_len = strlen(strs[i]);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &server_addr;
+		msgs[i].msg_hdr.msg_namelen = sizeof(server_addr);
+	}
+
+	rv = sendmmsg(client_sock, msgs, ARRAY_SIZE(msgs), 0);
+	zassert_equal(rv, ARRAY_SIZE(msgs), "sendmmsg failed (%d)", errno);
+
+	for (i = 0; i < ARRAY_SIZE(strs); i++) {
+		zassert_equal(msgs[i].msg_len, strlen(strs[i]),
+			      "wrong sent length");
+	}
+
+	/* The datagrams may not all be queued yet when the first one is */
+	while (recved < ARRAY_SIZE(strs)) {
+		memset(msgs, 0, sizeof(msgs));
+
+		for (i = recved; i < ARRAY_SIZE(strs); i++) {
+			iov[i].iov_base = bufs[i];
+			iov[i].iov_len = sizeof(bufs[i]);
+			msgs[i].msg_hdr.msg_iov = &iov[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_name = &src_addr[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(src_addr[i]);
+		}
+
+		rv = recvmmsg(server_sock, &msgs[recved],
+			      ARRAY_SIZE(strs) - recved, MSG_WAITFORONE);
+		zassert_true(rv > 0, "recvmmsg failed (%d)", errno);
+
+		for (i = recved; i < recved + rv; i++) {
+			zassert_equal(msgs[i].msg_len, strlen(strs[i]),
+				      "wrong received length");
+			zassert_mem_equal(bufs[i], strs[i], strlen(strs[i]),
+					  "wrong data");
+			zassert_equal(msgs[i].msg_hdr.msg_namelen,
+				      sizeof(struct sockaddr_in),
+				      "wrong address length");
+			zassert_equal(src_addr[i].sin_family, AF_INET,
+				      "wrong source address");
+		}
+
+		recved += rv;
+	}
+
+	/* Nothing left, so a non blocking call fails */
+	rv = recvmmsg(server_sock, msgs, ARRAY_SIZE(msgs), MSG_DONTWAIT);
+	zassert_equal(rv, -1, "recvmmsg returned data");
+	zassert_equal(errno, EAGAIN, "wrong errno");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 void test_main(void)
 {
 	k_thread_system_pool_assign(k_current_get());
@@ -1242,7 +1492,11 @@ void test_main(void)
 			 ztest_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_user_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_unit_test(test_v4_msg_trunc),
-			 ztest_unit_test(test_v6_msg_trunc)
+			 ztest_unit_test(test_v6_msg_trunc),
+			 ztest_unit_test(test_v4_sendto_recvmsg),
+			 ztest_unit_test(test_v6_sendto_recvmsg),
+			 ztest_unit_test(test_v4_sendmmsg_recvmmsg),
+			 ztest_user_unit_test(test_v4_sendmmsg_recvmmsg)
 		);
 
 	ztest_run_test_suite(socket_udp);
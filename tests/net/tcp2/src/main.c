@@ -97,6 +97,7 @@ static struct net_if *iface;
 static uint8_t test_case_no;
 static uint32_t seq;
 static uint32_t ack;
+static uint16_t peer_window = NET_IPV6_MTU;
 
 static K_SEM_DEFINE(test_sem, 0, 1);
 static bool sem;
@@ -125,6 +126,8 @@ static void handle_syn_resend(void);
 static void handle_client_fin_wait_2_test(sa_family_t af, struct tcphdr *th);
 static void handle_client_closing_test(sa_family_t af, struct tcphdr *th);
 static void handle_server_recv_out_of_order(struct net_pkt *pkt);
+static void handle_server_sack(struct net_pkt *pkt, struct tcphdr *th);
+static void handle_server_offload(struct net_pkt *pkt, struct tcphdr *th);
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -213,6 +216,9 @@ static uint8_t tcp_options[20] = {
 	0x01, /* NOP */
 	0x03, 0x03, 0x07 /* Win scale*/ };
 
+/* Test cases whose peer sends the options above in its SYN */
+#define PEER_OPTIONS(_no) ((_no) == 4U || (_no) == 10U)
+
 static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 					      uint16_t src_port,
 					      uint16_t dst_port,
@@ -226,7 +232,7 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	uint8_t opts_len = 0;
 	int ret = -EINVAL;
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
+	if (PEER_OPTIONS(test_case_no) && (flags & SYN)) {
 		opts_len = sizeof(tcp_options);
 	}
 
@@ -262,14 +268,14 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	th->th_sport = src_port;
 	th->th_dport = dst_port;
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
+	if (PEER_OPTIONS(test_case_no) && (flags & SYN)) {
 		th->th_off = 10U;
 	} else {
 		th->th_off = 5U;
 	}
 
 	th->th_flags = flags;
-	th->th_win = NET_IPV6_MTU;
+	th->th_win = htons(peer_window);
 	th->th_seq = htonl(seq);
 
 	if (ACK & flags) {
@@ -281,7 +287,7 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 		goto fail;
 	}
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
+	if (PEER_OPTIONS(test_case_no) && (flags & SYN)) {
 		/* Add TCP Options */
 		ret = net_pkt_write(pkt, tcp_options, opts_len);
 		if (ret < 0) {
@@ -420,6 +426,12 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 9:
 		handle_server_recv_out_of_order(pkt);
 		break;
+	case 10:
+		handle_server_sack(pkt, &th);
+		break;
+	case 11:
+		handle_server_offload(pkt, &th);
+		break;
 	default:
 		zassert_true(false, "Undefined test case");
 	}
@@ -647,6 +659,18 @@ static void handle_server_test(sa_family_t af, struct tcphdr *th)
 		break;
 	case T_SYN_ACK:
 		test_verify_flags(th, SYN | ACK);
+
+		/* The window scale and SACK options of the peer are answered,
+		 * otherwise no options are sent back.
+		 */
+		if (PEER_OPTIONS(test_case_no) &&
+		    (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) ||
+		     IS_ENABLED(CONFIG_NET_TCP_SACK))) {
+			zassert_true(th->th_off > 5U, "No options in SYN-ACK");
+		} else {
+			zassert_equal(th->th_off, 5U, "Unexpected options");
+		}
+
 		seq++;
 		ack = ntohs(th->th_seq) + 1U;
 		reply = prepare_ack_packet(af, htons(MY_PORT),
@@ -692,7 +716,8 @@ fail:
 
 static void test_server_timeout(struct k_work *work)
 {
-	if (test_case_no == 3 || test_case_no == 4) {
+	if (test_case_no == 3 || test_case_no == 4 || test_case_no == 10 ||
+	    test_case_no == 11) {
 		handle_server_test(AF_INET, NULL);
 	} else if (test_case_no == 5) {
 		handle_server_test(AF_INET6, NULL);
@@ -713,6 +738,8 @@ static void test_tcp_recv_cb(struct net_context *context,
 	}
 }
 
+static struct net_context *accepted_ctx;
+
 static void test_tcp_accept_cb(struct net_context *ctx,
 			       struct sockaddr *addr,
 			       socklen_t addrlen,
@@ -725,6 +752,7 @@ static void test_tcp_accept_cb(struct net_context *ctx,
 
 	/* set callback on newly created context */
 	ctx->recv_cb = test_tcp_recv_cb;
+	accepted_ctx = ctx;
 
 	test_sem_give();
 }
@@ -1484,6 +1512,543 @@ static void test_server_timeout_out_of_order_data(void)
 	net_tcp_put(ooo_ctx);
 }
 
+/* Let the peer connect to a new IPv4 server context, which is returned.
+ * The accepted context is left in accepted_ctx.
+ */
+static struct net_context *accept_server_ipv4(uint8_t case_no)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	int ret;
+
+	t_state = T_SYN;
+	test_case_no = case_no;
+	seq = ack = 0;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	zassert_equal(ret, 0, "Failed to get net_context");
+
+	ret = net_context_bind(ctx, (struct sockaddr *)&my_addr_s,
+			       sizeof(struct sockaddr_in));
+	zassert_equal(ret, 0, "Failed to bind net_context");
+
+	ret = net_context_listen(ctx, 1);
+	zassert_equal(ret, 0, "Failed to listen on net_context");
+
+	/* Trigger the peer to send SYN */
+	k_work_reschedule(&test_server, K_NO_WAIT);
+
+	ret = net_context_accept(ctx, test_tcp_accept_cb, K_FOREVER, NULL);
+	zassert_equal(ret, 0, "Failed to set accept on net_context");
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	conn = accepted_ctx->tcp;
+	ack = conn->seq;
+
+	return ctx;
+}
+
+/* Close the connection from the peer side */
+static void close_server_ipv4(struct net_context *ctx)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	t_state = T_FIN;
+
+	pkt = prepare_fin_ack_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT));
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+
+	k_msleep(50);
+	zassert_equal(t_state, T_FIN_ACK, "Connection not closed");
+
+	net_context_put(ctx);
+}
+
+static uint32_t sack_test_ack;
+static struct tcp_sack_block sack_test_block;
+static int sack_test_blocks;
+
+/* Returns the number of blocks in the SACK option of the segment, the first
+ * one is stored in blk.
+ */
+static int read_sack_option(struct net_pkt *pkt, struct tcphdr *th,
+			    struct tcp_sack_block *blk)
+{
+	size_t len = th->th_off * 4U - sizeof(struct tcphdr);
+	uint8_t opts[40];
+	int blocks = 0;
+	size_t i = 0;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+			 net_pkt_ip_opts_len(pkt) + sizeof(struct tcphdr)) ||
+	    net_pkt_read(pkt, opts, len)) {
+		return -EINVAL;
+	}
+
+	while (i < len && opts[i] != TCPOPT_END) {
+		if (opts[i] == TCPOPT_NOP) {
+			i++;
+			continue;
+		}
+
+		if (i + 1 >= len || opts[i + 1] < 2U) {
+			return -EINVAL;
+		}
+
+		if (opts[i] == TCPOPT_SACK && opts[i + 1] >= 10U) {
+			blk->start = sys_get_be32(&opts[i + 2]);
+			blk->end = sys_get_be32(&opts[i + 6]);
+			blocks = (opts[i + 1] - 2) / 8;
+		}
+
+		i += opts[i + 1];
+	}
+
+	return blocks;
+}
+
+static void handle_server_sack(struct net_pkt *pkt, struct tcphdr *th)
+{
+	/* The handshake and the close go through the common handler */
+	if (t_state != T_DATA) {
+		handle_server_test(AF_INET, th);
+		return;
+	}
+
+	test_verify_flags(th, ACK);
+
+	sack_test_ack = ntohl(th->th_ack);
+	sack_test_blocks = read_sack_option(pkt, th, &sack_test_block);
+
+	test_sem_give();
+}
+
+static void send_sack_test_data(uint32_t offset, size_t len)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	seq += offset;
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT),
+				  lorem_ipsum + offset, len);
+	seq -= offset;
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+}
+
+/* Test case scenario IPv4
+ *   Expect SYN with TCP options,
+ *   send SYN ACK,
+ *   expect ACK,
+ *   check the negotiated window scale and SACK,
+ *   send DATA after a hole,
+ *   expect duplicate ACK with a SACK block covering the DATA,
+ *   send the missing DATA,
+ *   expect ACK of all the DATA without SACK block,
+ *   send FIN ACK,
+ *   expect FIN ACK,
+ *   send ACK.
+ *   any failures cause test case to fail.
+ */
+static void test_server_sack_ipv4(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	int ret;
+
+	/* The SACK blocks describe the receive queue */
+	if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT == 0) {
+		ztest_test_skip();
+	}
+
+	/* Small enough to stay below the send window limit once scaled */
+	peer_window = 8U;
+
+	ctx = accept_server_ipv4(10U);
+	conn = accepted_ctx->tcp;
+
+	/* The peer offered a window scale of 7 and SACK */
+	zassert_equal(conn->wscale_ok,
+		      IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE),
+		      "Window scale not negotiated");
+	zassert_equal(conn->sack_ok, IS_ENABLED(CONFIG_NET_TCP_SACK),
+		      "SACK not negotiated");
+	if (conn->wscale_ok) {
+		zassert_equal(conn->snd_wscale, 7U, "Wrong send window scale");
+	}
+
+	send_sack_test_data(10U, 10U);
+
+	if (conn->sack_ok) {
+		test_sem_take(K_MSEC(100), __LINE__);
+
+		zassert_equal(sack_test_ack, seq, "Hole acknowledged");
+		zassert_equal(sack_test_blocks, 1, "Expected one SACK block");
+		zassert_equal(sack_test_block.start, seq + 10U,
+			      "Wrong SACK block start");
+		zassert_equal(sack_test_block.end, seq + 20U,
+			      "Wrong SACK block end");
+	} else {
+		/* Without SACK the data is queued silently */
+		ret = k_sem_take(&test_sem, K_MSEC(50));
+		zassert_equal(ret, -EAGAIN, "Unexpected ACK");
+	}
+
+	zassert_equal(conn->send_win, (uint32_t)peer_window <<
+		      (conn->wscale_ok ? 7 : 0), "Window not scaled");
+	peer_window = NET_IPV6_MTU;
+
+	send_sack_test_data(0U, 10U);
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	zassert_equal(sack_test_ack, seq + 20U, "Queued data not acknowledged");
+	zassert_equal(sack_test_blocks, 0, "Unexpected SACK block");
+
+	seq += 20U;
+	close_server_ipv4(ctx);
+}
+
+#define OFFLOAD_MAX_SEGS 8
+#define OFFLOAD_GRO_SEGS 4
+#define OFFLOAD_GRO_LEN 100U
+
+static size_t offload_seg_len[OFFLOAD_MAX_SEGS];
+static uint8_t offload_seg_flags[OFFLOAD_MAX_SEGS];
+static uint8_t offload_buf[NET_IPV4_MTU];
+static int offload_segs;
+static size_t offload_bytes;
+static size_t offload_expected;
+static bool offload_data_ok;
+static uint32_t offload_ack;
+static int offload_acks;
+static size_t offload_recv_len;
+
+/* Record the segments sent by the stack, checking that they follow each
+ * other and carry the data given to the context.
+ */
+static void handle_server_offload(struct net_pkt *pkt, struct tcphdr *th)
+{
+	size_t hdr_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt) +
+			 th->th_off * 4U;
+	size_t len = net_pkt_get_len(pkt) - hdr_len;
+	uint32_t offset;
+
+	if (t_state != T_DATA) {
+		handle_server_test(AF_INET, th);
+		return;
+	}
+
+	if (len == 0) {
+		offload_ack = ntohl(th->th_ack);
+		offload_acks++;
+		test_sem_give();
+		return;
+	}
+
+	offset = ntohl(th->th_seq) - ack;
+
+	if (offload_segs == OFFLOAD_MAX_SEGS || offset != offload_bytes ||
+	    len > sizeof(offload_buf) ||
+	    offset + len > sizeof(lorem_ipsum) - 1) {
+		offload_data_ok = false;
+	} else {
+		net_pkt_cursor_init(pkt);
+		net_pkt_set_overwrite(pkt, true);
+
+		if (net_pkt_skip(pkt, hdr_len) ||
+		    net_pkt_read(pkt, offload_buf, len) ||
+		    memcmp(offload_buf, lorem_ipsum + offset, len)) {
+			offload_data_ok = false;
+		}
+
+		offload_seg_len[offload_segs] = len;
+		offload_seg_flags[offload_segs] = th->th_flags;
+		offload_segs++;
+	}
+
+	offload_bytes += len;
+	if (offload_bytes >= offload_expected) {
+		test_sem_give();
+	}
+}
+
+static void offload_recv_cb(struct net_context *context,
+			    struct net_pkt *pkt,
+			    union net_ip_header *ip_hdr,
+			    union net_proto_header *proto_hdr,
+			    int status,
+			    void *user_data)
+{
+	size_t len;
+
+	if (!pkt) {
+		return;
+	}
+
+	len = net_pkt_remaining_data(pkt);
+
+	if (offload_recv_len + len > sizeof(offload_buf) ||
+	    net_pkt_read(pkt, offload_buf + offload_recv_len, len)) {
+		offload_data_ok = false;
+	} else {
+		offload_recv_len += len;
+	}
+
+	net_pkt_unref(pkt);
+}
+
+/* Test case scenario IPv4
+ *   Expect SYN,
+ *   send SYN ACK,
+ *   expect ACK,
+ *   queue more than one MSS of data,
+ *   expect MSS sized DATA segments cut from one large packet,
+ *   send ACK,
+ *   send FIN ACK,
+ *   expect FIN ACK,
+ *   send ACK.
+ *   any failures cause test case to fail.
+ */
+static void test_server_gso_ipv4(void)
+{
+	size_t len = sizeof(lorem_ipsum) - 1;
+	uint16_t mtu = net_if_get_mtu(iface);
+	uint32_t gso, gso_segs;
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	struct tcp *conn;
+	size_t mss;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_GSO)) {
+		ztest_test_skip();
+	}
+
+	/* Room for all the data in one packet, but not in one segment */
+	net_if_set_mtu(iface, NET_ETH_MTU);
+
+	ctx = accept_server_ipv4(11U);
+	conn = accepted_ctx->tcp;
+
+	/* The peer sent no MSS option, so the IPv4 default applies */
+	mss = conn_mss(conn);
+	zassert_true(len > 2U * mss, "Data fits in two segments");
+	zassert_true(conn->send_win >= len, "Window too small");
+
+	gso = GET_STAT(iface, tcp.gso);
+	gso_segs = GET_STAT(iface, tcp.gso_segs);
+
+	offload_segs = 0;
+	offload_bytes = 0U;
+	offload_expected = len;
+	offload_data_ok = true;
+
+	ret = net_context_send(accepted_ctx, lorem_ipsum, len, NULL,
+			       K_NO_WAIT, NULL);
+	zassert_equal(ret, len, "Failed to send data (%d)", ret);
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	zassert_true(offload_data_ok, "Segment data or sequence wrong");
+	zassert_equal(offload_segs, ceiling_fraction(len, mss),
+		      "Wrong number of segments");
+
+	for (int i = 0; i < offload_segs; i++) {
+		bool last = (i == offload_segs - 1);
+
+		zassert_equal(offload_seg_len[i], last ? len % mss : mss,
+			      "Wrong size of segment %d", i);
+		zassert_equal(offload_seg_flags[i], last ? PSH | ACK : ACK,
+			      "Wrong flags of segment %d", i);
+	}
+
+	/* All the data went down as one packet */
+	zassert_equal(GET_STAT(iface, tcp.gso), gso + 1U,
+		      "Data not sent as one packet");
+	zassert_equal(GET_STAT(iface, tcp.gso_segs), gso_segs + offload_segs,
+		      "Segments not counted");
+
+	ack += len;
+
+	pkt = prepare_ack_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT));
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+
+	close_server_ipv4(ctx);
+	net_if_set_mtu(iface, mtu);
+}
+
+/* Test case scenario IPv4
+ *   Expect SYN,
+ *   send SYN ACK,
+ *   expect ACK,
+ *   send consecutive DATA segments in one batch,
+ *   expect a single ACK of all the DATA,
+ *   check the DATA was received in order,
+ *   send FIN ACK,
+ *   expect FIN ACK,
+ *   send ACK.
+ *   any failures cause test case to fail.
+ */
+static void test_server_gro_ipv4(void)
+{
+#if defined(CONFIG_NET_TCP_GRO) && defined(CONFIG_NET_RX_BATCH)
+	struct net_pkt *pkts[OFFLOAD_GRO_SEGS];
+	size_t len = OFFLOAD_GRO_SEGS * OFFLOAD_GRO_LEN;
+	struct net_context *ctx;
+	uint32_t gro;
+	int ret;
+
+	ctx = accept_server_ipv4(11U);
+
+	ret = net_context_recv(accepted_ctx, offload_recv_cb, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Failed to set recv callback (%d)", ret);
+
+	offload_recv_len = 0U;
+	offload_data_ok = true;
+	offload_ack = 0U;
+	offload_acks = 0;
+
+	gro = GET_STAT(iface, tcp.gro);
+
+	/* Only the last segment pushes the data */
+	for (int i = 0; i < OFFLOAD_GRO_SEGS; i++) {
+		pkts[i] = tester_prepare_tcp_pkt(AF_INET, htons(MY_PORT),
+						 htons(PEER_PORT),
+						 i == OFFLOAD_GRO_SEGS - 1 ?
+						 PSH | ACK : ACK,
+						 lorem_ipsum + i * OFFLOAD_GRO_LEN,
+						 OFFLOAD_GRO_LEN);
+		zassert_not_null(pkts[i], "Cannot create pkt");
+		seq += OFFLOAD_GRO_LEN;
+	}
+
+	seq -= len;
+
+	/* Queued at once, so that each segment is received while the next
+	 * ones are waiting.
+	 */
+	ret = net_recv_data_batch(iface, pkts, OFFLOAD_GRO_SEGS);
+	zassert_equal(ret, OFFLOAD_GRO_SEGS, "recv data failed (%d)", ret);
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	k_msleep(10);
+
+	zassert_equal(GET_STAT(iface, tcp.gro), gro + OFFLOAD_GRO_SEGS - 1U,
+		      "Segments not coalesced");
+	zassert_equal(offload_acks, 1, "Data not acknowledged at once");
+	zassert_equal(offload_ack, seq + len, "Wrong acknowledgment");
+
+	zassert_true(offload_data_ok, "Failed to read the data");
+	zassert_equal(offload_recv_len, len, "Wrong amount of data");
+	zassert_mem_equal(offload_buf, lorem_ipsum, len, "Data out of order");
+
+	seq += len;
+	close_server_ipv4(ctx);
+#else
+	ztest_test_skip();
+#endif
+}
+
+/* Congestion control of a connection using the default IPv4 MSS */
+static void test_cc_newreno(void)
+{
+	struct tcp conn = { 0 };
+	uint32_t mss;
+
+	conn.src.sa.sa_family = AF_INET;
+	mss = conn_mss(&conn);
+
+	zassert_equal(mss, NET_IPV4_MTU - NET_IPV4TCPH_LEN,
+		      "Wrong default MSS");
+
+	tcp_cc_newreno.init(&conn);
+	zassert_equal(conn.cwnd, 4U * mss, "Wrong initial window");
+	zassert_equal(conn.ssthresh, UINT32_MAX, "Wrong initial ssthresh");
+
+	/* Slow start grows by at most one MSS per ACK */
+	tcp_cc_newreno.ack(&conn, 2U * mss);
+	zassert_equal(conn.cwnd, 5U * mss, "Wrong slow start growth");
+
+	/* Half of the data in flight, but at least two segments */
+	conn.unacked_len = 10U * mss;
+	tcp_cc_newreno.loss(&conn, false);
+	zassert_equal(conn.ssthresh, 5U * mss, "Wrong ssthresh");
+
+	conn.unacked_len = mss;
+	tcp_cc_newreno.loss(&conn, true);
+	zassert_equal(conn.ssthresh, 2U * mss, "Wrong minimum ssthresh");
+
+	/* Congestion avoidance grows by one MSS per window acknowledged */
+	conn.cwnd = 4U * mss;
+	tcp_cc_newreno.ack(&conn, 3U * mss);
+	zassert_equal(conn.cwnd, 4U * mss, "Window grown too early");
+
+	tcp_cc_newreno.ack(&conn, mss);
+	zassert_equal(conn.cwnd, 5U * mss, "Wrong congestion avoidance");
+	zassert_equal(conn.cwnd_cnt, 0U, "Acknowledged bytes not consumed");
+}
+
+static void test_cc_cubic(void)
+{
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	struct tcp conn = { 0 };
+	uint32_t mss, cwnd;
+
+	conn.src.sa.sa_family = AF_INET;
+	mss = conn_mss(&conn);
+
+	tcp_cc_cubic.init(&conn);
+	zassert_equal(conn.cwnd, 4U * mss, "Wrong initial window");
+	zassert_equal(conn.ssthresh, UINT32_MAX, "Wrong initial ssthresh");
+
+	tcp_cc_cubic.ack(&conn, 2U * mss);
+	zassert_equal(conn.cwnd, 5U * mss, "Wrong slow start growth");
+
+	/* The window is reduced to 70% and remembered */
+	conn.cwnd = 10U * mss;
+	tcp_cc_cubic.loss(&conn, false);
+	zassert_equal(conn.ssthresh, 7U * mss, "Wrong ssthresh");
+	zassert_equal(conn.cubic_w_max, 10U * mss, "Wrong W_max");
+
+	/* A loss below W_max lowers it further (fast convergence) */
+	conn.cwnd = 8U * mss;
+	tcp_cc_cubic.loss(&conn, false);
+	zassert_equal(conn.cubic_w_max, 8U * mss * 17U / 20U,
+		      "No fast convergence");
+	zassert_equal(conn.ssthresh, 8U * mss * 7U / 10U, "Wrong ssthresh");
+
+	/* Right after a loss the window grows like NewReno at most */
+	conn.cwnd = conn.ssthresh;
+	cwnd = conn.cwnd;
+	for (int i = 0; i < 4; i++) {
+		for (uint32_t acked = 0; acked < cwnd; acked += mss) {
+			tcp_cc_cubic.ack(&conn, mss);
+		}
+
+		zassert_true(conn.cwnd <= cwnd + mss, "Window grown too fast");
+		cwnd = conn.cwnd;
+	}
+
+	zassert_true(conn.cwnd > conn.ssthresh, "Window not grown");
+#else
+	ztest_test_skip();
+#endif
+}
+
 /** Test case main entry */
 void test_main(void)
 {
@@ -1499,7 +2064,12 @@ void test_main(void)
 			 ztest_unit_test(test_client_closing_ipv6),
 			 ztest_unit_test(test_client_invalid_rst),
 			 ztest_unit_test(test_server_recv_out_of_order_data),
-			 ztest_unit_test(test_server_timeout_out_of_order_data)
+			 ztest_unit_test(test_server_timeout_out_of_order_data),
+			 ztest_unit_test(test_server_sack_ipv4),
+			 ztest_unit_test(test_server_gso_ipv4),
+			 ztest_unit_test(test_server_gro_ipv4),
+			 ztest_unit_test(test_cc_newreno),
+			 ztest_unit_test(test_cc_cubic)
 			 );
 
 	ztest_run_test_suite(test_tcp_fn);
@@ -95,6 +95,23 @@ static struct k_sem wait_data;
 
 #define WAIT_TIME K_SECONDS(1)
 
+/* Interleaved UDP flows, which only differ by their source port */
+#define FLOW_COUNT 6
+#define FLOW_PKTS 8
+#define FLOW_PORT 7000
+
+struct flow_state {
+	struct net_context *ctx;
+	k_tid_t thread;
+	uint8_t next_seq;
+	bool moved;
+	bool out_of_order;
+};
+
+static struct flow_state flows[FLOW_COUNT];
+static bool flow_test;
+static bool flow_failed;
+
 struct eth_context {
 	struct net_if *iface;
 	uint8_t mac_addr[6];
@@ -152,6 +169,40 @@ static bool check_higher_priority_pkt_recv(int tc, struct net_pkt *pkt)
 	return false;
 }
 
+/* Check that a flow packet is handled by the same thread as the previous
+ * packets of its flow, and right after them.
+ */
+static void flow_check(struct net_pkt *pkt)
+{
+	struct flow_state *flow;
+	uint8_t data[2];
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+			 net_pkt_ipv6_ext_len(pkt) +
+			 sizeof(struct net_udp_hdr)) ||
+	    net_pkt_read(pkt, data, sizeof(data)) || data[0] >= FLOW_COUNT) {
+		flow_failed = true;
+		return;
+	}
+
+	flow = &flows[data[0]];
+
+	if (flow->thread == NULL) {
+		flow->thread = k_current_get();
+	} else if (flow->thread != k_current_get()) {
+		flow->moved = true;
+	}
+
+	if (data[1] != flow->next_seq) {
+		flow->out_of_order = true;
+	}
+
+	flow->next_seq = data[1] + 1U;
+}
+
 /* The eth_tx() will handle both sent packets or and it will also
  * simulate the receiving of the packets.
  */
@@ -162,6 +213,13 @@ static int eth_tx(const struct device *dev, struct net_pkt *pkt)
 		return -ENODATA;
 	}
 
+	if (flow_test && !start_receiving) {
+		flow_check(pkt);
+		k_sem_give(&wait_data);
+
+		return 0;
+	}
+
 	if (start_receiving) {
 		struct in6_addr addr;
 		struct net_udp_hdr hdr, *udp_hdr;
@@ -968,6 +1026,152 @@ static void test_traffic_class_recv_data_mix_all_2(void)
 	zassert_false(test_failed, "Traffic class verification failed.");
 }
 
+static void flow_recv_cb(struct net_context *context,
+			 struct net_pkt *pkt,
+			 union net_ip_header *ip_hdr,
+			 union net_proto_header *proto_hdr,
+			 int status,
+			 void *user_data)
+{
+	flow_check(pkt);
+	k_sem_give(&wait_data);
+
+	net_pkt_unref(pkt);
+}
+
+static void test_traffic_class_setup_flows(void)
+{
+	struct sockaddr_in6 src_addr6 = {
+		.sin6_family = AF_INET6,
+	};
+	int ret, i;
+
+	net_ipaddr_copy(&src_addr6.sin6_addr, &my_addr1);
+
+	for (i = 0; i < FLOW_COUNT; i++) {
+		ret = net_context_get(AF_INET6, SOCK_DGRAM, IPPROTO_UDP,
+				      &flows[i].ctx);
+		zassert_equal(ret, 0, "Create IPv6 UDP context failed (%d)",
+			      ret);
+
+		src_addr6.sin6_port = htons(FLOW_PORT + i);
+
+		ret = net_context_bind(flows[i].ctx,
+				       (struct sockaddr *)&src_addr6,
+				       sizeof(struct sockaddr_in6));
+		zassert_equal(ret, 0, "Context bind failed (%d)", ret);
+
+		ret = net_context_recv(flows[i].ctx, flow_recv_cb,
+				       K_NO_WAIT, NULL);
+		zassert_equal(ret, 0, "Context recv setup failed (%d)", ret);
+	}
+}
+
+/* Send the packets of all the flows interleaved, and queue them all
+ * before any of them is handled.
+ */
+static void traffic_class_send_flows(void)
+{
+	uint8_t data[2];
+	int ret, i;
+
+	for (i = 0; i < FLOW_COUNT; i++) {
+		flows[i].thread = NULL;
+		flows[i].next_seq = 0U;
+		flows[i].moved = false;
+		flows[i].out_of_order = false;
+	}
+
+	flow_failed = false;
+	flow_test = true;
+	k_sem_init(&wait_data, 0, UINT_MAX);
+
+	k_sched_lock();
+
+	for (data[1] = 0U; data[1] < FLOW_PKTS; data[1]++) {
+		for (data[0] = 0U; data[0] < FLOW_COUNT; data[0]++) {
+			ret = net_context_sendto(flows[data[0]].ctx, data,
+						 sizeof(data),
+						 (struct sockaddr *)&dst_addr6,
+						 sizeof(struct sockaddr_in6),
+						 NULL, K_NO_WAIT, NULL);
+			if (ret < 0) {
+				flow_failed = true;
+			}
+		}
+	}
+
+	k_sched_unlock();
+
+	for (i = 0; i < FLOW_COUNT * FLOW_PKTS; i++) {
+		zassert_equal(k_sem_take(&wait_data, WAIT_TIME), 0,
+			      "Timeout after %d packets", i);
+	}
+
+	flow_test = false;
+}
+
+static void traffic_class_check_flows(int queues)
+{
+	int threads = 0;
+	int i, j;
+
+	zassert_false(flow_failed, "Flow packet lost or malformed");
+
+	for (i = 0; i < FLOW_COUNT; i++) {
+		zassert_false(flows[i].moved, "Flow %d changed thread", i);
+		zassert_false(flows[i].out_of_order, "Flow %d reordered", i);
+		zassert_equal(flows[i].next_seq, FLOW_PKTS,
+			      "Flow %d incomplete", i);
+
+		for (j = 0; j < i; j++) {
+			if (flows[j].thread == flows[i].thread) {
+				break;
+			}
+		}
+
+		if (j == i) {
+			threads++;
+		}
+	}
+
+	/* The ports are fixed, so are the queues the flows hash to */
+	if (queues > 1) {
+		zassert_true(threads > 1, "All the flows in one queue");
+	} else {
+		zassert_equal(threads, 1, "Flows spread without flow queues");
+	}
+}
+
+static void test_traffic_class_send_flows(void)
+{
+	start_receiving = false;
+
+	traffic_class_send_flows();
+	traffic_class_check_flows(NET_TC_TX_COUNT > 0 ?
+				  CONFIG_NET_TC_FLOW_QUEUES : 1);
+}
+
+static void test_traffic_class_recv_flows(void)
+{
+	start_receiving = true;
+
+	traffic_class_send_flows();
+	traffic_class_check_flows(CONFIG_NET_TC_FLOW_QUEUES);
+}
+
+static void test_traffic_class_cleanup_flows(void)
+{
+	int i;
+
+	for (i = 0; i < FLOW_COUNT; i++) {
+		if (flows[i].ctx) {
+			net_context_unref(flows[i].ctx);
+			flows[i].ctx = NULL;
+		}
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(net_traffic_class_test,
@@ -1006,7 +1210,13 @@ void test_main(void)
 			 ztest_unit_test(test_traffic_class_recv_data_mix),
 			 ztest_unit_test(test_traffic_class_recv_data_mix_all_1),
 			 ztest_unit_test(test_traffic_class_recv_data_mix_all_2),
-			 ztest_unit_test(test_traffic_class_cleanup_rx)
+			 ztest_unit_test(test_traffic_class_cleanup_rx),
+
+			 /* Each flow stays in its queue and in order */
+			 ztest_unit_test(test_traffic_class_setup_flows),
+			 ztest_unit_test(test_traffic_class_send_flows),
+			 ztest_unit_test(test_traffic_class_recv_flows),
+			 ztest_unit_test(test_traffic_class_cleanup_flows)
 			 );
 
 	ztest_run_test_suite(net_traffic_class_test);
@@ -433,7 +433,7 @@ void test_udp(void)
 	struct net_conn_handle *handlers[CONFIG_NET_MAX_CONN];
 	struct net_if *iface;
 	struct net_if_addr *ifaddr;
-	struct ud *ud;
+	struct ud *ud, *ud2;
 	int ret, i = 0;
 	bool st;
 
@@ -646,6 +646,21 @@ void test_udp(void)
 	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 12345, 42421);
 	TEST_IPV6_LONG_OK(ud, &in6addr_peer, &in6addr_my, 12345, 42421);
 
+	/* A connected handler wins over a listener on the same port no
+	 * matter in which order they were registered.
+	 */
+	ud = REGISTER(AF_INET6, &peer_addr6, &my_addr6, 2345, 5353);
+	ud2 = REGISTER(AF_INET6, NULL, &any_addr6, 0, 5353);
+	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 2345, 5353);
+	TEST_IPV6_OK(ud2, &in6addr_peer, &in6addr_my, 2346, 5353);
+
+	ud = REGISTER(AF_INET, NULL, &any_addr4, 0, 5353);
+	ud2 = REGISTER(AF_INET, &peer_addr4, &my_addr4, 2345, 5353);
+	TEST_IPV4_OK(ud2, &in4addr_peer, &in4addr_my, 2345, 5353);
+	TEST_IPV4_OK(ud, &in4addr_peer, &in4addr_my, 2346, 5353);
+	UNREGISTER(ud2);
+	TEST_IPV4_OK(ud, &in4addr_peer, &in4addr_my, 2345, 5353);
+
 	/* Remote addr same as local addr, these two will never match */
 	REGISTER(AF_INET6, &my_addr6, NULL, 1234, 4242);
 	REGISTER(AF_INET, &my_addr4, NULL, 1234, 4242);
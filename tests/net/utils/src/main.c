@@ -20,6 +20,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_UTILS_LOG_LEVEL);
 #include <init.h>
 #include <sys/printk.h>
 #include <net/net_core.h>
+#include <net/net_pkt.h>
 #include <net/net_ip.h>
 #include <net/ethernet.h>
 #include <linker/sections.h>
@@ -848,11 +849,216 @@ void test_addr_parse(void)
 #endif
 }
 
+/* Bytes of the first fragment after the IPv4 header, then the lengths
+ * of the following fragments. A non-zero reserve makes the data of a
+ * fragment start at an odd or unaligned address.
+ */
+struct chksum_layout {
+	uint8_t first;
+	uint8_t frags[5];
+	uint8_t reserve[5];
+};
+
+static const struct chksum_layout chksum_layouts[] = {
+	{ 108, { 0 }, { 0 } },
+	{ 7, { 1, 33, 2, 64, 17 }, { 0, 1, 0, 3, 1 } },
+	{ 8, { 100, 100, 100, 100, 100 }, { 0, 0, 0, 0, 0 } },
+	{ 1, { 127, 1, 126, 3, 9 }, { 1, 0, 2, 1, 0 } },
+	{ 13, { 31, 5 }, { 3, 2 } },
+};
+
+static uint8_t chksum_data[NET_IPV4H_LEN + 6 * CONFIG_NET_BUF_DATA_SIZE];
+
+/* Straightforward RFC 1071 sum, used as a reference */
+static uint16_t ref_chksum_add(uint32_t sum, const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		sum += (i & 1) ? data[i] : data[i] << 8;
+	}
+
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return sum;
+}
+
+static uint16_t ref_chksum_udp(const uint8_t *ip, size_t payload_len)
+{
+	uint32_t sum = payload_len + IPPROTO_UDP;
+
+	/* Source and destination addresses of the IPv4 header */
+	sum = ref_chksum_add(sum, ip + 12, 8);
+	sum = ref_chksum_add(sum, ip + NET_IPV4H_LEN, payload_len);
+
+	return ~sum & 0xffff;
+}
+
+static struct net_pkt *chksum_pkt_build(const struct chksum_layout *layout,
+					size_t *payload_len)
+{
+	const uint8_t *data = chksum_data;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	size_t len;
+
+	pkt = net_pkt_alloc(K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, NET_IPV4H_LEN);
+
+	frag = net_pkt_get_frag(pkt, K_NO_WAIT);
+	zassert_not_null(frag, "Cannot allocate frag");
+
+	len = NET_IPV4H_LEN + layout->first;
+	net_buf_add_mem(frag, data, len);
+	net_pkt_frag_add(pkt, frag);
+	data += len;
+	*payload_len = layout->first;
+
+	for (int i = 0; i < ARRAY_SIZE(layout->frags) && layout->frags[i]; i++) {
+		frag = net_pkt_get_frag(pkt, K_NO_WAIT);
+		zassert_not_null(frag, "Cannot allocate frag");
+
+		net_buf_reserve(frag, layout->reserve[i]);
+		net_buf_add_mem(frag, data, layout->frags[i]);
+		net_pkt_frag_add(pkt, frag);
+		data += layout->frags[i];
+		*payload_len += layout->frags[i];
+	}
+
+	return pkt;
+}
+
+void test_chksum(void)
+{
+	for (size_t i = 0; i < sizeof(chksum_data); i++) {
+		chksum_data[i] = (i * 7 + 3) ^ (i >> 8);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(chksum_layouts); i++) {
+		struct net_pkt *pkt;
+		size_t payload_len;
+		uint16_t chksum;
+
+		pkt = chksum_pkt_build(&chksum_layouts[i], &payload_len);
+
+		chksum = net_calc_chksum(pkt, IPPROTO_UDP);
+		zassert_equal(ntohs(chksum),
+			      ref_chksum_udp(chksum_data, payload_len),
+			      "Wrong checksum for layout %d", i);
+
+		net_pkt_unref(pkt);
+	}
+}
+
+void test_chksum_update(void)
+{
+	struct in_addr new_addr = { { { 198, 51, 100, 7 } } };
+	struct in_addr old_addr;
+	uint16_t new_port = htons(5353);
+	uint16_t old_port;
+	struct net_pkt *pkt;
+	size_t payload_len;
+	uint16_t chksum;
+
+	for (size_t i = 0; i < sizeof(chksum_data); i++) {
+		chksum_data[i] = (i * 13 + 1) ^ (i >> 4);
+	}
+
+	pkt = chksum_pkt_build(&chksum_layouts[1], &payload_len);
+	chksum = net_calc_chksum(pkt, IPPROTO_UDP);
+	net_pkt_unref(pkt);
+
+	/* Rewrite the destination address, as NAT would */
+	memcpy(&old_addr, chksum_data + 16, sizeof(old_addr));
+	memcpy(chksum_data + 16, &new_addr, sizeof(new_addr));
+	chksum = net_chksum_update(chksum, &old_addr, &new_addr,
+				   sizeof(new_addr));
+	zassert_equal(ntohs(chksum),
+		      ref_chksum_udp(chksum_data, payload_len),
+		      "Wrong checksum after address update");
+
+	/* And the source port, first word of the UDP header */
+	memcpy(&old_port, chksum_data + NET_IPV4H_LEN, sizeof(old_port));
+	memcpy(chksum_data + NET_IPV4H_LEN, &new_port, sizeof(new_port));
+	chksum = net_chksum_update16(chksum, old_port, new_port);
+	zassert_equal(ntohs(chksum),
+		      ref_chksum_udp(chksum_data, payload_len),
+		      "Wrong checksum after port update");
+
+	pkt = chksum_pkt_build(&chksum_layouts[1], &payload_len);
+	zassert_equal(net_calc_chksum(pkt, IPPROTO_UDP), chksum,
+		      "Incremental and full checksums differ");
+	net_pkt_unref(pkt);
+}
+
+static void chksum_check(const struct chksum_layout *layout, int align)
+{
+	struct net_pkt *pkt;
+	size_t payload_len;
+	uint16_t chksum;
+
+	pkt = chksum_pkt_build(layout, &payload_len);
+
+	chksum = net_calc_chksum(pkt, IPPROTO_UDP);
+	zassert_equal(ntohs(chksum),
+		      ref_chksum_udp(chksum_data, payload_len),
+		      "Wrong checksum for %zu bytes at alignment %d",
+		      payload_len, align);
+
+	net_pkt_unref(pkt);
+}
+
+/* Every payload length that fits a fragment, starting at every offset
+ * within a machine word, whole or split over two fragments.
+ */
+void test_chksum_lengths(void)
+{
+	const size_t max_len = CONFIG_NET_BUF_DATA_SIZE - sizeof(uint64_t);
+
+	for (size_t i = 0; i < sizeof(chksum_data); i++) {
+		chksum_data[i] = (i * 31 + 5) ^ (i >> 3);
+	}
+
+	for (int align = 0; align < sizeof(uint64_t); align++) {
+		for (size_t len = 0; len <= max_len; len++) {
+			struct chksum_layout layout = {
+				.frags = { len },
+				.reserve = { align },
+			};
+
+			chksum_check(&layout, align);
+
+			/* Starting in the fragment of the IPv4 header */
+			layout.first = MIN(len, align + 1);
+			layout.frags[0] = len - layout.first;
+			layout.reserve[0] = sizeof(uint64_t) - 1 - align;
+			chksum_check(&layout, align);
+
+			if (len < 2) {
+				continue;
+			}
+
+			layout.first = 0;
+			layout.frags[0] = len / 2;
+			layout.frags[1] = len - len / 2;
+			layout.reserve[0] = align;
+			layout.reserve[1] = (align + 3) % sizeof(uint64_t);
+			chksum_check(&layout, align);
+		}
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_utils_fn,
 			 ztest_user_unit_test(test_net_addr),
-			 ztest_unit_test(test_addr_parse));
+			 ztest_unit_test(test_addr_parse),
+			 ztest_unit_test(test_chksum),
+			 ztest_unit_test(test_chksum_update),
+			 ztest_unit_test(test_chksum_lengths));
 
 	ztest_run_test_suite(test_utils_fn);
 }
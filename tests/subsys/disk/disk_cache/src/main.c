@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <storage/disk_access.h>
+
+#define DISK_NAME CONFIG_DISK_RAM_VOLUME_NAME
+#define SECTOR_SIZE 512
+#define SECTOR_COUNT (CONFIG_DISK_RAM_VOLUME_SIZE * 1024 / SECTOR_SIZE)
+
+/* Long enough to also take the path of requests bypassing the cache */
+#define MAX_RUN CONFIG_DISK_CACHE_BLOCKS
+
+#define FUZZ_OPS 4000
+
+/* What the disk must read back, whatever the cache holds */
+static uint8_t shadow[SECTOR_COUNT][SECTOR_SIZE];
+static uint8_t buf[MAX_RUN * SECTOR_SIZE];
+
+static uint32_t seed = 0x2545f491;
+
+/* xorshift32, so that a failing sequence can be replayed */
+static uint32_t rand_get(void)
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+
+	return seed;
+}
+
+static void pick_run(uint32_t *start, uint32_t *count)
+{
+	*count = 1U + rand_get() % MAX_RUN;
+	*start = rand_get() % (SECTOR_COUNT - *count + 1U);
+}
+
+static void disk_write_run(uint32_t start, uint32_t count)
+{
+	uint32_t stamp = rand_get();
+
+	for (uint32_t i = 0U; i < count * SECTOR_SIZE; i++) {
+		buf[i] = (uint8_t)(stamp + i * 7U);
+	}
+
+	zassert_equal(disk_access_write(DISK_NAME, buf, start, count), 0,
+		      "write of %u sectors at %u failed", count, start);
+
+	memcpy(shadow[start], buf, count * SECTOR_SIZE);
+}
+
+static void disk_check_run(uint32_t start, uint32_t count)
+{
+	(void)memset(buf, 0, sizeof(buf));
+
+	zassert_equal(disk_access_read(DISK_NAME, buf, start, count), 0,
+		      "read of %u sectors at %u failed", count, start);
+
+	for (uint32_t i = 0U; i < count; i++) {
+		zassert_mem_equal(&buf[i * SECTOR_SIZE], shadow[start + i],
+				  SECTOR_SIZE, "sector %u differs", start + i);
+	}
+}
+
+static void disk_check_all(void)
+{
+	for (uint32_t s = 0U; s < SECTOR_COUNT; s += MAX_RUN) {
+		disk_check_run(s, MIN(MAX_RUN, SECTOR_COUNT - s));
+	}
+}
+
+static void test_disk_cache_setup(void)
+{
+	uint32_t sector_size, sector_count;
+
+	zassert_equal(disk_access_init(DISK_NAME), 0, "init failed");
+
+	zassert_equal(disk_access_ioctl(DISK_NAME, DISK_IOCTL_GET_SECTOR_SIZE,
+					&sector_size), 0, "ioctl failed");
+	zassert_equal(sector_size, CONFIG_DISK_CACHE_BLOCK_SIZE,
+		      "disk would not be cached");
+
+	zassert_equal(disk_access_ioctl(DISK_NAME, DISK_IOCTL_GET_SECTOR_COUNT,
+					&sector_count), 0, "ioctl failed");
+	zassert_equal(sector_count, SECTOR_COUNT, "unexpected disk size");
+
+	for (uint32_t s = 0U; s < SECTOR_COUNT; s += MAX_RUN) {
+		disk_write_run(s, MIN(MAX_RUN, SECTOR_COUNT - s));
+	}
+
+	disk_check_all();
+}
+
+/**
+ * @brief Check random reads, writes, syncs and initializations
+ *
+ * Every read must return the data last written, whether it comes from
+ * the cache or from the disk, and every initialization must leave the
+ * written data on the disk.
+ */
+static void test_disk_cache_fuzz(void)
+{
+	struct disk_cache_stats stats;
+	uint32_t start, count, op;
+
+	for (int i = 0; i < FUZZ_OPS; i++) {
+		op = rand_get() % 100U;
+		pick_run(&start, &count);
+
+		/* Sequential reads give the read ahead a chance */
+		if (op < 15U && start + 2U * count <= SECTOR_COUNT) {
+			disk_check_run(start, count);
+			disk_check_run(start + count, count);
+		} else if (op < 50U) {
+			disk_check_run(start, count);
+		} else if (op < 90U) {
+			disk_write_run(start, count);
+		} else if (op < 96U) {
+			zassert_equal(disk_access_ioctl(DISK_NAME,
+							DISK_IOCTL_CTRL_SYNC,
+							NULL),
+				      0, "sync failed");
+		} else {
+			zassert_equal(disk_access_init(DISK_NAME), 0,
+				      "init failed");
+		}
+	}
+
+	zassert_equal(disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL),
+		      0, "sync failed");
+	zassert_equal(disk_access_init(DISK_NAME), 0, "init failed");
+	disk_check_all();
+
+	zassert_equal(disk_access_cache_stats(&stats), 0, "no statistics");
+	zassert_true(stats.hits > 0U, "cache never hit");
+	zassert_true(stats.misses > 0U, "cache never missed");
+	if (IS_ENABLED(CONFIG_DISK_CACHE_WRITE_BACK)) {
+		zassert_true(stats.write_backs > 0U, "nothing written back");
+	} else {
+		zassert_equal(stats.write_backs, 0U, "write through held data");
+	}
+	if (CONFIG_DISK_CACHE_READ_AHEAD > 0) {
+		zassert_true(stats.read_ahead > 0U, "nothing read ahead");
+	} else {
+		zassert_equal(stats.read_ahead, 0U, "read ahead disabled");
+	}
+}
+
+/**
+ * @brief Check that an initialization drops the cached sectors
+ */
+static void test_disk_cache_reinit(void)
+{
+	struct disk_cache_stats before, after;
+
+	disk_write_run(0U, 1U);
+	disk_check_run(0U, 1U);
+	zassert_equal(disk_access_init(DISK_NAME), 0, "init failed");
+
+	zassert_equal(disk_access_cache_stats(&before), 0, "no statistics");
+	disk_check_run(0U, 1U);
+	zassert_equal(disk_access_cache_stats(&after), 0, "no statistics");
+
+	zassert_equal(after.hits, before.hits, "sector kept across init");
+	zassert_equal(after.misses, before.misses + 1U, "sector not read");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(disk_cache,
+			 ztest_unit_test(test_disk_cache_setup),
+			 ztest_unit_test(test_disk_cache_fuzz),
+			 ztest_unit_test(test_disk_cache_reinit)
+			);
+	ztest_run_test_suite(disk_cache);
+}
@@ -20,6 +20,7 @@ void test_main(void)
 			 ztest_unit_test(test_fat_fs),
 			 ztest_unit_test(test_fat_rename),
 			 ztest_unit_test(test_fs_open_flags),
+			 ztest_unit_test(test_fat_cache),
 			 ztest_unit_test(test_fat_unmount),
 			 ztest_unit_test(test_fat_mount_rd_only));
 	ztest_run_test_suite(fat_fs_basic_test);
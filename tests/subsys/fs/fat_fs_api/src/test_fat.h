@@ -30,4 +30,5 @@ void test_fat_file(void);
 void test_fat_dir(void);
 void test_fat_fs(void);
 void test_fat_rename(void);
+void test_fat_cache(void);
 void test_fat_mount_rd_only(void);
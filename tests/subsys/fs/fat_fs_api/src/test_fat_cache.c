@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_fat.h"
+#include <string.h>
+#include <storage/disk_access.h>
+
+#define CACHE_FILE	FATFS_MNTP"/cache.bin"
+#define CHUNK_SIZE	512
+#define CHUNK_COUNT	32
+
+static uint8_t chunk[CHUNK_SIZE];
+
+static void fill_chunk(int n)
+{
+	for (int i = 0; i < CHUNK_SIZE; i++) {
+		chunk[i] = (uint8_t)(n + i);
+	}
+}
+
+void test_fat_cache(void)
+{
+	struct disk_cache_stats before, after;
+	struct fs_file_t fp;
+	uint8_t expected[CHUNK_SIZE];
+	ssize_t brw;
+	int res;
+
+	if (!IS_ENABLED(CONFIG_DISK_CACHE)) {
+		ztest_test_skip();
+		return;
+	}
+
+	fs_file_t_init(&fp);
+	res = fs_open(&fp, CACHE_FILE, FS_O_CREATE | FS_O_RDWR);
+	zassert_equal(res, 0, "Failed to open file [%d]", res);
+
+	zassert_equal(disk_access_cache_stats(&before), 0, "No statistics");
+
+	for (int n = 0; n < CHUNK_COUNT; n++) {
+		fill_chunk(n);
+		brw = fs_write(&fp, chunk, sizeof(chunk));
+		zassert_equal(brw, sizeof(chunk), "Failed to write [%zd]",
+			      brw);
+	}
+
+	res = fs_sync(&fp);
+	zassert_equal(res, 0, "Failed to sync [%d]", res);
+
+	disk_access_cache_stats(&after);
+	zassert_true(after.writes - before.writes >= CHUNK_COUNT,
+		     "Writes not cached");
+	zassert_true(after.write_backs > before.write_backs,
+		     "Nothing written back");
+	zassert_true(after.disk_writes - before.disk_writes <
+		     after.write_backs - before.write_backs,
+		     "Written back sectors not merged");
+
+	/* The first sectors of the file have been evicted by now */
+	res = fs_seek(&fp, 0, FS_SEEK_SET);
+	zassert_equal(res, 0, "Failed to seek [%d]", res);
+
+	before = after;
+	for (int n = 0; n < CHUNK_COUNT; n++) {
+		fill_chunk(n);
+		memcpy(expected, chunk, sizeof(expected));
+		brw = fs_read(&fp, chunk, sizeof(chunk));
+		zassert_equal(brw, sizeof(chunk), "Failed to read [%zd]",
+			      brw);
+		zassert_mem_equal(chunk, expected, sizeof(chunk),
+				  "Chunk %d differs", n);
+	}
+
+	disk_access_cache_stats(&after);
+	TC_PRINT("hits %u misses %u read ahead %u disk reads %u\n",
+		 after.hits - before.hits, after.misses - before.misses,
+		 after.read_ahead - before.read_ahead,
+		 after.disk_reads - before.disk_reads);
+	zassert_true(after.read_ahead > before.read_ahead,
+		     "Nothing read ahead");
+	zassert_true(after.hits > before.hits, "No cache hits");
+	zassert_true(after.disk_reads - before.disk_reads < CHUNK_COUNT,
+		     "Read ahead did not save disk reads");
+
+	res = fs_close(&fp);
+	zassert_equal(res, 0, "Failed to close [%d]", res);
+
+	res = fs_unlink(CACHE_FILE);
+	zassert_equal(res, 0, "Failed to remove file [%d]", res);
+}
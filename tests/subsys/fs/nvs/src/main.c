@@ -706,6 +706,124 @@ void test_nvs_gc_corrupt_ate(void)
 	zassert_true(err == 0,  "nvs_init call failure: %d", err);
 }
 
+/*
+ * Test that the lookup cache finds the same entries as a full walk when
+ * several ids share a cache slot, after the sector holding them has been
+ * garbage collected, and after re-initialization.
+ */
+void test_nvs_cache_collision(void)
+{
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	int err;
+	ssize_t len;
+	uint16_t i, id, data;
+
+	fs.sector_count = 3;
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	/* ids 0, CACHE_SIZE, 2 * CACHE_SIZE and 3 * CACHE_SIZE share a slot */
+	for (i = 0U; i < 4; i++) {
+		id = i * CONFIG_NVS_LOOKUP_CACHE_SIZE;
+		len = nvs_write(&fs, id, &i, sizeof(i));
+		zassert_true(len == sizeof(i), "nvs_write failed: %d", len);
+	}
+
+	/* the newest ate of the slot is a delete */
+	err = nvs_delete(&fs, 3 * CONFIG_NVS_LOOKUP_CACHE_SIZE);
+	zassert_true(err == 0,  "nvs_delete call failure: %d", err);
+
+	/* rewrite another id until every sector went through gc */
+	for (i = 0U; i < (3 * fs.sector_size / sizeof(struct nvs_ate)); i++) {
+		len = nvs_write(&fs, 1, &i, sizeof(i));
+		zassert_true(len == sizeof(i), "nvs_write failed: %d", len);
+	}
+
+	for (int pass = 0; pass < 2; pass++) {
+		for (i = 0U; i < 3; i++) {
+			id = i * CONFIG_NVS_LOOKUP_CACHE_SIZE;
+			len = nvs_read(&fs, id, &data, sizeof(data));
+			zassert_true(len == sizeof(data),
+				     "nvs_read failed: %d", len);
+			zassert_equal(data, i,
+				      "read unexpected data: %d instead of %d",
+				      data, i);
+		}
+
+		len = nvs_read(&fs, 3 * CONFIG_NVS_LOOKUP_CACHE_SIZE, &data,
+			       sizeof(data));
+		zassert_true(len == -ENOENT,
+			     "nvs_read shouldn't found the entry: %d", len);
+
+		/* the second pass uses the cache filled by nvs_init */
+		err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+		zassert_true(err == 0,  "nvs_init call failure: %d", err);
+	}
+#else
+	ztest_test_skip();
+#endif
+}
+
+/*
+ * Measure the worst case latency of nvs_write() while a few ids are
+ * rewritten over many sectors. With CONFIG_NVS_BACKGROUND_GC, no write
+ * should have to erase a sector itself.
+ */
+void test_nvs_gc_write_latency(void)
+{
+	int err;
+	ssize_t len;
+	uint8_t buf[64];
+	uint32_t *flash_erase_stat;
+	uint32_t erase_calls, start, cycles;
+	uint32_t max_cycles = 0U;
+	uint32_t gc_writes = 0U;
+	const uint16_t max_id = 8;
+	const uint16_t max_writes = 200;
+
+	stats_walk(sim_stats, flash_sim_erase_calls_find, &flash_erase_stat);
+
+	fs.sector_count = 3;
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	for (uint16_t i = 0; i < max_writes; i++) {
+		memset(buf, (uint8_t)i, sizeof(buf));
+
+		erase_calls = *flash_erase_stat;
+		start = k_cycle_get_32();
+		len = nvs_write(&fs, i % max_id, buf, sizeof(buf));
+		cycles = k_cycle_get_32() - start;
+		zassert_true(len == sizeof(buf), "nvs_write failed: %d", len);
+
+		max_cycles = MAX(max_cycles, cycles);
+		if (*flash_erase_stat != erase_calls) {
+			gc_writes++;
+		}
+
+		/* give the background gc a chance to run */
+		k_msleep(1);
+	}
+
+	TC_PRINT("worst case write latency %u cycles, %u of %u writes "
+		 "erased a sector\n", max_cycles, gc_writes, max_writes);
+
+	if (IS_ENABLED(CONFIG_NVS_BACKGROUND_GC)) {
+		zassert_equal(gc_writes, 0, "writes waited for gc");
+	} else {
+		zassert_true(gc_writes > 0, "no write went through gc");
+	}
+
+	for (uint16_t id = 0; id < max_id; id++) {
+		len = nvs_read(&fs, id, buf, sizeof(buf));
+		zassert_true(len == sizeof(buf), "nvs_read failed: %d", len);
+		zassert_equal(buf[0], (uint8_t)(max_writes - max_id + id),
+			      "read unexpected data: %d", buf[0]);
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_nvs,
@@ -729,7 +847,11 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 				 test_nvs_gc_corrupt_close_ate, setup, teardown),
 			 ztest_unit_test_setup_teardown(
-				 test_nvs_gc_corrupt_ate, setup, teardown)
+				 test_nvs_gc_corrupt_ate, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_cache_collision, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_gc_write_latency, setup, teardown)
 			);
 
 	ztest_run_test_suite(test_nvs);
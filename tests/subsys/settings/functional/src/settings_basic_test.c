@@ -19,6 +19,9 @@ LOG_MODULE_REGISTER(settings_basic_test);
 #if defined(CONFIG_SETTINGS_FCB) || defined(CONFIG_SETTINGS_NVS)
 #include <storage/flash_map.h>
 #endif
+#if defined(CONFIG_SETTINGS_NVS)
+#include <settings/settings_nvs.h>
+#endif
 #if IS_ENABLED(CONFIG_SETTINGS_FS)
 #include <fs/fs.h>
 #include <fs/littlefs.h>
@@ -606,6 +609,308 @@ static void test_direct_loading_filter(void)
 	}
 }
 
+static unsigned int batch_called;
+
+static int batch_loader(const char *key, size_t len, settings_read_cb read_cb,
+			void *cb_arg, void *param)
+{
+	const struct settings_batch_item *items = param;
+	const char *next;
+	char buf[16];
+	int rc;
+
+	for (int i = 0; i < 3; i++) {
+		if (settings_name_steq(key, items[i].name + strlen("batch/"),
+				       &next) && !next) {
+			zassert_equal(items[i].val_len, len, NULL);
+			rc = read_cb(cb_arg, buf, len);
+			zassert_equal(len, rc, NULL);
+			zassert_mem_equal(items[i].value, buf, len, NULL);
+			batch_called |= BIT(i);
+			return 0;
+		}
+	}
+
+	zassert_unreachable("Unexpected data name: %s", key);
+	return 0;
+}
+
+/*
+ * Test that a batch of saves stores and deletes the same items as
+ * separate calls to settings_save_one().
+ */
+static void test_save_batch(void)
+{
+	int rc;
+	static const struct settings_batch_item items[] = {
+		{ .name = "batch/a", .value = "1", .val_len = 2 },
+		{ .name = "batch/b", .value = "22", .val_len = 3 },
+		{ .name = "batch/c", .value = "333", .val_len = 4 },
+		{ .name = "batch/d", .value = "4444", .val_len = 5 },
+	};
+	static const struct settings_batch_item updates[] = {
+		{ .name = "batch/d", .value = NULL, .val_len = 0 },
+		{ .name = "batch/b", .value = "55", .val_len = 3 },
+		{ .name = "batch/e", .value = NULL, .val_len = 0 },
+	};
+	static const struct settings_batch_item result[] = {
+		{ .name = "batch/a", .value = "1", .val_len = 2 },
+		{ .name = "batch/b", .value = "55", .val_len = 3 },
+		{ .name = "batch/c", .value = "333", .val_len = 4 },
+	};
+
+	rc = settings_save_batch(items, ARRAY_SIZE(items));
+	zassert_equal(0, rc, NULL);
+
+	rc = settings_save_batch(updates, ARRAY_SIZE(updates));
+	zassert_equal(0, rc, NULL);
+
+	batch_called = 0U;
+	rc = settings_load_subtree_direct("batch", batch_loader,
+					  (void *)result);
+	zassert_equal(0, rc, NULL);
+	zassert_equal(BIT_MASK(ARRAY_SIZE(result)), batch_called, NULL);
+
+	/* the deleted item stays deleted after another single save */
+	rc = settings_save_one("batch/a", "6", 2);
+	zassert_equal(0, rc, NULL);
+	rc = settings_delete("batch/a");
+	zassert_equal(0, rc, NULL);
+
+	batch_called = 0U;
+	rc = settings_load_subtree_direct("batch", batch_loader,
+					  (void *)result);
+	zassert_equal(0, rc, NULL);
+	zassert_equal(BIT(1) | BIT(2), batch_called, NULL);
+}
+
+extern struct settings_store *settings_save_dst;
+
+#if defined(CONFIG_SETTINGS_NVS)
+static int cut_loader(const char *key, size_t len, settings_read_cb read_cb,
+		      void *cb_arg, void *param)
+{
+	uint32_t *called = param;
+	uint8_t val;
+	int rc;
+
+	zassert_equal(sizeof(val), len, NULL);
+	rc = read_cb(cb_arg, &val, len);
+	zassert_equal(len, rc, NULL);
+	*called |= BIT(val);
+
+	return 0;
+}
+#endif
+
+/*
+ * Test that the names written by a batch that never ends, as after a
+ * power loss, are found once the NVS backend is initialized again.
+ */
+static void test_save_batch_cut(void)
+{
+#if defined(CONFIG_SETTINGS_NVS)
+	struct settings_store *cs = settings_save_dst;
+	char name[SETTINGS_MAX_NAME_LEN];
+	uint32_t called;
+	uint8_t i;
+	int rc;
+
+	rc = cs->cs_itf->csi_save_start(cs);
+	zassert_equal(0, rc, NULL);
+
+	for (i = 0U; i < 20U; i++) {
+		snprintk(name, sizeof(name), "cut/%u", i);
+		rc = cs->cs_itf->csi_save(cs, name, (const char *)&i,
+					  sizeof(i));
+		zassert_equal(0, rc, NULL);
+	}
+
+	/* no csi_save_end() */
+	rc = settings_nvs_backend_init((struct settings_nvs *)cs);
+	zassert_equal(0, rc, NULL);
+
+	called = 0U;
+	rc = settings_load_subtree_direct("cut", cut_loader, &called);
+	zassert_equal(0, rc, NULL);
+	zassert_equal(BIT_MASK(20), called, "names lost: 0x%08x", called);
+
+	for (i = 0U; i < 20U; i++) {
+		snprintk(name, sizeof(name), "cut/%u", i);
+		rc = cs->cs_itf->csi_save(cs, name, NULL, 0);
+		zassert_equal(0, rc, NULL);
+	}
+#else
+	ztest_test_skip();
+#endif
+}
+
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+static int wb_loader(const char *key, size_t len, settings_read_cb read_cb,
+		     void *cb_arg, void *param)
+{
+	int rc;
+
+	zassert_equal(sizeof(uint32_t), len, NULL);
+	rc = read_cb(cb_arg, param, len);
+	zassert_equal(len, rc, NULL);
+
+	return 0;
+}
+
+/* Store in front of the real one that fails the next wb_fail_count saves */
+static struct settings_store *wb_real_dst;
+static int wb_fail_count;
+
+static int wb_fail_save_start(struct settings_store *cs)
+{
+	ARG_UNUSED(cs);
+
+	if (!wb_real_dst->cs_itf->csi_save_start) {
+		return 0;
+	}
+
+	return wb_real_dst->cs_itf->csi_save_start(wb_real_dst);
+}
+
+static int wb_fail_save(struct settings_store *cs, const char *name,
+			const char *value, size_t val_len)
+{
+	ARG_UNUSED(cs);
+
+	if (wb_fail_count > 0) {
+		wb_fail_count--;
+		return -EIO;
+	}
+
+	return wb_real_dst->cs_itf->csi_save(wb_real_dst, name, value,
+					      val_len);
+}
+
+static int wb_fail_save_end(struct settings_store *cs)
+{
+	ARG_UNUSED(cs);
+
+	if (!wb_real_dst->cs_itf->csi_save_end) {
+		return 0;
+	}
+
+	return wb_real_dst->cs_itf->csi_save_end(wb_real_dst);
+}
+
+static const struct settings_store_itf wb_fail_itf = {
+	.csi_save_start = wb_fail_save_start,
+	.csi_save = wb_fail_save,
+	.csi_save_end = wb_fail_save_end,
+};
+
+static struct settings_store wb_fail_store = {
+	.cs_itf = &wb_fail_itf,
+};
+#endif
+
+/*
+ * Test that repeated saves of a key are held back in RAM and written
+ * once by settings_flush().
+ */
+static void test_write_back(void)
+{
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+	struct settings_write_back_stats before, after;
+	uint32_t val;
+	int rc;
+
+	rc = settings_write_back_stats_get(&before);
+	zassert_equal(0, rc, NULL);
+
+	for (val = 0U; val < 10; val++) {
+		rc = settings_save_one("wb/counter", &val, sizeof(val));
+		zassert_equal(0, rc, NULL);
+	}
+
+	rc = settings_write_back_stats_get(&after);
+	zassert_equal(0, rc, NULL);
+	zassert_equal(10, after.saves - before.saves, NULL);
+	zassert_equal(9, after.coalesced - before.coalesced, NULL);
+	zassert_equal(before.written, after.written,
+		      "values written before the delay");
+
+	rc = settings_flush();
+	zassert_equal(0, rc, NULL);
+
+	rc = settings_write_back_stats_get(&after);
+	zassert_equal(0, rc, NULL);
+	zassert_equal(1, after.written - before.written, NULL);
+	zassert_equal(1, after.batches - before.batches, NULL);
+	zassert_equal(0, after.errors - before.errors, NULL);
+
+	val = 0U;
+	rc = settings_load_subtree_direct("wb", wb_loader, &val);
+	zassert_equal(0, rc, NULL);
+	zassert_equal(9, val, NULL);
+#else
+	ztest_test_skip();
+#endif
+}
+
+/*
+ * Test that a value the backend fails to write stays pending and is
+ * written by the next flush.
+ */
+static void test_write_back_retry(void)
+{
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+	struct settings_write_back_stats before, after;
+	uint32_t val;
+	int rc;
+
+	val = 1U;
+	rc = settings_save_one("wbr/a", &val, sizeof(val));
+	zassert_equal(0, rc, NULL);
+
+	val = 2U;
+	rc = settings_save_one("wbr/b", &val, sizeof(val));
+	zassert_equal(0, rc, NULL);
+
+	rc = settings_write_back_stats_get(&before);
+	zassert_equal(0, rc, NULL);
+
+	wb_real_dst = settings_save_dst;
+	settings_dst_register(&wb_fail_store);
+	wb_fail_count = 1;
+
+	rc = settings_flush();
+	zassert_equal(-EIO, rc, "flush did not report the failure");
+
+	rc = settings_write_back_stats_get(&after);
+	zassert_equal(0, rc, NULL);
+	zassert_equal(1, after.written - before.written, NULL);
+	zassert_equal(1, after.errors - before.errors, NULL);
+
+	/* only the value that failed is written again */
+	rc = settings_flush();
+	zassert_equal(0, rc, NULL);
+
+	rc = settings_write_back_stats_get(&after);
+	zassert_equal(0, rc, NULL);
+	zassert_equal(2, after.written - before.written, NULL);
+	zassert_equal(1, after.errors - before.errors, NULL);
+
+	settings_dst_register(wb_real_dst);
+
+	val = 0U;
+	rc = settings_load_subtree_direct("wbr/a", wb_loader, &val);
+	zassert_equal(0, rc, NULL);
+	zassert_equal(1, val, NULL);
+
+	val = 0U;
+	rc = settings_load_subtree_direct("wbr/b", wb_loader, &val);
+	zassert_equal(0, rc, NULL);
+	zassert_equal(2, val, NULL);
+#else
+	ztest_test_skip();
+#endif
+}
 
 void test_main(void)
 {
@@ -614,7 +919,11 @@ void test_main(void)
 			 ztest_unit_test(test_support_rtn),
 			 ztest_unit_test(test_register_and_loading),
 			 ztest_unit_test(test_direct_loading),
-			 ztest_unit_test(test_direct_loading_filter)
+			 ztest_unit_test(test_direct_loading_filter),
+			 ztest_unit_test(test_save_batch),
+			 ztest_unit_test(test_save_batch_cut),
+			 ztest_unit_test(test_write_back),
+			 ztest_unit_test(test_write_back_retry)
 			);
 
 	ztest_run_test_suite(settings_test_suite);